@@ -0,0 +1,254 @@
+const fs = require('fs')
+const os = require('os')
+const path = require('path')
+const G = require('./geometries')
+
+/**
+ * Benchmark cases: one or more per Geometry method and GEOS function.
+ * target: 'GEOS' | 'Geometry' - entry point, used for coverage check
+ * sized: run once per vertex count, setup(n) receives vertex count
+ * async: run() returns a promise
+ */
+module.exports = GEOS => {
+  const geometry = n => GEOS.readWKT(G.polygonWKT(n))
+  const polygons = n => ({ a: geometry(n), b: GEOS.readWKT(G.polygonWKT(n, 50, 0)) })
+  const line = n => GEOS.readWKT(G.lineStringWKT(n))
+  const point = () => GEOS.createPoint(10, 10)
+  const identity = [1, 0, 0, 1, 0, 0]
+
+  const cases = [
+    // Entry point overhead baseline (see index.js):
+    { target: 'Geometry', name: 'getSRID', setup: () => ({ g: point() }), run: c => c.g.getSRID() },
+    { target: 'Geometry', name: 'setSRID', setup: () => ({ g: point() }), run: c => c.g.setSRID(4326) },
+    { target: 'Geometry', name: 'dispose', run: () => GEOS.createPoint(0, 0).dispose() },
+
+    { target: 'Geometry', name: 'getType', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.getType() },
+    { target: 'Geometry', name: 'getNumPoints', sized: true, setup: n => ({ g: line(n) }), run: c => c.g.getNumPoints() },
+    { target: 'Geometry', name: 'getPointN', sized: true, setup: n => ({ g: line(n) }), run: c => c.g.getPointN(1) },
+    { target: 'Geometry', name: 'getStartPoint', sized: true, setup: n => ({ g: line(n) }), run: c => c.g.getStartPoint() },
+    { target: 'Geometry', name: 'getEndPoint', sized: true, setup: n => ({ g: line(n) }), run: c => c.g.getEndPoint() },
+    { target: 'Geometry', name: 'getX', setup: () => ({ g: point() }), run: c => c.g.getX() },
+    { target: 'Geometry', name: 'getY', setup: () => ({ g: point() }), run: c => c.g.getY() },
+    { target: 'Geometry', name: 'getNumGeometries', sized: true, setup: n => ({ g: GEOS.readWKT(G.multiPointWKT(n)) }), run: c => c.g.getNumGeometries() },
+    { target: 'Geometry', name: 'getGeometryN', sized: true, setup: n => ({ g: GEOS.readWKT(G.multiPointWKT(n)) }), run: c => c.g.getGeometryN(1) },
+    { target: 'Geometry', name: 'forEachGeometry', sized: true, setup: n => ({ g: GEOS.readWKT(G.multiPointWKT(n)) }), run: c => c.g.forEachGeometry(part => part.getX()) },
+    { target: 'Geometry', name: 'getCoordinates', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.getCoordinates() },
+    // Cached after first call:
+    { target: 'Geometry', name: 'getEnvelope', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.getEnvelope() },
+
+    { target: 'Geometry', name: 'difference', sized: true, setup: polygons, run: c => c.a.difference(c.b) },
+    { target: 'Geometry', name: 'union', sized: true, setup: polygons, run: c => c.a.union(c.b) },
+    { target: 'Geometry', name: 'intersection', sized: true, setup: polygons, run: c => c.a.intersection(c.b) },
+    { target: 'Geometry', name: 'convexHull', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.convexHull() },
+    { target: 'Geometry', name: 'buffer', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.buffer(10) },
+    { target: 'Geometry', name: 'asPolygon', sized: true, setup: n => ({ g: geometry(n).asBoundary() }), run: c => c.g.asPolygon() },
+    { target: 'Geometry', name: 'asBoundary', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.asBoundary() },
+    { target: 'Geometry', name: 'asValid', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.asValid() },
+    { target: 'Geometry', name: 'interpolate', sized: true, setup: n => ({ g: line(n) }), run: c => c.g.interpolate(10) },
+    { target: 'Geometry', name: 'interpolateNormalized', sized: true, setup: n => ({ g: line(n) }), run: c => c.g.interpolateNormalized(0.5) },
+    { target: 'Geometry', name: 'simplify', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.simplify(1) },
+    { target: 'Geometry', name: 'topologyPreservingSimplify', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.topologyPreservingSimplify(1) },
+    { target: 'Geometry', name: 'transform', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.transform((x, y) => [x + 1, y + 1]) },
+    {
+      target: 'Geometry',
+      name: 'transformBatch',
+      sized: true,
+      setup: n => ({ g: geometry(n) }),
+      run: c => c.g.transformBatch((coords, dims) => {
+        for (let i = 0; i < coords.length; i += dims) coords[i] += 1
+      })
+    },
+    { target: 'Geometry', name: 'affine', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.affine(identity) },
+    { target: 'Geometry', name: 'translate', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.translate(1, 1) },
+    { target: 'Geometry', name: 'scale', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.scale(2, 2) },
+    { target: 'Geometry', name: 'rotate', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.rotate(Math.PI / 4) },
+    { target: 'Geometry', name: 'prepare', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.prepare() },
+    { target: 'Geometry', name: 'toShared', sized: true, setup: n => ({ g: geometry(n) }), run: c => c.g.toShared() },
+    { target: 'Geometry', name: 'distance', sized: true, setup: polygons, run: c => c.a.distance(c.b) },
+    { target: 'Geometry', name: 'hausdorffDistance', sized: true, setup: polygons, run: c => c.a.hausdorffDistance(c.b) },
+    { target: 'Geometry', name: 'nearestPoints', sized: true, setup: polygons, run: c => c.a.nearestPoints(c.b) },
+    { target: 'Geometry', name: 'isWithinDistance', sized: true, setup: polygons, run: c => c.a.isWithinDistance(c.b, 1) },
+    {
+      target: 'Geometry',
+      name: 'distanceMany',
+      sized: true,
+      setup: n => ({ g: geometry(n), gs: Array.from({ length: 100 }, (_, i) => GEOS.createPoint(i * 5, 200)) }),
+      run: c => c.g.distanceMany(c.gs)
+    },
+
+    { target: 'Geometry', name: 'differenceAsync', sized: true, async: true, setup: polygons, run: c => c.a.differenceAsync(c.b) },
+    { target: 'Geometry', name: 'unionAsync', sized: true, async: true, setup: polygons, run: c => c.a.unionAsync(c.b) },
+    { target: 'Geometry', name: 'intersectionAsync', sized: true, async: true, setup: polygons, run: c => c.a.intersectionAsync(c.b) },
+    { target: 'Geometry', name: 'convexHullAsync', sized: true, async: true, setup: n => ({ g: geometry(n) }), run: c => c.g.convexHullAsync() },
+    { target: 'Geometry', name: 'bufferAsync', sized: true, async: true, setup: n => ({ g: geometry(n) }), run: c => c.g.bufferAsync(10) },
+    { target: 'Geometry', name: 'asValidAsync', sized: true, async: true, setup: n => ({ g: geometry(n) }), run: c => c.g.asValidAsync() },
+
+    ...['isValid', 'isEmpty', 'isSimple', 'isRing', 'hasZ', 'isClosed'].map(name => ({
+      target: 'Geometry',
+      name,
+      sized: true,
+      setup: n => ({ g: line(n) }),
+      run: c => c.g[name]()
+    })),
+
+    ...['disjoint', 'touches', 'intersects', 'crosses', 'within', 'contains', 'overlaps', 'equals', 'covers', 'coveredBy'].map(name => ({
+      target: 'Geometry',
+      name,
+      sized: true,
+      setup: polygons,
+      run: c => c.a[name](c.b)
+    })),
+
+    { target: 'GEOS', name: 'readWKT', sized: true, setup: n => ({ wkt: G.polygonWKT(n) }), run: c => GEOS.readWKT(c.wkt) },
+    { target: 'GEOS', name: 'writeWKT', sized: true, setup: n => ({ g: geometry(n) }), run: c => GEOS.writeWKT(c.g) },
+    { target: 'GEOS', name: 'readWKB', sized: true, setup: n => ({ wkb: GEOS.writeWKB(geometry(n)) }), run: c => GEOS.readWKB(c.wkb) },
+    { target: 'GEOS', name: 'readHexWKB', sized: true, setup: n => ({ hex: GEOS.writeWKB(geometry(n)).toString('hex') }), run: c => GEOS.readHexWKB(c.hex) },
+    { target: 'GEOS', name: 'writeWKB', sized: true, setup: n => ({ g: geometry(n) }), run: c => GEOS.writeWKB(c.g) },
+    { target: 'GEOS', name: 'readGeoJSON', sized: true, setup: n => ({ json: G.polygonGeoJSON(n) }), run: c => GEOS.readGeoJSON(c.json) },
+    { target: 'GEOS', name: 'writeGeoJSON', sized: true, setup: n => ({ g: geometry(n) }), run: c => GEOS.writeGeoJSON(c.g) },
+    {
+      target: 'GEOS',
+      name: 'toColumnar',
+      sized: true,
+      setup: n => ({ gs: Array.from({ length: n }, (_, i) => GEOS.readWKT(G.polygonWKT(10, i * 10, 0, 8))) }),
+      run: c => GEOS.toColumnar(c.gs)
+    },
+    {
+      target: 'GEOS',
+      name: 'fromColumnar',
+      sized: true,
+      setup: n => ({ columns: GEOS.toColumnar(Array.from({ length: n }, (_, i) => GEOS.readWKT(G.polygonWKT(10, i * 10, 0, 8)))) }),
+      run: c => GEOS.fromColumnar(c.columns)
+    },
+    { target: 'GEOS', name: 'fromShared', sized: true, setup: n => ({ buffer: geometry(n).toShared() }), run: c => GEOS.fromShared(c.buffer) },
+    { target: 'GEOS', name: 'createLineString', sized: true, setup: n => ({ coords: G.flatCoords(G.ring(n).slice(0, -1)) }), run: c => GEOS.createLineString(c.coords) },
+    { target: 'GEOS', name: 'createPoint', run: () => GEOS.createPoint(10, 10) },
+    { target: 'GEOS', name: 'createPolygon', sized: true, setup: n => ({ coords: G.flatCoords(G.ring(n)) }), run: c => GEOS.createPolygon(c.coords) },
+    {
+      target: 'GEOS',
+      name: 'createMultiLineString',
+      sized: true,
+      setup: n => ({ coords: G.flatCoords(G.ring(n)), offsets: new Uint32Array([0, n]) }),
+      run: c => GEOS.createMultiLineString(c.coords, c.offsets)
+    },
+    {
+      target: 'GEOS',
+      name: 'createMultiPolygon',
+      sized: true,
+      setup: n => ({ coords: G.flatCoords(G.ring(n)), rings: new Uint32Array([0, n]), parts: new Uint32Array([0, 1]) }),
+      run: c => GEOS.createMultiPolygon(c.coords, c.rings, c.parts)
+    },
+    { target: 'GEOS', name: 'createCollection', sized: true, setup: n => ({ gs: [geometry(n), line(n)] }), run: c => GEOS.createCollection(c.gs) },
+    {
+      target: 'GEOS',
+      name: 'createSpatialIndex',
+      sized: true,
+      setup: n => ({ gs: Array.from({ length: n }, (_, i) => GEOS.createPoint(i, i)) }),
+      run: c => GEOS.createSpatialIndex(c.gs)
+    },
+    {
+      target: 'GEOS',
+      name: 'createReader',
+      sized: true,
+      async: true,
+      setup: n => {
+        // n geometries of 10 vertices each:
+        const file = path.join(os.tmpdir(), `geosjs-bench-${process.pid}-${n}.wkt`)
+        fs.writeFileSync(file, Array.from({ length: n }, () => G.polygonWKT(10)).join('\n'))
+        return { file }
+      },
+      run: async c => {
+        for await (const batch of GEOS.createReader(c.file)) void batch
+      },
+      teardown: c => fs.unlinkSync(c.file)
+    },
+    {
+      target: 'GEOS',
+      name: 'writeDataset',
+      sized: true,
+      setup: n => ({
+        file: path.join(os.tmpdir(), `geosjs-bench-${process.pid}-${n}.dataset`),
+        gs: Array.from({ length: n }, (_, i) => GEOS.readWKT(G.polygonWKT(10, i * 10, 0, 8)))
+      }),
+      run: c => GEOS.writeDataset(c.file, c.gs),
+      teardown: c => fs.unlinkSync(c.file)
+    },
+    {
+      target: 'GEOS',
+      name: 'openDataset',
+      sized: true,
+      setup: n => {
+        const file = path.join(os.tmpdir(), `geosjs-bench-${process.pid}-${n}.dataset`)
+        GEOS.writeDataset(file, Array.from({ length: n }, (_, i) => GEOS.readWKT(G.polygonWKT(10, i * 10, 0, 8))))
+        return { file }
+      },
+      // Open, query and decode a handful of items:
+      run: c => {
+        const dataset = GEOS.openDataset(c.file)
+        dataset.query(new Float64Array([0, -10, 50, 10])).forEach(i => dataset.get(i))
+        dataset.close()
+      },
+      teardown: c => fs.unlinkSync(c.file)
+    },
+    {
+      target: 'GEOS',
+      name: 'unionAll',
+      sized: true,
+      async: true,
+      setup: n => ({ gs: Array.from({ length: n }, (_, i) => GEOS.readWKT(G.polygonWKT(10, i * 10, 0, 8))) }),
+      run: c => GEOS.unionAll(c.gs)
+    },
+    {
+      target: 'GEOS',
+      name: 'join',
+      sized: true,
+      async: true,
+      setup: n => ({
+        polygons: Array.from({ length: n }, (_, i) => GEOS.readWKT(G.polygonWKT(10, i * 10, 0, 8))),
+        points: Array.from({ length: n * 10 }, (_, i) => GEOS.createPoint(i, (i % 7) - 3))
+      }),
+      run: c => GEOS.join(c.polygons, c.points, { predicate: 'contains' })
+    },
+    {
+      target: 'GEOS',
+      name: 'buildLOD',
+      sized: true,
+      async: true,
+      setup: n => ({ gs: Array.from({ length: 100 }, (_, i) => GEOS.readWKT(G.polygonWKT(n, i * 10, 0, 8))) }),
+      run: c => GEOS.buildLOD(c.gs, [0.1, 0.5, 1, 2, 4])
+    },
+    // Statistics are left disabled for other cases:
+    { target: 'GEOS', name: 'enableStats', run: () => GEOS.enableStats(false) },
+    {
+      target: 'GEOS',
+      name: 'stats',
+      setup: () => {
+        GEOS.enableStats()
+        GEOS.createPoint(0, 0).buffer(1).isValid()
+        GEOS.enableStats(false)
+        return {}
+      },
+      run: () => GEOS.stats()
+    },
+    { target: 'GEOS', name: 'resetStats', run: () => GEOS.resetStats() },
+    {
+      target: 'GEOS',
+      name: 'scope',
+      sized: true,
+      setup: n => ({ g: geometry(n) }),
+      run: c => GEOS.scope(() => c.g.buffer(1).intersects(c.g))
+    },
+    {
+      target: 'GEOS',
+      name: 'pipeline',
+      sized: true,
+      setup: n => {
+        const { a, b } = polygons(n)
+        return { a, pipeline: GEOS.pipeline().buffer(10).union(b).convexHull().intersects(b).build() }
+      },
+      run: c => c.pipeline.apply(c.a)
+    }
+  ]
+
+  return cases
+}
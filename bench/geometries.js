@@ -0,0 +1,34 @@
+/**
+ * Synthetic geometries with given number of vertices.
+ */
+
+const ring = (n, cx = 0, cy = 0, r = 100) => {
+  const coords = []
+  for (let i = 0; i < n - 1; i++) {
+    const angle = 2 * Math.PI * i / (n - 1)
+    // Slightly jagged circle, so that operations are not trivially simple:
+    const radius = r * (i % 2 ? 0.9 : 1)
+    coords.push([cx + radius * Math.cos(angle), cy + radius * Math.sin(angle)])
+  }
+  coords.push(coords[0])
+  return coords
+}
+
+const wktCoords = coords => coords.map(([x, y]) => `${x} ${y}`).join(', ')
+
+const polygonWKT = (n, cx, cy, r) => `POLYGON ((${wktCoords(ring(Math.max(n, 4), cx, cy, r))}))`
+const lineStringWKT = (n, cx, cy, r) => `LINESTRING (${wktCoords(ring(Math.max(n, 3), cx, cy, r).slice(0, -1))})`
+const multiPointWKT = (n, cx, cy, r) => `MULTIPOINT (${wktCoords(ring(Math.max(n, 2), cx, cy, r).slice(0, -1))})`
+
+const polygonGeoJSON = (n, cx, cy, r) => ({ type: 'Polygon', coordinates: [ring(Math.max(n, 4), cx, cy, r)] })
+
+const flatCoords = coords => Float64Array.from([].concat(...coords))
+
+module.exports = {
+  ring,
+  polygonWKT,
+  lineStringWKT,
+  multiPointWKT,
+  polygonGeoJSON,
+  flatCoords
+}
@@ -0,0 +1,193 @@
+#!/usr/bin/env node
+
+/**
+ * Benchmark harness for all Geometry methods and GEOS functions.
+ *
+ *   npm run bench [-- options]
+ *
+ *   --filter <regexp>    run matching cases only
+ *   --sizes <n,n,...>    vertex counts for sized cases (default: 10,100,1000)
+ *   --time <ms>          measuring time per case (default: 500)
+ *   --output <file>      write JSON results to file (default: stdout)
+ *   --save-baseline      store results as baseline (bench/baseline.json)
+ *   --compare            compare results against baseline; exit code 1 on regression
+ *   --threshold <ratio>  tolerated slow-down for --compare (default: 0.1, i.e. 10%)
+ *
+ * Per case, ops/sec and latency percentiles (µs) are reported.
+ * 'native' is the mean time spent in GEOS and binding code, taken from
+ * GEOS.stats() in a separate run with statistics enabled; 'marshalling'
+ * is the remaining median latency (N-API calls, argument conversion).
+ * 'overhead' is the median latency of a trivial native method
+ * (Geometry::getSRID), measured before all cases.
+ */
+
+const fs = require('fs')
+const path = require('path')
+const GEOS = require('..')
+const cases = require('./cases')(GEOS)
+
+const BASELINE = path.join(__dirname, 'baseline.json')
+
+const options = (argv => {
+  const options = { sizes: [10, 100, 1000], time: 500, threshold: 0.1 }
+  for (let i = 0; i < argv.length; i++) {
+    switch (argv[i]) {
+      case '--filter': options.filter = new RegExp(argv[++i]); break
+      case '--sizes': options.sizes = argv[++i].split(',').map(Number); break
+      case '--time': options.time = Number(argv[++i]); break
+      case '--output': options.output = argv[++i]; break
+      case '--save-baseline': options.saveBaseline = true; break
+      case '--compare': options.compare = true; break
+      case '--threshold': options.threshold = Number(argv[++i]); break
+      default: throw new Error(`Unknown option: ${argv[i]}`)
+    }
+  }
+  return options
+})(process.argv.slice(2))
+
+const now = () => process.hrtime.bigint()
+const percentile = (sorted, p) => sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * p))]
+
+/**
+ * Measure case for given time. Fast operations are timed in batches
+ * (sample >= ~20µs) to keep timer resolution out of the results.
+ */
+const measure = async (testCase, context) => {
+  const run = () => testCase.run(context)
+  const budget = BigInt(options.time) * 1000000n
+
+  // Warm-up and batch size calibration:
+  let batch = 1
+  for (;;) {
+    const start = now()
+    for (let i = 0; i < batch; i++) testCase.async ? await run() : run()
+    if (now() - start > 20000n || batch >= 1 << 16) break
+    batch *= 2
+  }
+
+  const samples = []
+  let count = 0
+  const begin = now()
+  while (now() - begin < budget || samples.length < 5) {
+    const start = now()
+    for (let i = 0; i < batch; i++) testCase.async ? await run() : run()
+    samples.push(Number(now() - start) / batch / 1000)
+    count += batch
+  }
+
+  const elapsed = Number(now() - begin) / 1e9
+  samples.sort((a, b) => a - b)
+
+  return {
+    ops: count / elapsed,
+    mean: samples.reduce((a, b) => a + b, 0) / samples.length,
+    p50: percentile(samples, 0.5),
+    p95: percentile(samples, 0.95),
+    p99: percentile(samples, 0.99),
+    samples: samples.length
+  }
+}
+
+/**
+ * Mean native time per call (µs) of outermost recorded operation;
+ * statistics are enabled for this run only.
+ */
+const measureNative = async (testCase, context, iterations) => {
+  const run = () => testCase.run(context)
+  GEOS.resetStats()
+  GEOS.enableStats()
+
+  try {
+    for (let i = 0; i < iterations; i++) testCase.async ? await run() : run()
+  } finally {
+    GEOS.enableStats(false)
+  }
+
+  const totals = Object.values(GEOS.stats().operations).map(op => op.totalTime)
+  GEOS.resetStats()
+  return totals.length ? Math.max(...totals) * 1000 / iterations : 0
+}
+
+// Cases which change statistics state themselves:
+const statsCase = testCase => testCase.target === 'GEOS' && ['enableStats', 'stats', 'resetStats'].includes(testCase.name)
+
+const coverage = () => {
+  const covered = name => target => cases.some(c => c.name === name && c.target === target)
+  const prototype = Object.getPrototypeOf(GEOS.createPoint(0, 0))
+  return [
+    ...Object.keys(GEOS).filter(name => typeof GEOS[name] === 'function' && !covered(name)('GEOS')).map(name => `GEOS.${name}`),
+    ...Object.getOwnPropertyNames(prototype).filter(name => name !== 'constructor' && !covered(name)('Geometry')).map(name => `Geometry::${name}`)
+  ]
+}
+
+const compare = (results, baseline) => {
+  const previous = baseline.results.reduce((acc, r) => Object.assign(acc, { [r.id]: r }), {})
+  const regressions = results
+    .filter(r => previous[r.id])
+    .map(r => ({ id: r.id, ratio: r.p50 / previous[r.id].p50 }))
+    .filter(({ ratio }) => ratio > 1 + options.threshold)
+
+  regressions.forEach(({ id, ratio }) => {
+    console.error(`REGRESSION ${id}: median latency ${((ratio - 1) * 100).toFixed(1)}% above baseline`)
+  })
+
+  return regressions
+}
+
+const main = async () => {
+  const missing = coverage()
+  if (missing.length) console.error(`Not covered: ${missing.join(', ')}`)
+
+  const results = []
+
+  // Entry point overhead, independent of --filter:
+  const overheadCase = cases.find(c => c.target === 'Geometry' && c.name === 'getSRID')
+  const overhead = (await measure(overheadCase, overheadCase.setup(1))).p50
+
+  for (const testCase of cases) {
+    for (const size of testCase.sized ? options.sizes : [1]) {
+      const id = testCase.sized ? `${testCase.target}.${testCase.name}/${size}` : `${testCase.target}.${testCase.name}`
+      if (options.filter && !options.filter.test(id)) continue
+
+      const context = testCase.setup ? testCase.setup(size) : {}
+      const result = await measure(testCase, context)
+
+      if (!statsCase(testCase)) {
+        // About a tenth of the measuring time:
+        const iterations = Math.max(5, Math.min(10000, Math.floor(options.time * 100 / Math.max(result.p50, 0.01))))
+        result.native = await measureNative(testCase, context, iterations)
+        result.marshalling = Math.max(0, result.p50 - result.native)
+      }
+
+      if (testCase.teardown) testCase.teardown(context)
+      results.push(Object.assign({ id, name: testCase.name, size }, result))
+      console.error(`${id.padEnd(40)} ${result.ops.toFixed(0).padStart(10)} ops/s  p50 ${result.p50.toFixed(2)}µs  p99 ${result.p99.toFixed(2)}µs`)
+    }
+  }
+
+  const report = {
+    version: GEOS.GEOS_VERSION,
+    node: process.version,
+    platform: `${process.platform}-${process.arch}`,
+    date: new Date().toISOString(),
+    overhead,
+    results
+  }
+
+  const json = JSON.stringify(report, null, 2)
+  if (options.output) fs.writeFileSync(options.output, json)
+  else console.log(json)
+
+  if (options.saveBaseline) fs.writeFileSync(BASELINE, json)
+
+  if (options.compare) {
+    if (!fs.existsSync(BASELINE)) throw new Error(`No baseline: ${BASELINE}`)
+    const regressions = compare(results, JSON.parse(fs.readFileSync(BASELINE, 'utf8')))
+    if (regressions.length) process.exitCode = 1
+  }
+}
+
+main().catch(err => {
+  console.error(err)
+  process.exitCode = 1
+})
@@ -7,10 +7,26 @@
       "xcode_settings": {
         "GCC_ENABLE_CPP_EXCEPTIONS": "YES"
       },
+      "defines": [ "NAPI_VERSION=6" ],
       "sources": [
         "src/binding.cc",
+        "src/context.cc",
+        "src/interrupt.cc",
+        "src/stats.cc",
+        "src/async.cc",
         "src/geometry.cc",
-        "src/transform.cc"
+        "src/arena.cc",
+        "src/pipeline.cc",
+        "src/transform.cc",
+        "src/coords.cc",
+        "src/geojson.cc",
+        "src/columnar.cc",
+        "src/shared.cc",
+        "src/prepared.cc",
+        "src/rtree.cc",
+        "src/spatialindex.cc",
+        "src/reader.cc",
+        "src/dataset.cc"
       ],
       "libraries": [
         "<!@(geos-config --clibs)"
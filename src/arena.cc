@@ -0,0 +1,113 @@
+#include "arena.h"
+#include "geometry.h"
+#include "instance.h"
+
+// Scopes are synchronous, i.e. strictly nested (per environment):
+Arena* CurrentArena(Napi::Env env) {
+  std::vector<Arena*>& arenas = GetInstanceData(env)->arenas;
+  return arenas.empty() ? NULL : arenas.back();
+}
+
+void Arena::Add(Geometry* geometry) {
+  geometry->arena = this;
+  geometry->arenaIndex = this->geometries.size();
+  this->geometries.push_back(geometry);
+}
+
+void Arena::Remove(Geometry* geometry) {
+  this->geometries[geometry->arenaIndex] = NULL;
+  geometry->arena = NULL;
+}
+
+/**
+ * Free all remaining geometries; pinned geometries are left to GC.
+ */
+void Arena::Release(Napi::Env env) {
+  for (size_t i = this->geometries.size(); i-- > 0;) {
+    Geometry* geometry = this->geometries[i];
+    if (geometry == NULL) continue;
+
+    geometry->arena = NULL;
+    if (!geometry->IsPinned()) geometry->Free(env);
+  }
+
+  this->geometries.clear();
+}
+
+/**
+ * Move geometry to enclosing scope (or none);
+ * false if arena is no longer active.
+ */
+static bool Escape(uint64_t id, Napi::Value value) {
+  std::vector<Arena*>& arenas = GetInstanceData(value.Env())->arenas;
+  size_t index = 0;
+  while (index < arenas.size() && arenas[index]->id != id) index++;
+  if (index == arenas.size()) return false;
+
+  Arena* arena = arenas[index];
+
+  if (!Geometry::IsInstance(value)) return true;
+  Geometry* geometry = Napi::ObjectWrap<Geometry>::Unwrap(value.As<Napi::Object>());
+  if (geometry->arena != arena) return true;
+
+  arena->Remove(geometry);
+  if (index > 0) arenas[index - 1]->Add(geometry);
+  return true;
+}
+
+/**
+ * Run fn(escape) and free all geometries created meanwhile.
+ * Geometries passed to escape() and the returned geometry (or
+ * geometries of returned array) survive the scope.
+ * fn must be synchronous.
+ * info[0] : Function - fn
+ */
+Napi::Value Scope(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: fn").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsFunction()) {
+    Napi::TypeError::New(env, "Invalid argument: fn").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  InstanceData* data = GetInstanceData(env);
+  Arena arena;
+  arena.id = data->nextArenaId++;
+  data->arenas.push_back(&arena);
+
+  uint64_t id = arena.id;
+  Napi::Function escape = Napi::Function::New(env, [id](const Napi::CallbackInfo& info) -> Napi::Value {
+    if (!Escape(id, info[0])) {
+      Napi::Error::New(info.Env(), "Scope closed").ThrowAsJavaScriptException();
+      return info.Env().Undefined();
+    }
+
+    return info[0];
+  });
+
+  Napi::Value result;
+
+  try {
+    result = info[0].As<Napi::Function>().Call({ escape });
+
+    if (result.IsArray()) {
+      Napi::Array array = result.As<Napi::Array>();
+      for (uint32_t i = 0; i < array.Length(); i++) Escape(id, array.Get(i));
+    } else {
+      Escape(id, result);
+    }
+  } catch (const Napi::Error&) {
+    data->arenas.pop_back();
+    arena.Release(env);
+    throw;
+  }
+
+  data->arenas.pop_back();
+  arena.Release(env);
+  return result;
+}
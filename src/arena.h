@@ -0,0 +1,32 @@
+#ifndef __ARENA_H
+#define __ARENA_H
+
+#include <napi.h>
+#include <vector>
+
+class Geometry;
+
+/**
+ * Geometries created during GEOS.scope(fn); freed in reverse
+ * order of creation when the scope exits, unless escaped.
+ */
+class Arena {
+ public:
+  // Unique per scope; arena addresses may be reused:
+  uint64_t id;
+
+  void Add(Geometry* geometry);
+  void Remove(Geometry* geometry);
+  void Release(Napi::Env env);
+
+ private:
+  // Removed geometries leave a NULL slot:
+  std::vector<Geometry*> geometries;
+};
+
+// Innermost active arena; NULL outside of any scope:
+Arena* CurrentArena(Napi::Env env);
+
+Napi::Value Scope(const Napi::CallbackInfo& info);
+
+#endif /* __ARENA_H */
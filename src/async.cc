@@ -0,0 +1,823 @@
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "async.h"
+#include "geometry.h"
+#include "prepared.h"
+#include "coords.h"
+#include "context.h"
+#include "stats.h"
+
+GeometryWorker::GeometryWorker(Napi::Env env, const char* name, Napi::Value options)
+  : Napi::AsyncWorker(env),
+    interrupt(options),
+    name(name),
+    deferred(Napi::Promise::Deferred::New(env)),
+    result(NULL) {
+  this->interrupt.Listen();
+}
+
+GeometryWorker::~GeometryWorker() {
+  for (size_t i = 0; i < this->pins.size(); i++) {
+    Geometry::Unpin(this->pins[i]);
+  }
+}
+
+/**
+ * Queue worker and return its promise.
+ */
+Napi::Promise GeometryWorker::Start() {
+  Napi::Promise promise = this->deferred.Promise();
+  this->Queue();
+  return promise;
+}
+
+/**
+ * Keep Geometry object alive and pinned (not disposable) while the worker is pending.
+ * Throws "Error: Invalid argument" if not a Geometry object.
+ */
+const GEOSGeometry* GeometryWorker::Retain(Napi::Object object) {
+  Geometry* geometry = Geometry::Unwrap(object);
+  this->references.push_back(Napi::Persistent(object));
+  this->pins.push_back(geometry->Pin());
+  return geometry->geometry;
+}
+
+/**
+ * Runs on thread pool with the pool thread's own GEOS context.
+ */
+void GeometryWorker::Execute() {
+  Context* context = GetContext();
+  context->last_error[0] = '\0';
+  StatsScope stats(this->name);
+  InterruptScope scope(&this->interrupt);
+
+  // Aborted or expired while queued:
+  if (this->interrupt.Check()) {
+    SetError("Operation interrupted");
+    return;
+  }
+
+  this->result = this->Run(context->handle);
+
+  if (this->result == NULL) {
+    SetError(context->last_error[0] ? context->last_error : "Operation failed");
+  }
+}
+
+void GeometryWorker::OnOK() {
+  Napi::Env env = Env();
+  this->interrupt.Release();
+  Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, this->result);
+  this->deferred.Resolve(Geometry::NewInstance(env, external));
+}
+
+void GeometryWorker::OnError(const Napi::Error& error) {
+  this->interrupt.Release();
+  this->deferred.Reject(this->interrupt.Reason() != INTERRUPT_NONE
+    ? this->interrupt.Error(Env()).Value()
+    : error.Value());
+}
+
+
+UnaryOpWorker::UnaryOpWorker(Napi::Env env, const char* name, Napi::Object object, unary_op_t fn, Napi::Value options)
+  : GeometryWorker(env, name, options), fn(fn) {
+  this->g1 = this->Retain(object);
+}
+
+GEOSGeometry* UnaryOpWorker::Run(GEOSContextHandle_t handle) {
+  return this->fn(handle, this->g1);
+}
+
+
+BinaryOpWorker::BinaryOpWorker(
+  Napi::Env env,
+  const char* name,
+  Napi::Object object,
+  Napi::Object other,
+  binary_op_t fn,
+  Napi::Value options
+) : GeometryWorker(env, name, options), fn(fn) {
+  this->g1 = this->Retain(object);
+  this->g2 = this->Retain(other);
+}
+
+GEOSGeometry* BinaryOpWorker::Run(GEOSContextHandle_t handle) {
+  return this->fn(handle, this->g1, this->g2);
+}
+
+
+BufferWorker::BufferWorker(
+  Napi::Env env,
+  const char* name,
+  Napi::Object object,
+  double width,
+  int quadsegs,
+  int endCapStyle,
+  int joinStyle,
+  double mitreLimit,
+  Napi::Value options
+) : GeometryWorker(env, name, options),
+    width(width),
+    quadsegs(quadsegs),
+    endCapStyle(endCapStyle),
+    joinStyle(joinStyle),
+    mitreLimit(mitreLimit) {
+  this->g1 = this->Retain(object);
+}
+
+GEOSGeometry* BufferWorker::Run(GEOSContextHandle_t handle) {
+  return GEOSBufferWithStyle_r(
+    handle,
+    this->g1,
+    this->width,
+    this->quadsegs,
+    this->endCapStyle,
+    this->joinStyle,
+    this->mitreLimit
+  );
+}
+
+
+// Partitions smaller than this are not worth a thread:
+#define MIN_PARTITION_SIZE 32
+
+/**
+ * Distance of (x, y) along Hilbert curve of order 16.
+ */
+static uint32_t HilbertIndex(uint32_t x, uint32_t y) {
+  uint32_t d = 0;
+  for (uint32_t s = 1 << 15; s > 0; s >>= 1) {
+    uint32_t rx = (x & s) > 0;
+    uint32_t ry = (y & s) > 0;
+    d += s * s * ((3 * rx) ^ ry);
+    if (ry == 0) {
+      if (rx == 1) {
+        x = s - 1 - x;
+        y = s - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+
+/**
+ * Input indexes ordered by Hilbert index of envelope centers.
+ * Also forces computation of (lazily cached) envelopes before
+ * geometries are shared between threads.
+ */
+std::vector<uint32_t> HilbertOrder(GEOSContextHandle_t handle, const std::vector<const GEOSGeometry*>& geometries) {
+  size_t n = geometries.size();
+  std::vector<double> centers(n * 2, 0.0);
+  double minx = INFINITY, miny = INFINITY, maxx = -INFINITY, maxy = -INFINITY;
+
+  for (size_t i = 0; i < n; i++) {
+    double xmin, ymin, xmax, ymax;
+    if (GEOSisEmpty_r(handle, geometries[i])) continue;
+    GEOSGeom_getXMin_r(handle, geometries[i], &xmin);
+    GEOSGeom_getYMin_r(handle, geometries[i], &ymin);
+    GEOSGeom_getXMax_r(handle, geometries[i], &xmax);
+    GEOSGeom_getYMax_r(handle, geometries[i], &ymax);
+    centers[i * 2] = (xmin + xmax) / 2;
+    centers[i * 2 + 1] = (ymin + ymax) / 2;
+    minx = std::min(minx, centers[i * 2]);
+    miny = std::min(miny, centers[i * 2 + 1]);
+    maxx = std::max(maxx, centers[i * 2]);
+    maxy = std::max(maxy, centers[i * 2 + 1]);
+  }
+
+  double width = maxx > minx ? maxx - minx : 1;
+  double height = maxy > miny ? maxy - miny : 1;
+  std::vector<uint32_t> keys(n);
+  for (size_t i = 0; i < n; i++) {
+    uint32_t x = (uint32_t)(65535 * std::max(0.0, (centers[i * 2] - minx) / width));
+    uint32_t y = (uint32_t)(65535 * std::max(0.0, (centers[i * 2 + 1] - miny) / height));
+    keys[i] = HilbertIndex(x, y);
+  }
+
+  std::vector<uint32_t> order(n);
+  for (size_t i = 0; i < n; i++) order[i] = i;
+  std::sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+  return order;
+}
+
+/**
+ * Process-wide pool of worker threads, started on first use and never
+ * stopped; threads (and their GEOS contexts) are reused across calls.
+ * Pool size is bounded by the number of cores, independent of requested
+ * partitions. Callers claim tasks of their own batch too, so a batch
+ * completes even if all workers are busy with other batches.
+ */
+class TaskPool {
+ public:
+  static TaskPool* Shared() {
+    // Leaked on purpose: workers must not be joined at process exit.
+    static TaskPool* pool = new TaskPool();
+    return pool;
+  }
+
+  void Run(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) return;
+
+    Batch batch = { &fn, count, 0, 0 };
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->Start();
+    this->queue.push_back(&batch);
+    this->available.notify_all();
+
+    while (batch.next < batch.count) this->Execute(&batch, lock);
+    this->finished.wait(lock, [&batch] { return batch.done == batch.count; });
+  }
+
+ private:
+  struct Batch {
+    const std::function<void(size_t)>* fn;
+    size_t count;
+    size_t next;
+    size_t done;
+  };
+
+  std::mutex mutex;
+  std::condition_variable available;
+  std::condition_variable finished;
+  std::deque<Batch*> queue;
+  bool started = false;
+
+  void Start() {
+    if (this->started) return;
+    this->started = true;
+    unsigned int size = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0; i < size; i++) std::thread(&TaskPool::Work, this).detach();
+  }
+
+  void Work() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    for (;;) {
+      this->available.wait(lock, [this] { return !this->queue.empty(); });
+      this->Execute(this->queue.front(), lock);
+    }
+  }
+
+  // Claim and run next task of batch; lock is held on entry and exit.
+  void Execute(Batch* batch, std::unique_lock<std::mutex>& lock) {
+    size_t i = batch->next++;
+    if (batch->next == batch->count) {
+      // Fully claimed batches leave the queue before their caller may return:
+      this->queue.erase(std::find(this->queue.begin(), this->queue.end(), batch));
+    }
+
+    lock.unlock();
+    (*batch->fn)(i);
+    lock.lock();
+    if (++batch->done == batch->count) this->finished.notify_all();
+  }
+};
+
+/**
+ * Run tasks on shared worker pool and calling thread; returns when all are done.
+ */
+static void RunParallel(size_t count, const std::function<void(size_t)>& fn) {
+  TaskPool::Shared()->Run(count, fn);
+}
+
+UnionAllWorker::UnionAllWorker(Napi::Env env, Napi::Array geometries, unsigned int threads, Napi::Value options)
+  : GeometryWorker(env, "GEOS::unionAll", options), threads(threads) {
+  uint32_t length = geometries.Length();
+  this->geometries.reserve(length);
+  for (uint32_t i = 0; i < length; i++) {
+    Napi::Value value = geometries[i];
+    this->geometries.push_back(this->Retain(value.As<Napi::Object>()));
+  }
+}
+
+GEOSGeometry* UnionAllWorker::Run(GEOSContextHandle_t handle) {
+  size_t n = this->geometries.size();
+  std::vector<uint32_t> order = HilbertOrder(handle, this->geometries);
+
+  size_t nparts = std::min((size_t)this->threads, n / MIN_PARTITION_SIZE);
+  if (nparts < 1) nparts = 1;
+
+  std::vector<GEOSGeometry*> partials(nparts, NULL);
+  std::mutex mutex;
+  std::string error;
+
+  // First error wins:
+  auto fail = [&](const char* message) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (error.empty()) error = message[0] ? message : "Operation failed";
+  };
+
+  // Each thread unions one spatially compact partition with its own context:
+  RunParallel(nparts, [&](size_t p) {
+    Context* context = GetContext();
+    InterruptScope scope(&this->interrupt);
+    size_t begin = n * p / nparts;
+    size_t end = n * (p + 1) / nparts;
+    std::vector<GEOSGeometry*> clones;
+    clones.reserve(end - begin);
+    for (size_t i = begin; i < end; i++) {
+      clones.push_back(GEOSGeom_clone_r(context->handle, this->geometries[order[i]]));
+    }
+
+    GEOSGeometry* collection = GEOSGeom_createCollection_r(
+      context->handle,
+      GEOS_GEOMETRYCOLLECTION,
+      clones.data(),
+      clones.size()
+    );
+
+    partials[p] = GEOSUnaryUnion_r(context->handle, collection);
+    GEOSGeom_destroy_r(context->handle, collection);
+    if (partials[p] == NULL) fail(context->last_error);
+  });
+
+  // Pairwise reduction of partial results:
+  while (partials.size() > 1) {
+    size_t npairs = partials.size() / 2;
+    std::vector<GEOSGeometry*> reduced(npairs + partials.size() % 2, NULL);
+    if (partials.size() % 2) reduced.back() = partials.back();
+
+    RunParallel(npairs, [&](size_t i) {
+      Context* context = GetContext();
+      InterruptScope scope(&this->interrupt);
+      GEOSGeometry* a = partials[i * 2];
+      GEOSGeometry* b = partials[i * 2 + 1];
+      // Failures of previous levels are already recorded:
+      if (a != NULL && b != NULL) {
+        reduced[i] = GEOSUnion_r(context->handle, a, b);
+        if (reduced[i] == NULL) fail(context->last_error);
+      }
+
+      if (a != NULL) GEOSGeom_destroy_r(context->handle, a);
+      if (b != NULL) GEOSGeom_destroy_r(context->handle, b);
+    });
+
+    partials.swap(reduced);
+  }
+
+  if (partials[0] == NULL) {
+    // Report error through context of calling thread:
+    Context* context = GetContext();
+    snprintf(context->last_error, sizeof(context->last_error), "%s", error.c_str());
+  }
+
+  return partials[0];
+}
+
+
+/**
+ * Predicates are evaluated with the probe side prepared; reverse is used
+ * when the right side is prepared: left P right <=> right reverse(P) left.
+ */
+static const struct {
+  const char* name;
+  prepared_predicate_t fn;
+  prepared_predicate_t reverse;
+} joinPredicates[] = {
+  { "intersects", &GEOSPreparedIntersects_r, &GEOSPreparedIntersects_r },
+  { "contains", &GEOSPreparedContains_r, &GEOSPreparedWithin_r },
+  { "within", &GEOSPreparedWithin_r, &GEOSPreparedContains_r },
+  { "covers", &GEOSPreparedCovers_r, &GEOSPreparedCoveredBy_r },
+  { "coveredBy", &GEOSPreparedCoveredBy_r, &GEOSPreparedCovers_r },
+  { "touches", &GEOSPreparedTouches_r, &GEOSPreparedTouches_r },
+  { "crosses", &GEOSPreparedCrosses_r, &GEOSPreparedCrosses_r },
+  { "overlaps", &GEOSPreparedOverlaps_r, &GEOSPreparedOverlaps_r }
+};
+
+int JoinPredicate(const std::string& name) {
+  for (size_t i = 0; i < sizeof(joinPredicates) / sizeof(joinPredicates[0]); i++) {
+    if (name == joinPredicates[i].name) return i;
+  }
+
+  return -1;
+}
+
+/**
+ * Arguments are validated by GEOS::join().
+ */
+JoinWorker::JoinWorker(
+  Napi::Env env,
+  Napi::Array left,
+  Napi::Array right,
+  int predicate,
+  unsigned int threads,
+  Napi::Value options
+) : Napi::AsyncWorker(env),
+    deferred(Napi::Promise::Deferred::New(env)),
+    predicate(predicate),
+    threads(threads),
+    interrupt(options) {
+  this->leftReference = this->Retain(left, this->left);
+  this->rightReference = this->Retain(right, this->right);
+  this->interrupt.Listen();
+}
+
+JoinWorker::~JoinWorker() {
+  for (size_t i = 0; i < this->pins.size(); i++) {
+    Geometry::Unpin(this->pins[i]);
+  }
+}
+
+/**
+ * Pin geometries; private copy of input array keeps them alive.
+ */
+Napi::ObjectReference JoinWorker::Retain(Napi::Array input, std::vector<const GEOSGeometry*>& geometries) {
+  uint32_t length = input.Length();
+  Napi::Array array = Napi::Array::New(Env(), length);
+  geometries.reserve(length);
+
+  for (uint32_t i = 0; i < length; i++) {
+    Napi::Value value = input[i];
+    Geometry* geometry = Geometry::Unwrap(value.As<Napi::Object>());
+    array.Set(i, value);
+    geometries.push_back(geometry->geometry);
+    this->pins.push_back(geometry->Pin());
+  }
+
+  return Napi::Persistent(array.As<Napi::Object>());
+}
+
+Napi::Promise JoinWorker::Start() {
+  Napi::Promise promise = this->deferred.Promise();
+  this->Queue();
+  return promise;
+}
+
+static double MeanCoordinates(GEOSContextHandle_t handle, const std::vector<const GEOSGeometry*>& geometries) {
+  if (geometries.empty()) return 0;
+  double sum = 0;
+  for (size_t i = 0; i < geometries.size(); i++) {
+    sum += std::max(0, GEOSGetNumCoordinates_r(handle, geometries[i]));
+  }
+  return sum / geometries.size();
+}
+
+static void join_callback(void *item, void *userdata) {
+  std::vector<uint32_t>* candidates = (std::vector<uint32_t>*)userdata;
+  candidates->push_back((uint32_t)(uintptr_t)item);
+}
+
+void JoinWorker::Execute() {
+  StatsScope stats("GEOS::join");
+  GEOSContextHandle_t handle = GetContext()->handle;
+
+  // Aborted or expired while queued:
+  if (this->interrupt.Check()) {
+    SetError("Operation interrupted");
+    return;
+  }
+
+  // Preparing pays off for complex geometries; prepare side with more vertices per geometry:
+  bool prepareLeft = MeanCoordinates(handle, this->left) >= MeanCoordinates(handle, this->right);
+  const std::vector<const GEOSGeometry*>& probes = prepareLeft ? this->left : this->right;
+  const std::vector<const GEOSGeometry*>& items = prepareLeft ? this->right : this->left;
+  prepared_predicate_t fn = prepareLeft
+    ? joinPredicates[this->predicate].fn
+    : joinPredicates[this->predicate].reverse;
+
+  if (probes.empty() || items.empty()) return;
+
+  // Empty geometries satisfy none of the join predicates:
+  GEOSSTRtree* tree = GEOSSTRtree_create_r(handle, 10);
+  const GEOSGeometry* any = NULL;
+  for (size_t i = 0; i < items.size(); i++) {
+    if (GEOSisEmpty_r(handle, items[i])) continue;
+    GEOSSTRtree_insert_r(handle, tree, items[i], (void*)(uintptr_t)i);
+    any = items[i];
+  }
+
+  // Tree is built lazily by first query; build before sharing between threads:
+  std::vector<uint32_t> ignore;
+  if (any != NULL) GEOSSTRtree_query_r(handle, tree, any, join_callback, &ignore);
+
+  size_t n = probes.size();
+  std::vector<uint32_t> order = HilbertOrder(handle, probes);
+  size_t nparts = std::min((size_t)this->threads, n / MIN_PARTITION_SIZE);
+  if (nparts < 1) nparts = 1;
+
+  std::vector<std::vector<std::pair<uint32_t, uint32_t>>> partials(nparts);
+  std::mutex mutex;
+  std::string error;
+
+  // First error wins:
+  auto fail = [&](const char* message) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (error.empty()) error = message[0] ? message : "Operation failed";
+  };
+
+  // Each thread probes one spatially compact partition with its own context:
+  RunParallel(nparts, [&](size_t p) {
+    Context* context = GetContext();
+    InterruptScope scope(&this->interrupt);
+    std::vector<uint32_t> candidates;
+    size_t begin = n * p / nparts;
+    size_t end = n * (p + 1) / nparts;
+
+    for (size_t i = begin; i < end; i++) {
+      uint32_t probe = order[i];
+      if (GEOSisEmpty_r(context->handle, probes[probe])) continue;
+
+      // Prepared predicates do not poll for interrupts:
+      if (this->interrupt.Check()) {
+        fail("Operation interrupted");
+        break;
+      }
+
+      candidates.clear();
+      GEOSSTRtree_query_r(context->handle, tree, probes[probe], join_callback, &candidates);
+      if (candidates.empty()) continue;
+
+      const GEOSPreparedGeometry* prepared = GEOSPrepare_r(context->handle, probes[probe]);
+      for (size_t c = 0; c < candidates.size(); c++) {
+        char result = fn(context->handle, prepared, items[candidates[c]]);
+        if (result == 2) {
+          fail(context->last_error);
+          break;
+        }
+
+        if (result == 1) {
+          partials[p].push_back(prepareLeft
+            ? std::make_pair(probe, candidates[c])
+            : std::make_pair(candidates[c], probe));
+        }
+      }
+
+      GEOSPreparedGeom_destroy_r(context->handle, prepared);
+    }
+  });
+
+  GEOSSTRtree_destroy_r(handle, tree);
+
+  if (!error.empty()) {
+    SetError(error);
+    return;
+  }
+
+  size_t total = 0;
+  for (size_t p = 0; p < nparts; p++) total += partials[p].size();
+  this->pairs.reserve(total);
+  for (size_t p = 0; p < nparts; p++) {
+    this->pairs.insert(this->pairs.end(), partials[p].begin(), partials[p].end());
+  }
+
+  std::sort(this->pairs.begin(), this->pairs.end());
+}
+
+void JoinWorker::OnOK() {
+  Napi::Env env = Env();
+  this->interrupt.Release();
+  Napi::Uint32Array left = Napi::Uint32Array::New(env, this->pairs.size());
+  Napi::Uint32Array right = Napi::Uint32Array::New(env, this->pairs.size());
+
+  for (size_t i = 0; i < this->pairs.size(); i++) {
+    left[i] = this->pairs[i].first;
+    right[i] = this->pairs[i].second;
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("left", left);
+  result.Set("right", right);
+  this->deferred.Resolve(result);
+}
+
+void JoinWorker::OnError(const Napi::Error& error) {
+  this->interrupt.Release();
+  this->deferred.Reject(this->interrupt.Reason() != INTERRUPT_NONE
+    ? this->interrupt.Error(Env()).Value()
+    : error.Value());
+}
+
+/**
+ * Arguments are validated by GEOS::buildLOD().
+ */
+LODWorker::LODWorker(
+  Napi::Env env,
+  Napi::Array geometries,
+  const std::vector<double>& tolerances,
+  bool preserveTopology,
+  bool flat,
+  unsigned int threads,
+  Napi::Value options
+) : Napi::AsyncWorker(env),
+    deferred(Napi::Promise::Deferred::New(env)),
+    tolerances(tolerances),
+    preserveTopology(preserveTopology),
+    flat(flat),
+    threads(threads),
+    interrupt(options) {
+  // Pin geometries; private copy of input array keeps them alive:
+  uint32_t length = geometries.Length();
+  Napi::Array array = Napi::Array::New(env, length);
+  this->geometries.reserve(length);
+
+  for (uint32_t i = 0; i < length; i++) {
+    Napi::Value value = geometries[i];
+    Geometry* geometry = Geometry::Unwrap(value.As<Napi::Object>());
+    array.Set(i, value);
+    this->geometries.push_back(geometry->geometry);
+    this->pins.push_back(geometry->Pin());
+  }
+
+  this->reference = Napi::Persistent(array.As<Napi::Object>());
+  this->interrupt.Listen();
+}
+
+LODWorker::~LODWorker() {
+  GEOSContextHandle_t handle = GetContext()->handle;
+  for (size_t i = 0; i < this->levels.size(); i++) {
+    if (this->levels[i] != NULL) GEOSGeom_destroy_r(handle, this->levels[i]);
+  }
+
+  for (size_t i = 0; i < this->wkbs.size(); i++) {
+    if (this->wkbs[i] != NULL) GEOSFree_r(handle, this->wkbs[i]);
+  }
+
+  for (size_t i = 0; i < this->pins.size(); i++) {
+    Geometry::Unpin(this->pins[i]);
+  }
+}
+
+Napi::Promise LODWorker::Start() {
+  Napi::Promise promise = this->deferred.Promise();
+  this->Queue();
+  return promise;
+}
+
+void LODWorker::Execute() {
+  StatsScope stats("GEOS::buildLOD");
+
+  // Aborted or expired while queued:
+  if (this->interrupt.Check()) {
+    SetError("Operation interrupted");
+    return;
+  }
+
+  size_t n = this->geometries.size();
+  size_t nlevels = this->tolerances.size();
+  this->levels.assign(n * nlevels, NULL);
+  if (!this->flat) {
+    this->wkbs.assign(n * nlevels, NULL);
+    this->sizes.assign(n * nlevels, 0);
+  }
+
+  // Geometries are independent; no spatial ordering needed:
+  size_t nparts = std::min((size_t)this->threads, n / MIN_PARTITION_SIZE);
+  if (nparts < 1) nparts = 1;
+
+  std::mutex mutex;
+  std::string error;
+
+  // First error wins:
+  auto fail = [&](const char* message) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (error.empty()) error = message[0] ? message : "Operation failed";
+  };
+
+  RunParallel(nparts, [&](size_t p) {
+    Context* context = GetContext();
+    InterruptScope scope(&this->interrupt);
+    if (!this->flat) GEOSWKBWriter_setIncludeSRID_r(context->handle, context->wkbWriter, 0);
+    size_t begin = n * p / nparts;
+    size_t end = n * (p + 1) / nparts;
+
+    for (size_t i = begin; i < end; i++) {
+      // Simplifiers do not poll for interrupts:
+      if (this->interrupt.Check()) {
+        fail("Operation interrupted");
+        return;
+      }
+
+      // Coarser levels start from the previous level, i.e. fewer vertices:
+      const GEOSGeometry* input = this->geometries[i];
+      for (size_t l = 0; l < nlevels; l++) {
+        size_t k = l * n + i;
+        this->levels[k] = this->preserveTopology
+          ? GEOSTopologyPreserveSimplify_r(context->handle, input, this->tolerances[l])
+          : GEOSSimplify_r(context->handle, input, this->tolerances[l]);
+
+        if (this->levels[k] == NULL) {
+          fail(context->last_error);
+          return;
+        }
+
+        if (!this->flat) {
+          this->wkbs[k] = GEOSWKBWriter_write_r(context->handle, context->wkbWriter, this->levels[k], &this->sizes[k]);
+          if (this->wkbs[k] == NULL) {
+            fail(context->last_error);
+            return;
+          }
+        }
+
+        input = this->levels[k];
+      }
+
+      // WKB is all that is left of encoded levels:
+      if (!this->flat) {
+        for (size_t l = 0; l < nlevels; l++) {
+          GEOSGeom_destroy_r(context->handle, this->levels[l * n + i]);
+          this->levels[l * n + i] = NULL;
+        }
+      }
+    }
+  });
+
+  if (!error.empty()) SetError(error);
+}
+
+/**
+ * { tolerance, wkb: Buffer, offsets: Uint32Array }; geometry i spans
+ * bytes offsets[i] to offsets[i + 1] of concatenated WKB.
+ */
+Napi::Object LODWorker::LevelWKB(size_t level) {
+  Napi::Env env = Env();
+  size_t n = this->geometries.size();
+  size_t total = 0;
+  for (size_t i = 0; i < n; i++) total += this->sizes[level * n + i];
+
+  Napi::Buffer<unsigned char> wkb = Napi::Buffer<unsigned char>::New(env, total);
+  Napi::Uint32Array offsets = Napi::Uint32Array::New(env, n + 1);
+  size_t offset = 0;
+  offsets[0] = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    size_t k = level * n + i;
+    memcpy(wkb.Data() + offset, this->wkbs[k], this->sizes[k]);
+    offset += this->sizes[k];
+    offsets[i + 1] = offset;
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("tolerance", Napi::Number::New(env, this->tolerances[level]));
+  result.Set("wkb", wkb);
+  result.Set("offsets", offsets);
+  return result;
+}
+
+/**
+ * { tolerance, coords, dims, ringOffsets, partOffsets, geomOffsets }
+ * (see Geometry::getCoordinates()); geometry i spans parts
+ * geomOffsets[i] to geomOffsets[i + 1].
+ */
+Napi::Object LODWorker::LevelFlat(size_t level) {
+  Napi::Env env = Env();
+  GEOSContextHandle_t handle = GetContext()->handle;
+  size_t n = this->geometries.size();
+  FlatCounts counts = { 0, 0, 0 };
+  int hasZ = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    const GEOSGeometry* g = this->levels[level * n + i];
+    CountFlat(handle, g, &counts);
+    if (GEOSHasZ_r(handle, g) == 1) hasZ = 1;
+  }
+
+  Napi::Float64Array coords = Napi::Float64Array::New(env, counts.coords * (hasZ ? 3 : 2));
+  Napi::Uint32Array ringOffsets = Napi::Uint32Array::New(env, counts.rings + 1);
+  Napi::Uint32Array partOffsets = Napi::Uint32Array::New(env, counts.parts + 1);
+  Napi::Uint32Array geomOffsets = Napi::Uint32Array::New(env, n + 1);
+  ringOffsets[0] = 0;
+  partOffsets[0] = 0;
+  geomOffsets[0] = 0;
+
+  FlatBuffers buffers = { coords.Data(), ringOffsets.Data(), partOffsets.Data(), hasZ, 0, 0, 0 };
+  for (size_t i = 0; i < n; i++) {
+    WriteFlat(handle, this->levels[level * n + i], &buffers);
+    geomOffsets[i + 1] = buffers.part;
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("tolerance", Napi::Number::New(env, this->tolerances[level]));
+  result.Set("coords", coords);
+  result.Set("dims", Napi::Number::New(env, hasZ ? 3 : 2));
+  result.Set("ringOffsets", ringOffsets);
+  result.Set("partOffsets", partOffsets);
+  result.Set("geomOffsets", geomOffsets);
+  return result;
+}
+
+void LODWorker::OnOK() {
+  Napi::Env env = Env();
+  this->interrupt.Release();
+  Napi::Array result = Napi::Array::New(env, this->tolerances.size());
+
+  for (size_t l = 0; l < this->tolerances.size(); l++) {
+    result.Set((uint32_t)l, this->flat ? this->LevelFlat(l) : this->LevelWKB(l));
+  }
+
+  this->deferred.Resolve(result);
+}
+
+void LODWorker::OnError(const Napi::Error& error) {
+  this->interrupt.Release();
+  this->deferred.Reject(this->interrupt.Reason() != INTERRUPT_NONE
+    ? this->interrupt.Error(Env()).Value()
+    : error.Value());
+}
@@ -0,0 +1,208 @@
+#ifndef __ASYNC_H
+#define __ASYNC_H
+
+#include <napi.h>
+#include <geos_c.h>
+#include <vector>
+#include <memory>
+#include <string>
+#include <utility>
+#include "interrupt.h"
+
+typedef GEOSGeometry* (*unary_op_t)(GEOSContextHandle_t, const GEOSGeometry*);
+typedef GEOSGeometry* (*binary_op_t)(GEOSContextHandle_t, const GEOSGeometry*, const GEOSGeometry*);
+
+/**
+ * Promise-returning geometry operation executed on the libuv thread pool.
+ * Input geometries are referenced until the worker completes;
+ * the result is wrapped as Geometry on the main thread only.
+ * Options { timeout, signal } (see Interrupt) are validated by caller.
+ */
+class GeometryWorker : public Napi::AsyncWorker {
+ public:
+  GeometryWorker(Napi::Env env, const char* name, Napi::Value options);
+  ~GeometryWorker();
+  Napi::Promise Start();
+
+ protected:
+  const GEOSGeometry* Retain(Napi::Object object);
+  virtual GEOSGeometry* Run(GEOSContextHandle_t handle) = 0;
+  void Execute();
+  void OnOK();
+  void OnError(const Napi::Error& error);
+  Interrupt interrupt;
+
+ private:
+  const char* name; // statistics
+  Napi::Promise::Deferred deferred;
+  std::vector<Napi::ObjectReference> references;
+  std::vector<std::shared_ptr<int>> pins;
+  GEOSGeometry* result;
+};
+
+class UnaryOpWorker : public GeometryWorker {
+ public:
+  UnaryOpWorker(Napi::Env env, const char* name, Napi::Object object, unary_op_t fn, Napi::Value options);
+
+ protected:
+  GEOSGeometry* Run(GEOSContextHandle_t handle);
+
+ private:
+  const GEOSGeometry* g1;
+  unary_op_t fn;
+};
+
+class BinaryOpWorker : public GeometryWorker {
+ public:
+  BinaryOpWorker(
+    Napi::Env env,
+    const char* name,
+    Napi::Object object,
+    Napi::Object other,
+    binary_op_t fn,
+    Napi::Value options
+  );
+
+ protected:
+  GEOSGeometry* Run(GEOSContextHandle_t handle);
+
+ private:
+  const GEOSGeometry* g1;
+  const GEOSGeometry* g2;
+  binary_op_t fn;
+};
+
+class BufferWorker : public GeometryWorker {
+ public:
+  BufferWorker(
+    Napi::Env env,
+    const char* name,
+    Napi::Object object,
+    double width,
+    int quadsegs,
+    int endCapStyle,
+    int joinStyle,
+    double mitreLimit,
+    Napi::Value options
+  );
+
+ protected:
+  GEOSGeometry* Run(GEOSContextHandle_t handle);
+
+ private:
+  const GEOSGeometry* g1;
+  double width;
+  int quadsegs;
+  int endCapStyle;
+  int joinStyle;
+  double mitreLimit;
+};
+
+/**
+ * Union of many geometries: inputs are partitioned along a Hilbert curve,
+ * partitions are unioned on separate threads and partial results are
+ * reduced pairwise (again in parallel).
+ */
+class UnionAllWorker : public GeometryWorker {
+ public:
+  UnionAllWorker(Napi::Env env, Napi::Array geometries, unsigned int threads, Napi::Value options);
+
+ protected:
+  GEOSGeometry* Run(GEOSContextHandle_t handle);
+
+ private:
+  std::vector<const GEOSGeometry*> geometries;
+  unsigned int threads;
+};
+
+/**
+ * Spatial join: geometries of one side are indexed (STRtree), those of
+ * the other side are prepared and probe the index on multiple threads.
+ * Resolves to { left: Uint32Array, right: Uint32Array } of matching
+ * index pairs, ordered by left, then right index.
+ */
+class JoinWorker : public Napi::AsyncWorker {
+ public:
+  JoinWorker(
+    Napi::Env env,
+    Napi::Array left,
+    Napi::Array right,
+    int predicate,
+    unsigned int threads,
+    Napi::Value options
+  );
+  ~JoinWorker();
+  Napi::Promise Start();
+
+ protected:
+  void Execute();
+  void OnOK();
+  void OnError(const Napi::Error& error);
+
+ private:
+  Napi::Promise::Deferred deferred;
+  Napi::ObjectReference leftReference;
+  Napi::ObjectReference rightReference;
+  std::vector<std::shared_ptr<int>> pins;
+  std::vector<const GEOSGeometry*> left;
+  std::vector<const GEOSGeometry*> right;
+  int predicate;
+  unsigned int threads;
+  Interrupt interrupt;
+  std::vector<std::pair<uint32_t, uint32_t>> pairs;
+
+  Napi::ObjectReference Retain(Napi::Array input, std::vector<const GEOSGeometry*>& geometries);
+};
+
+/**
+ * Level of detail pyramid: every geometry is simplified for ascending
+ * tolerances, each level from the previous (finer) one; geometries are
+ * partitioned between threads. Resolves to one level per tolerance,
+ * encoded as WKB or flat coordinates (see GEOS::buildLOD()).
+ */
+class LODWorker : public Napi::AsyncWorker {
+ public:
+  LODWorker(
+    Napi::Env env,
+    Napi::Array geometries,
+    const std::vector<double>& tolerances,
+    bool preserveTopology,
+    bool flat,
+    unsigned int threads,
+    Napi::Value options
+  );
+  ~LODWorker();
+  Napi::Promise Start();
+
+ protected:
+  void Execute();
+  void OnOK();
+  void OnError(const Napi::Error& error);
+
+ private:
+  Napi::Promise::Deferred deferred;
+  Napi::ObjectReference reference;
+  std::vector<std::shared_ptr<int>> pins;
+  std::vector<const GEOSGeometry*> geometries;
+  std::vector<double> tolerances;
+  bool preserveTopology;
+  bool flat;
+  unsigned int threads;
+  Interrupt interrupt;
+
+  // Level-major (level * count + index) results; flat: geometries, WKB: buffers:
+  std::vector<GEOSGeometry*> levels;
+  std::vector<unsigned char*> wkbs;
+  std::vector<size_t> sizes;
+
+  Napi::Object LevelWKB(size_t level);
+  Napi::Object LevelFlat(size_t level);
+};
+
+// Index of join predicate (left predicate right); -1 if not supported:
+int JoinPredicate(const std::string& name);
+
+// Input indexes ordered by Hilbert index of envelope centers:
+std::vector<uint32_t> HilbertOrder(GEOSContextHandle_t handle, const std::vector<const GEOSGeometry*>& geometries);
+
+#endif /* __ASYNC_H */
@@ -1,38 +1,22 @@
 #include <napi.h>
 #include <geos_c.h>
+#include <algorithm>
+#include <thread>
 #include "geometry.h"
-
-#ifdef __GNUC__
- #include <cstdarg>
-#endif
-
-
-char last_error[256];
-
-char* get_last_error() {
-  return last_error;
-}
-
-void notice_fn(const char *fmt, ...) {
-	va_list ap;
-  fprintf(stdout, "NOTICE: ");
-
-	va_start(ap, fmt);
-    vfprintf(stdout, fmt, ap);
-  va_end(ap);
-  fprintf(stdout, "\n" );
-}
-
-void error_fn(const char *fmt, ...) {
-	va_list args;
-	va_start(args, fmt);
-  vsnprintf(last_error, 255, fmt, args);
-  va_end(args);
-}
-
-GEOSWKTReader *reader;
-GEOSWKTWriter *writer;
-
+#include "prepared.h"
+#include "spatialindex.h"
+#include "reader.h"
+#include "dataset.h"
+#include "geojson.h"
+#include "columnar.h"
+#include "shared.h"
+#include "instance.h"
+#include "arena.h"
+#include "pipeline.h"
+#include "coords.h"
+#include "context.h"
+#include "interrupt.h"
+#include "stats.h"
 
 /**
  * Parse a WKT string returning a Geometry.
@@ -40,6 +24,7 @@ GEOSWKTWriter *writer;
  */
 Napi::Value ReadWKT(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  StatsScope stats("GEOS::readWKT");
 
   if (info.Length() < 1) {
     Napi::Error::New(env, "Missing argument: WKT").ThrowAsJavaScriptException();
@@ -51,11 +36,12 @@ Napi::Value ReadWKT(const Napi::CallbackInfo& info) {
     return env.Undefined();
   }
 
+  Context* context = GetContext();
   std::string wkt = info[0].As<Napi::String>().Utf8Value();
-  GEOSGeometry *geometry = GEOSWKTReader_read(reader, wkt.c_str());
+  GEOSGeometry *geometry = GEOSWKTReader_read_r(context->handle, context->reader, wkt.c_str());
 
   if (geometry == NULL) {
-    Napi::Error::New(env, get_last_error()).ThrowAsJavaScriptException();
+    Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
     return env.Undefined();
   }
 
@@ -70,6 +56,7 @@ Napi::Value ReadWKT(const Napi::CallbackInfo& info) {
  */
 Napi::Value WriteWKT(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  StatsScope stats("GEOS::writeWKT");
 
   if (info.Length() < 1) {
     Napi::Error::New(env, "Missing argument: Geometry").ThrowAsJavaScriptException();
@@ -82,27 +69,283 @@ Napi::Value WriteWKT(const Napi::CallbackInfo& info) {
   }
 
   // Throws "Error: Invalid argument" if not a Geometry object:
-  Geometry* geometry = Napi::ObjectWrap<Geometry>::Unwrap(info[0].As<Napi::Object>());
-  char *wkt = GEOSWKTWriter_write(writer, geometry->geometry);
+  Geometry* geometry = Geometry::Unwrap(info[0].As<Napi::Object>());
+  Context* context = GetContext();
+  char *wkt = GEOSWKTWriter_write_r(context->handle, context->writer, geometry->geometry);
   Napi::Value value = Napi::String::New(env, wkt);
-  GEOSFree(wkt);
+  GEOSFree_r(context->handle, wkt);
 
   return value;
 }
 
 
 /**
- * Construct a LineString from Point array.
- * info[0] : [Point]
+ * Resolve byte range of Buffer, TypedArray or ArrayBuffer without copying.
+ */
+static bool GetBytes(Napi::Value value, const unsigned char** data, size_t* size) {
+  if (value.IsTypedArray()) {
+    Napi::TypedArray array = value.As<Napi::TypedArray>();
+    *data = (const unsigned char*)array.ArrayBuffer().Data() + array.ByteOffset();
+    *size = array.ByteLength();
+    return true;
+  }
+
+  if (value.IsArrayBuffer()) {
+    Napi::ArrayBuffer buffer = value.As<Napi::ArrayBuffer>();
+    *data = (const unsigned char*)buffer.Data();
+    *size = buffer.ByteLength();
+    return true;
+  }
+
+  return false;
+}
+
+
+/**
+ * Parse (E)WKB returning a Geometry; input is not copied.
+ * info[0] : Buffer | TypedArray | ArrayBuffer - WKB
+ */
+Napi::Value ReadWKB(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("GEOS::readWKB");
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: WKB").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  const unsigned char* wkb;
+  size_t size;
+
+  if (!GetBytes(info[0], &wkb, &size)) {
+    Napi::TypeError::New(env, "Invalid argument: WKB").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Context* context = GetContext();
+  GEOSGeometry *geometry = GEOSWKBReader_read_r(context->handle, context->wkbReader, wkb, size);
+
+  if (geometry == NULL) {
+    Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
+  return Geometry::NewInstance(env, external);
+}
+
+
+/**
+ * Parse hex-encoded (E)WKB returning a Geometry.
+ * info[0] : String | Buffer - hex WKB
+ */
+Napi::Value ReadHexWKB(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("GEOS::readHexWKB");
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: WKB").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Context* context = GetContext();
+  GEOSGeometry *geometry;
+
+  if (info[0].IsString()) {
+    std::string hex = info[0].As<Napi::String>().Utf8Value();
+    geometry = GEOSWKBReader_readHEX_r(
+      context->handle,
+      context->wkbReader,
+      (const unsigned char*)hex.c_str(),
+      hex.size()
+    );
+  } else {
+    const unsigned char* hex;
+    size_t size;
+
+    if (!GetBytes(info[0], &hex, &size)) {
+      Napi::TypeError::New(env, "Invalid argument: WKB").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    geometry = GEOSWKBReader_readHEX_r(context->handle, context->wkbReader, hex, size);
+  }
+
+  if (geometry == NULL) {
+    Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
+  return Geometry::NewInstance(env, external);
+}
+
+
+/**
+ * Returns WKB Buffer for the given Geometry; Buffer adopts GEOS memory.
+ * info[0] : Geometry
+ * info[1] : Boolean - include SRID, i.e. EWKB (optional)
+ */
+Napi::Value WriteWKB(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("GEOS::writeWKB");
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: Geometry").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsObject()) {
+    Napi::TypeError::New(env, "Invalid argument: Geometry").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // Throws "Error: Invalid argument" if not a Geometry object:
+  Geometry* geometry = Geometry::Unwrap(info[0].As<Napi::Object>());
+  bool includeSRID = info.Length() > 1 && info[1].ToBoolean().Value();
+
+  Context* context = GetContext();
+  GEOSWKBWriter_setIncludeSRID_r(context->handle, context->wkbWriter, includeSRID);
+
+  size_t size;
+  unsigned char *wkb = GEOSWKBWriter_write_r(context->handle, context->wkbWriter, geometry->geometry, &size);
+
+  if (wkb == NULL) {
+    Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  return Napi::Buffer<unsigned char>::New(env, wkb, size, [](Napi::Env env, unsigned char* wkb) {
+    GEOSFree_r(GetContext()->handle, wkb);
+  });
+}
+
+
+/**
+ * Read optional coordinate dimension argument (2 or 3; default 2).
+ */
+static bool GetDims(const Napi::CallbackInfo& info, size_t index, int* dims) {
+  *dims = 2;
+  if (info.Length() <= index || info[index].IsUndefined()) return true;
+  if (!info[index].IsNumber()) return false;
+
+  *dims = info[index].As<Napi::Number>().Int32Value();
+  return *dims == 2 || *dims == 3;
+}
+
+/**
+ * Read interleaved coordinates and dimension arguments.
+ */
+static bool GetFlatCoords(
+  const Napi::CallbackInfo& info,
+  size_t dimsIndex,
+  const double** coords,
+  uint32_t* ncoords,
+  int* dims
+) {
+  Napi::Env env = info.Env();
+  uint32_t length;
+
+  if (!GetFloat64Array(info[0], coords, &length)) {
+    Napi::TypeError::New(env, "Invalid argument: coords").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  if (!GetDims(info, dimsIndex, dims)) {
+    Napi::TypeError::New(env, "Invalid argument: dims").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  if (length % *dims != 0) {
+    Napi::Error::New(env, "Invalid range: coords").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  *ncoords = length / *dims;
+  return true;
+}
+
+/**
+ * Read offsets argument; offsets must not exceed max.
+ */
+static bool GetOffsets(
+  const Napi::CallbackInfo& info,
+  size_t index,
+  const char* name,
+  const uint32_t** offsets,
+  uint32_t* length,
+  uint32_t max
+) {
+  Napi::Env env = info.Env();
+
+  if (!GetUint32Array(info[index], offsets, length)) {
+    Napi::TypeError::New(env, std::string("Invalid argument: ") + name).ThrowAsJavaScriptException();
+    return false;
+  }
+
+  if (!CheckOffsets(*offsets, *length, max)) {
+    Napi::Error::New(env, std::string("Invalid range: ") + name).ThrowAsJavaScriptException();
+    return false;
+  }
+
+  return true;
+}
+
+
+/**
+ * Construct a LineString from interleaved coordinates.
+ * info[0] : Float64Array - coords
+ * info[1] : int32 - dims (optional, default 2)
+ */
+static Napi::Value CreateLineStringFlat(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  Context* context = GetContext();
+
+  const double* coords;
+  uint32_t ncoords;
+  int dims;
+
+  if (!GetFlatCoords(info, 1, &coords, &ncoords, &dims)) {
+    return env.Undefined();
+  }
+
+  if (ncoords < 2) {
+    Napi::Error::New(env, "Invalid range: coords").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  GEOSCoordSequence* coordSeq = CoordSeqFromFlat(context->handle, coords, ncoords, dims);
+  GEOSGeometry *geometry = GEOSGeom_createLineString_r(context->handle, coordSeq);
+
+  if (geometry == NULL) {
+    Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
+  return Geometry::NewInstance(env, external);
+}
+
+
+/**
+ * Construct a LineString from Point array or interleaved coordinates.
+ * info[0] : [Point] | Float64Array
+ * info[1] : int32 - dims (Float64Array only; optional, default 2)
  */
 Napi::Value CreateLineString(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  StatsScope stats("GEOS::createLineString");
+  GEOSContextHandle_t handle = GetContext()->handle;
 
   if (info.Length() < 1) {
     Napi::Error::New(env, "Missing argument: [Point]").ThrowAsJavaScriptException();
     return env.Undefined();
   }
 
+  if (info[0].IsTypedArray()) {
+    return CreateLineStringFlat(info);
+  }
+
   unsigned int size = info[0].As<Napi::Array>().Length();
 
   if (size < 2) {
@@ -115,28 +358,205 @@ Napi::Value CreateLineString(const Napi::CallbackInfo& info) {
   // Check if supplied geometries are points:
   for(uint32_t i = 0; i < size; i++) {
     Napi::Value value = points[i];
-    Geometry* geometry = Napi::ObjectWrap<Geometry>::Unwrap(value.As<Napi::Object>());
-    if (GEOSGeomTypeId(geometry->geometry) != GEOS_POINT) {
+    Geometry* geometry = Geometry::Unwrap(value.As<Napi::Object>());
+    if (GEOSGeomTypeId_r(handle, geometry->geometry) != GEOS_POINT) {
       Napi::TypeError::New(env, "Invalid argument: [Point]").ThrowAsJavaScriptException();
       return env.Undefined();
     }
   }
 
-  GEOSCoordSequence* coordSeq = GEOSCoordSeq_create(size, 2);
+  GEOSCoordSequence* coordSeq = GEOSCoordSeq_create_r(handle, size, 2);
 
   double x;
   double y;
 
   for(uint32_t i = 0; i < size; i++) {
     Napi::Value value = points[i];
-    Geometry* point = Napi::ObjectWrap<Geometry>::Unwrap(value.As<Napi::Object>());
-    GEOSGeomGetX(point->geometry, &x);
-    GEOSGeomGetY(point->geometry, &y);
-    GEOSCoordSeq_setXY(coordSeq, i, x, y);
+    Geometry* point = Geometry::Unwrap(value.As<Napi::Object>());
+    GEOSGeomGetX_r(handle, point->geometry, &x);
+    GEOSGeomGetY_r(handle, point->geometry, &y);
+    GEOSCoordSeq_setXY_r(handle, coordSeq, i, x, y);
   }
 
   // coordSeq is now owned by new geometry:
-	GEOSGeometry *geometry = GEOSGeom_createLineString(coordSeq);
+	GEOSGeometry *geometry = GEOSGeom_createLineString_r(handle, coordSeq);
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
+  return Geometry::NewInstance(env, external);
+}
+
+
+/**
+ * Construct a Polygon from interleaved coordinates.
+ * info[0] : Float64Array - coords
+ * info[1] : Uint32Array - ring offsets (optional, default: single ring)
+ * info[2] : int32 - dims (optional, default 2)
+ */
+Napi::Value CreatePolygon(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("GEOS::createPolygon");
+  Context* context = GetContext();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: coords").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  const double* coords;
+  uint32_t ncoords;
+  int dims;
+
+  if (!GetFlatCoords(info, 2, &coords, &ncoords, &dims)) {
+    return env.Undefined();
+  }
+
+  const uint32_t shell[2] = { 0, ncoords };
+  const uint32_t* ringOffsets = shell;
+  uint32_t length = 2;
+
+  if (info.Length() > 1 && !info[1].IsUndefined()) {
+    if (!GetOffsets(info, 1, "ringOffsets", &ringOffsets, &length, ncoords)) {
+      return env.Undefined();
+    }
+  }
+
+  GEOSGeometry *geometry = PolygonFromFlat(context->handle, coords, ringOffsets, length - 1, dims);
+
+  if (geometry == NULL) {
+    Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
+  return Geometry::NewInstance(env, external);
+}
+
+
+/**
+ * Construct a MultiLineString from interleaved coordinates.
+ * info[0] : Float64Array - coords
+ * info[1] : Uint32Array - line offsets
+ * info[2] : int32 - dims (optional, default 2)
+ */
+Napi::Value CreateMultiLineString(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("GEOS::createMultiLineString");
+  Context* context = GetContext();
+  GEOSContextHandle_t handle = context->handle;
+
+  if (info.Length() < 2) {
+    Napi::Error::New(env, "Missing argument(s): coords, ringOffsets").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  const double* coords;
+  uint32_t ncoords;
+  int dims;
+  const uint32_t* ringOffsets;
+  uint32_t length;
+
+  if (!GetFlatCoords(info, 2, &coords, &ncoords, &dims)) {
+    return env.Undefined();
+  }
+
+  if (!GetOffsets(info, 1, "ringOffsets", &ringOffsets, &length, ncoords)) {
+    return env.Undefined();
+  }
+
+  uint32_t ngeoms = length - 1;
+  GEOSGeometry** geoms = (GEOSGeometry**)malloc(ngeoms * sizeof(GEOSGeometry*));
+
+  for (uint32_t i = 0; i < ngeoms; i++) {
+    uint32_t size = ringOffsets[i + 1] - ringOffsets[i];
+    GEOSCoordSequence* cs = CoordSeqFromFlat(handle, coords + ringOffsets[i] * dims, size, dims);
+    geoms[i] = GEOSGeom_createLineString_r(handle, cs);
+
+    if (geoms[i] == NULL) {
+      for (uint32_t j = 0; j < i; j++) GEOSGeom_destroy_r(handle, geoms[j]);
+      free(geoms);
+      Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+  }
+
+  GEOSGeometry* geometry = GEOSGeom_createCollection_r(handle, GEOS_MULTILINESTRING, geoms, ngeoms);
+  free(geoms);
+
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
+  return Geometry::NewInstance(env, external);
+}
+
+
+/**
+ * Construct a MultiPolygon from interleaved coordinates.
+ * info[0] : Float64Array - coords
+ * info[1] : Uint32Array - ring offsets
+ * info[2] : Uint32Array - polygon offsets (into rings)
+ * info[3] : int32 - dims (optional, default 2)
+ */
+Napi::Value CreateMultiPolygon(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("GEOS::createMultiPolygon");
+  Context* context = GetContext();
+  GEOSContextHandle_t handle = context->handle;
+
+  if (info.Length() < 3) {
+    Napi::Error::New(env, "Missing argument(s): coords, ringOffsets, partOffsets").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  const double* coords;
+  uint32_t ncoords;
+  int dims;
+  const uint32_t* ringOffsets;
+  uint32_t nringOffsets;
+  const uint32_t* partOffsets;
+  uint32_t npartOffsets;
+
+  if (!GetFlatCoords(info, 3, &coords, &ncoords, &dims)) {
+    return env.Undefined();
+  }
+
+  if (!GetOffsets(info, 1, "ringOffsets", &ringOffsets, &nringOffsets, ncoords)) {
+    return env.Undefined();
+  }
+
+  if (!GetOffsets(info, 2, "partOffsets", &partOffsets, &npartOffsets, nringOffsets - 1)) {
+    return env.Undefined();
+  }
+
+  uint32_t ngeoms = npartOffsets - 1;
+  GEOSGeometry** geoms = (GEOSGeometry**)malloc(ngeoms * sizeof(GEOSGeometry*));
+
+  for (uint32_t i = 0; i < ngeoms; i++) {
+    uint32_t nrings = partOffsets[i + 1] - partOffsets[i];
+    geoms[i] = PolygonFromFlat(handle, coords, ringOffsets + partOffsets[i], nrings, dims);
+
+    if (geoms[i] == NULL) {
+      for (uint32_t j = 0; j < i; j++) GEOSGeom_destroy_r(handle, geoms[j]);
+      free(geoms);
+      Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+  }
+
+  GEOSGeometry* geometry = GEOSGeom_createCollection_r(handle, GEOS_MULTIPOLYGON, geoms, ngeoms);
+  free(geoms);
+
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
   Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
   return Geometry::NewInstance(env, external);
 }
@@ -149,6 +569,8 @@ Napi::Value CreateLineString(const Napi::CallbackInfo& info) {
  */
 Napi::Value CreatePoint(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  StatsScope stats("GEOS::createPoint");
+  GEOSContextHandle_t handle = GetContext()->handle;
 
   if (info.Length() < 2) {
     Napi::Error::New(env, "Missing argument(s): x, y").ThrowAsJavaScriptException();
@@ -167,7 +589,12 @@ Napi::Value CreatePoint(const Napi::CallbackInfo& info) {
 
   double x = info[0].As<Napi::Number>().DoubleValue();
   double y = info[1].As<Napi::Number>().DoubleValue();
-  GEOSGeometry *geometry = GEOSGeom_createPointFromXY(x, y);
+  GEOSGeometry *geometry = GEOSGeom_createPointFromXY_r(handle, x, y);
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
   Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
   return Geometry::NewInstance(env, external);
 }
@@ -179,6 +606,8 @@ Napi::Value CreatePoint(const Napi::CallbackInfo& info) {
  */
 Napi::Value CreateCollection(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  StatsScope stats("GEOS::createCollection");
+  GEOSContextHandle_t handle = GetContext()->handle;
 
   if (info.Length() < 1) {
     Napi::Error::New(env, "Missing argument: [Geometry]").ThrowAsJavaScriptException();
@@ -192,36 +621,447 @@ Napi::Value CreateCollection(const Napi::CallbackInfo& info) {
   for(int i = 0; i < ngeoms; i++) {
     Napi::Value value = input[i];
     // Throws "Error: Invalid argument" on non-Geometry object value:
-    Napi::ObjectWrap<Geometry>::Unwrap(value.As<Napi::Object>());
+    Geometry::Unwrap(value.As<Napi::Object>());
   }
 
   GEOSGeometry** geoms = (GEOSGeometry**)malloc(ngeoms * sizeof(GEOSGeometry*));
   for(int i = 0; i < ngeoms; i++) {
     Napi::Value value = input[i];
-    Geometry* geom = Napi::ObjectWrap<Geometry>::Unwrap(value.As<Napi::Object>());
+    Geometry* geom = Geometry::Unwrap(value.As<Napi::Object>());
 
     // Collection becomes owner of geometries, thus clone input geometries:
-    geoms[i] = GEOSGeom_clone(geom->geometry);
+    geoms[i] = GEOSGeom_clone_r(handle, geom->geometry);
   }
 
-  GEOSGeometry* geometry = GEOSGeom_createCollection(
+  GEOSGeometry* geometry = GEOSGeom_createCollection_r(
+    handle,
     GEOS_GEOMETRYCOLLECTION,
     geoms,
     ngeoms
   );
 
   free(geoms);
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
   Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
   return Geometry::NewInstance(env, external);
 }
 
+
+/**
+ * Construct an STRtree spatial index from geometries or envelopes.
+ * info[0] : [Geometry] | Float64Array - [minx, miny, maxx, maxy, ...]
+ * info[1] : int32 - node capacity (optional)
+ */
+Napi::Value CreateSpatialIndex(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("GEOS::createSpatialIndex");
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: [Geometry] | Float64Array").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info[0].IsTypedArray()) {
+    Napi::TypedArray array = info[0].As<Napi::TypedArray>();
+    if (array.TypedArrayType() != napi_float64_array || array.ElementLength() % 4 != 0) {
+      Napi::TypeError::New(env, "Invalid argument: Float64Array").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+  } else if (info[0].IsArray()) {
+    Napi::Array input = info[0].As<Napi::Array>();
+
+    // Check if we are dealing with geometries only:
+    for(uint32_t i = 0; i < input.Length(); i++) {
+      Napi::Value value = input[i];
+      // Throws "Error: Invalid argument" on non-Geometry object value:
+      Geometry::Unwrap(value.As<Napi::Object>());
+    }
+  } else {
+    Napi::TypeError::New(env, "Invalid argument: [Geometry] | Float64Array").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  int nodeCapacity = 10; // default
+  if (info.Length() > 1) {
+    if (!info[1].IsNumber()) {
+      Napi::TypeError::New(env, "Invalid argument: nodeCapacity").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    nodeCapacity = info[1].As<Napi::Number>().Int32Value();
+    if (nodeCapacity < 2) {
+      Napi::Error::New(env, "Invalid range: nodeCapacity").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+  }
+
+  return SpatialIndex::NewInstance(env, info[0], Napi::Number::New(env, nodeCapacity));
+}
+
+/**
+ * Return empty Pipeline; append ops and build() before apply().
+ */
+Napi::Value CreatePipeline(const Napi::CallbackInfo& info) {
+  return Pipeline::NewInstance(info.Env());
+}
+
+/**
+ * Read optional threads option; throws if present and not a positive number.
+ */
+static bool GetThreads(Napi::Env env, Napi::Object options, unsigned int* threads) {
+  if (!options.Has("threads")) return true;
+
+  Napi::Value value = options.Get("threads");
+  if (!value.IsNumber()) {
+    Napi::TypeError::New(env, "Invalid argument: threads").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  int32_t count = value.As<Napi::Number>().Int32Value();
+  if (count < 1) {
+    Napi::Error::New(env, "Invalid range: threads").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  *threads = count;
+  return true;
+}
+
+/**
+ * Union of all geometries on multiple threads; resolves to Geometry.
+ * info[0] : [Geometry]
+ * info[1] : Object - options (optional)
+ *   threads : Number - maximum number of threads (default: number of cores)
+ *   timeout : Number - milliseconds (optional)
+ *   signal : AbortSignal (optional)
+ */
+Napi::Value UnionAll(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: [Geometry]").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsArray()) {
+    Napi::TypeError::New(env, "Invalid argument: [Geometry]").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+
+  if (info.Length() > 1 && !info[1].IsUndefined()) {
+    if (!info[1].IsObject()) {
+      Napi::TypeError::New(env, "Invalid argument: options").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    Napi::Object options = info[1].As<Napi::Object>();
+    if (!GetThreads(env, options, &threads)) return env.Undefined();
+  }
+
+  Napi::Array input = info[0].As<Napi::Array>();
+
+  // Check if we are dealing with geometries only:
+  for (uint32_t i = 0; i < input.Length(); i++) {
+    Napi::Value value = input[i];
+    // Throws "Error: Invalid argument" on non-Geometry object value:
+    Geometry::Unwrap(value.As<Napi::Object>());
+  }
+
+  if (!Interrupt::Validate(info[1])) return env.Undefined();
+  GeometryWorker* worker = new UnionAllWorker(env, input, threads, info[1]);
+  return worker->Start();
+}
+
+/**
+ * Spatial join on multiple threads; resolves to matching index pairs
+ * { left: Uint32Array, right: Uint32Array }, i.e. left[k] predicate right[k].
+ * info[0] : [Geometry] - left
+ * info[1] : [Geometry] - right
+ * info[2] : Object - options (optional)
+ *   predicate : String - intersects (default) | contains | within | covers |
+ *     coveredBy | touches | crosses | overlaps
+ *   threads : Number - maximum number of threads (default: number of cores)
+ *   timeout : Number - milliseconds (optional)
+ *   signal : AbortSignal (optional)
+ */
+Napi::Value Join(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2) {
+    Napi::Error::New(env, "Missing argument(s): [Geometry], [Geometry]").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsArray() || !info[1].IsArray()) {
+    Napi::TypeError::New(env, "Invalid argument: [Geometry]").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  int predicate = JoinPredicate("intersects");
+  unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+
+  if (info.Length() > 2 && !info[2].IsUndefined()) {
+    if (!info[2].IsObject()) {
+      Napi::TypeError::New(env, "Invalid argument: options").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    Napi::Object options = info[2].As<Napi::Object>();
+    if (options.Has("predicate")) {
+      Napi::Value value = options.Get("predicate");
+      predicate = value.IsString() ? JoinPredicate(value.As<Napi::String>().Utf8Value()) : -1;
+      if (predicate == -1) {
+        Napi::TypeError::New(env, "Invalid argument: predicate").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+    }
+
+    if (!GetThreads(env, options, &threads)) return env.Undefined();
+  }
+
+  Napi::Array left = info[0].As<Napi::Array>();
+  Napi::Array right = info[1].As<Napi::Array>();
+
+  // Check if we are dealing with geometries only:
+  for (uint32_t i = 0; i < left.Length(); i++) Geometry::Unwrap(left.Get(i).As<Napi::Object>());
+  for (uint32_t i = 0; i < right.Length(); i++) Geometry::Unwrap(right.Get(i).As<Napi::Object>());
+
+  if (!Interrupt::Validate(info[2])) return env.Undefined();
+  JoinWorker* worker = new JoinWorker(env, left, right, predicate, threads, info[2]);
+  return worker->Start();
+}
+
+
+/**
+ * Simplify all geometries for each tolerance on multiple threads; each
+ * level is simplified from the previous one. Resolves to one level per
+ * tolerance: { tolerance, wkb: Buffer, offsets: Uint32Array } or
+ * { tolerance, coords, dims, ringOffsets, partOffsets, geomOffsets }.
+ * info[0] : [Geometry]
+ * info[1] : Float64Array | [Number] - ascending tolerances
+ * info[2] : Object - options (optional)
+ *   preserveTopology : Boolean - topology preserving simplifier (default true)
+ *   format : String - 'wkb' (default) | 'flat'
+ *   threads : Number - maximum number of threads (default: number of cores)
+ *   timeout : Number - milliseconds (optional)
+ *   signal : AbortSignal (optional)
+ */
+Napi::Value BuildLOD(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2) {
+    Napi::Error::New(env, "Missing argument(s): [Geometry], tolerances").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsArray()) {
+    Napi::TypeError::New(env, "Invalid argument: [Geometry]").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::vector<double> tolerances;
+  const double* data;
+  uint32_t length;
+
+  if (GetFloat64Array(info[1], &data, &length)) {
+    tolerances.assign(data, data + length);
+  } else if (info[1].IsArray()) {
+    Napi::Array array = info[1].As<Napi::Array>();
+    for (uint32_t i = 0; i < array.Length(); i++) {
+      Napi::Value value = array[i];
+      if (!value.IsNumber()) {
+        Napi::TypeError::New(env, "Invalid argument: tolerances").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+
+      tolerances.push_back(value.As<Napi::Number>().DoubleValue());
+    }
+  } else {
+    Napi::TypeError::New(env, "Invalid argument: tolerances").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // Levels are built from each other, i.e. finest first:
+  for (size_t i = 0; i < tolerances.size(); i++) {
+    if (!(tolerances[i] >= 0) || (i > 0 && tolerances[i] < tolerances[i - 1])) {
+      Napi::Error::New(env, "Invalid range: tolerances").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+  }
+
+  bool preserveTopology = true;
+  bool flat = false;
+  unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+
+  if (info.Length() > 2 && !info[2].IsUndefined()) {
+    if (!info[2].IsObject()) {
+      Napi::TypeError::New(env, "Invalid argument: options").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    Napi::Object options = info[2].As<Napi::Object>();
+    if (options.Has("preserveTopology")) {
+      preserveTopology = options.Get("preserveTopology").ToBoolean().Value();
+    }
+
+    if (options.Has("format")) {
+      Napi::Value value = options.Get("format");
+      std::string format = value.IsString() ? value.As<Napi::String>().Utf8Value() : "";
+      if (format != "wkb" && format != "flat") {
+        Napi::TypeError::New(env, "Invalid argument: format").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+
+      flat = format == "flat";
+    }
+
+    if (!GetThreads(env, options, &threads)) return env.Undefined();
+  }
+
+  Napi::Array input = info[0].As<Napi::Array>();
+
+  // Check if we are dealing with geometries only:
+  for (uint32_t i = 0; i < input.Length(); i++) Geometry::Unwrap(input.Get(i).As<Napi::Object>());
+
+  if (!Interrupt::Validate(info[2])) return env.Undefined();
+  LODWorker* worker = new LODWorker(env, input, tolerances, preserveTopology, flat, threads, info[2]);
+  return worker->Start();
+}
+
+
+/**
+ * Open newline-delimited WKT or hex WKB file or stream for batched reading.
+ * Streams (Readable or other async iterable of Buffer/string chunks)
+ * are pulled on demand, i.e. only as far as the current batch requires.
+ * info[0] : String - path | Readable
+ * info[1] : Object - options (optional)
+ *   format : String - 'wkt' (default) | 'wkb'
+ *   batchSize : Number - geometries per batch (default 1024)
+ *   mmap : Boolean - memory-map input (default false; files only)
+ */
+Napi::Value CreateReader(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("GEOS::createReader");
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: path").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // Streams are consumed through their async iterator:
+  Napi::Value iterate = env.Undefined();
+  if (info[0].IsObject()) {
+    Napi::Value asyncIterator = env.Global().Get("Symbol").As<Napi::Object>().Get("asyncIterator");
+    if (asyncIterator.IsSymbol()) iterate = info[0].As<Napi::Object>().Get(asyncIterator);
+  }
+
+  if (!info[0].IsString() && !iterate.IsFunction()) {
+    Napi::TypeError::New(env, "Invalid argument: path").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  int format = READER_FORMAT_WKT;
+  uint32_t batchSize = 1024;
+  bool mmap = false;
+
+  if (info.Length() > 1 && !info[1].IsUndefined()) {
+    if (!info[1].IsObject()) {
+      Napi::TypeError::New(env, "Invalid argument: options").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    Napi::Object options = info[1].As<Napi::Object>();
+
+    if (options.Has("format")) {
+      std::string value = options.Get("format").ToString().Utf8Value();
+      if (value == "wkt") format = READER_FORMAT_WKT;
+      else if (value == "wkb") format = READER_FORMAT_WKB;
+      else {
+        Napi::TypeError::New(env, "Invalid argument: format").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+    }
+
+    if (options.Has("batchSize")) {
+      Napi::Value value = options.Get("batchSize");
+      if (!value.IsNumber()) {
+        Napi::TypeError::New(env, "Invalid argument: batchSize").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+
+      int32_t size = value.As<Napi::Number>().Int32Value();
+      if (size < 1) {
+        Napi::Error::New(env, "Invalid range: batchSize").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+
+      batchSize = size;
+    }
+
+    if (options.Has("mmap")) mmap = options.Get("mmap").ToBoolean();
+  }
+
+  if (iterate.IsFunction()) {
+    Napi::Value iterator = iterate.As<Napi::Function>().Call(info[0], {});
+    if (!iterator.IsObject()) {
+      Napi::TypeError::New(env, "Invalid argument: path").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    return Reader::NewInstance(
+      env,
+      Napi::External<LineSource>::New(env, LineSource::Create()),
+      Napi::Number::New(env, format),
+      Napi::Number::New(env, batchSize),
+      iterator
+    );
+  }
+
+  std::string path = info[0].As<Napi::String>().Utf8Value();
+  LineSource* source = LineSource::Open(path.c_str(), mmap);
+
+  if (source == NULL) {
+    Napi::Error::New(env, "Cannot open file: " + path).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  return Reader::NewInstance(
+    env,
+    Napi::External<LineSource>::New(env, source),
+    Napi::Number::New(env, format),
+    Napi::Number::New(env, batchSize),
+    env.Undefined()
+  );
+}
+
 /**
  *
  */
+static void DeleteInstanceData(napi_env env, void* data, void* hint) {
+  delete (InstanceData*)data;
+}
+
+/**
+ * Runs once per environment, i.e. for main thread and each worker thread.
+ */
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
-  initGEOS(notice_fn, error_fn);
+  if (napi_set_instance_data(env, new InstanceData(), DeleteInstanceData, NULL) != napi_ok) {
+    Napi::Error::New(env).ThrowAsJavaScriptException();
+    return exports;
+  }
 
   Geometry::Init(env, exports);
+  PreparedGeometry::Init(env, exports);
+  SpatialIndex::Init(env, exports);
+  Reader::Init(env, exports);
+  Dataset::Init(env, exports);
+  Pipeline::Init(env, exports);
 
   exports.Set("GEOS_JTS_PORT", Napi::String::New(env, GEOS_JTS_PORT));
   exports.Set("GEOS_VERSION", Napi::String::New(env, GEOS_VERSION));
@@ -236,12 +1076,34 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
 
   exports.Set("readWKT", Napi::Function::New(env, ReadWKT));
   exports.Set("writeWKT", Napi::Function::New(env, WriteWKT));
+  exports.Set("readWKB", Napi::Function::New(env, ReadWKB));
+  exports.Set("readHexWKB", Napi::Function::New(env, ReadHexWKB));
+  exports.Set("writeWKB", Napi::Function::New(env, WriteWKB));
+  exports.Set("readGeoJSON", Napi::Function::New(env, ReadGeoJSON));
+  exports.Set("writeGeoJSON", Napi::Function::New(env, WriteGeoJSON));
+  exports.Set("fromColumnar", Napi::Function::New(env, FromColumnar));
+  exports.Set("toColumnar", Napi::Function::New(env, ToColumnar));
+  exports.Set("fromShared", Napi::Function::New(env, FromShared));
   exports.Set("createLineString", Napi::Function::New(env, CreateLineString));
   exports.Set("createPoint", Napi::Function::New(env, CreatePoint));
+  exports.Set("createPolygon", Napi::Function::New(env, CreatePolygon));
+  exports.Set("createMultiLineString", Napi::Function::New(env, CreateMultiLineString));
+  exports.Set("createMultiPolygon", Napi::Function::New(env, CreateMultiPolygon));
   exports.Set("createCollection", Napi::Function::New(env, CreateCollection));
+  exports.Set("createSpatialIndex", Napi::Function::New(env, CreateSpatialIndex));
+  exports.Set("createReader", Napi::Function::New(env, CreateReader));
+  exports.Set("writeDataset", Napi::Function::New(env, WriteDataset));
+  exports.Set("openDataset", Napi::Function::New(env, OpenDataset));
+  exports.Set("unionAll", Napi::Function::New(env, UnionAll));
+  exports.Set("join", Napi::Function::New(env, Join));
+  exports.Set("buildLOD", Napi::Function::New(env, BuildLOD));
+  exports.Set("scope", Napi::Function::New(env, Scope));
+  exports.Set("pipeline", Napi::Function::New(env, CreatePipeline));
+
+  exports.Set("enableStats", Napi::Function::New(env, EnableStats));
+  exports.Set("stats", Napi::Function::New(env, GetStats));
+  exports.Set("resetStats", Napi::Function::New(env, ResetStats));
 
-  reader = GEOSWKTReader_create();
-  writer = GEOSWKTWriter_create();
   return exports;
 }
 
@@ -0,0 +1,367 @@
+#include <geos_c.h>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "columnar.h"
+#include "geometry.h"
+#include "coords.h"
+#include "context.h"
+#include "stats.h"
+
+static const struct {
+  const char* name;
+  int type;
+} columnTypes[] = {
+  { "Point", GEOS_POINT },
+  { "LineString", GEOS_LINESTRING },
+  { "Polygon", GEOS_POLYGON },
+  { "MultiPoint", GEOS_MULTIPOINT },
+  { "MultiLineString", GEOS_MULTILINESTRING },
+  { "MultiPolygon", GEOS_MULTIPOLYGON }
+};
+
+static const size_t NUM_COLUMN_TYPES = sizeof(columnTypes) / sizeof(columnTypes[0]);
+
+static const char* ColumnTypeName(int type) {
+  for (size_t i = 0; i < NUM_COLUMN_TYPES; i++) {
+    if (columnTypes[i].type == type) return columnTypes[i].name;
+  }
+  return NULL;
+}
+
+static int MultiType(int type) {
+  switch (type) {
+    case GEOS_POINT: return GEOS_MULTIPOINT;
+    case GEOS_LINESTRING: return GEOS_MULTILINESTRING;
+    default: return GEOS_MULTIPOLYGON;
+  }
+}
+
+/**
+ * Read offsets property; offsets must not exceed max.
+ */
+static bool GetOffsetsProperty(
+  Napi::Object input,
+  const char* name,
+  const uint32_t** offsets,
+  uint32_t* length,
+  uint32_t max
+) {
+  Napi::Env env = input.Env();
+
+  if (!GetUint32Array(input.Get(name), offsets, length)) {
+    Napi::TypeError::New(env, std::string("Invalid argument: ") + name).ThrowAsJavaScriptException();
+    return false;
+  }
+
+  if (!CheckOffsets(*offsets, *length, max)) {
+    Napi::Error::New(env, std::string("Invalid range: ") + name).ThrowAsJavaScriptException();
+    return false;
+  }
+
+  return true;
+}
+
+static GEOSGeometry* PointFromFlat(GEOSContextHandle_t handle, const double* coords, int dims) {
+  if (std::isnan(coords[0])) return GEOSGeom_createEmptyPoint_r(handle);
+  return GEOSGeom_createPoint_r(handle, CoordSeqFromFlat(handle, coords, 1, dims));
+}
+
+static GEOSGeometry* LineStringFromFlat(GEOSContextHandle_t handle, const double* coords, uint32_t size, int dims) {
+  if (size == 0) return GEOSGeom_createEmptyLineString_r(handle);
+  return GEOSGeom_createLineString_r(handle, CoordSeqFromFlat(handle, coords, size, dims));
+}
+
+/**
+ * Create collection of parts; NULL (all parts destroyed) if any part is NULL.
+ */
+static GEOSGeometry* Collect(GEOSContextHandle_t handle, int type, std::vector<GEOSGeometry*>& parts) {
+  for (size_t i = 0; i < parts.size(); i++) {
+    if (parts[i] != NULL) continue;
+    for (size_t j = 0; j < parts.size(); j++) {
+      if (parts[j] != NULL) GEOSGeom_destroy_r(handle, parts[j]);
+    }
+    return NULL;
+  }
+
+  return GEOSGeom_createCollection_r(handle, type, parts.data(), parts.size());
+}
+
+
+/**
+ * Construct geometries from columnar buffers in one call.
+ * info[0] : Object - { type, coords, geomOffsets, partOffsets, ringOffsets, dims }
+ *   type : String - Point | LineString | Polygon | MultiPoint | MultiLineString | MultiPolygon
+ *   coords : Float64Array - interleaved coordinates
+ *   geomOffsets, partOffsets, ringOffsets : Uint32Array - as required by type
+ *   dims : int32 - 2 or 3 (optional, default 2)
+ * returns [Geometry]
+ */
+Napi::Value FromColumnar(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("GEOS::fromColumnar");
+  Context* context = GetContext();
+  GEOSContextHandle_t handle = context->handle;
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: columns").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsObject()) {
+    Napi::TypeError::New(env, "Invalid argument: columns").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Object input = info[0].As<Napi::Object>();
+  Napi::Value typeValue = input.Get("type");
+  int type = -1;
+
+  if (typeValue.IsString()) {
+    std::string name = typeValue.As<Napi::String>().Utf8Value();
+    for (size_t i = 0; i < NUM_COLUMN_TYPES; i++) {
+      if (name == columnTypes[i].name) type = columnTypes[i].type;
+    }
+  }
+
+  if (type == -1) {
+    Napi::TypeError::New(env, "Invalid argument: type").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  int dims = 2;
+  Napi::Value dimsValue = input.Get("dims");
+  if (!dimsValue.IsUndefined()) {
+    dims = dimsValue.IsNumber() ? dimsValue.As<Napi::Number>().Int32Value() : 0;
+    if (dims != 2 && dims != 3) {
+      Napi::TypeError::New(env, "Invalid argument: dims").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+  }
+
+  const double* coords;
+  uint32_t length;
+
+  if (!GetFloat64Array(input.Get("coords"), &coords, &length)) {
+    Napi::TypeError::New(env, "Invalid argument: coords").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (length % dims != 0) {
+    Napi::Error::New(env, "Invalid range: coords").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  uint32_t ncoords = length / dims;
+
+  // Offsets are validated innermost first, each against the next level:
+  const uint32_t* ringOffsets = NULL;
+  const uint32_t* partOffsets = NULL;
+  const uint32_t* geomOffsets = NULL;
+  uint32_t nringOffsets = 0;
+  uint32_t npartOffsets = 0;
+  uint32_t ngeomOffsets = 0;
+  uint32_t max = ncoords;
+
+  if (type == GEOS_POLYGON || type == GEOS_MULTIPOLYGON) {
+    if (!GetOffsetsProperty(input, "ringOffsets", &ringOffsets, &nringOffsets, max)) return env.Undefined();
+    max = nringOffsets - 1;
+  }
+
+  if (type == GEOS_MULTILINESTRING || type == GEOS_MULTIPOLYGON) {
+    if (!GetOffsetsProperty(input, "partOffsets", &partOffsets, &npartOffsets, max)) return env.Undefined();
+    max = npartOffsets - 1;
+  }
+
+  if (type != GEOS_POINT) {
+    if (!GetOffsetsProperty(input, "geomOffsets", &geomOffsets, &ngeomOffsets, max)) return env.Undefined();
+  }
+
+  uint32_t count = type == GEOS_POINT ? ncoords : ngeomOffsets - 1;
+  std::vector<GEOSGeometry*> geometries(count, NULL);
+  context->last_error[0] = '\0';
+
+  for (uint32_t i = 0; i < count; i++) {
+    std::vector<GEOSGeometry*> parts;
+    uint32_t begin = type == GEOS_POINT ? i : geomOffsets[i];
+    uint32_t end = type == GEOS_POINT ? i + 1 : geomOffsets[i + 1];
+
+    switch (type) {
+      case GEOS_POINT:
+        geometries[i] = PointFromFlat(handle, coords + i * dims, dims);
+        break;
+      case GEOS_LINESTRING:
+        geometries[i] = LineStringFromFlat(handle, coords + begin * dims, end - begin, dims);
+        break;
+      case GEOS_POLYGON:
+        geometries[i] = PolygonFromFlat(handle, coords, ringOffsets + begin, end - begin, dims);
+        break;
+      case GEOS_MULTIPOINT:
+        for (uint32_t j = begin; j < end; j++) {
+          parts.push_back(PointFromFlat(handle, coords + j * dims, dims));
+        }
+        geometries[i] = Collect(handle, type, parts);
+        break;
+      case GEOS_MULTILINESTRING:
+        for (uint32_t j = begin; j < end; j++) {
+          uint32_t size = partOffsets[j + 1] - partOffsets[j];
+          parts.push_back(LineStringFromFlat(handle, coords + partOffsets[j] * dims, size, dims));
+        }
+        geometries[i] = Collect(handle, type, parts);
+        break;
+      case GEOS_MULTIPOLYGON:
+        for (uint32_t j = begin; j < end; j++) {
+          uint32_t nrings = partOffsets[j + 1] - partOffsets[j];
+          parts.push_back(PolygonFromFlat(handle, coords, ringOffsets + partOffsets[j], nrings, dims));
+        }
+        geometries[i] = Collect(handle, type, parts);
+        break;
+    }
+
+    if (geometries[i] == NULL) {
+      for (uint32_t j = 0; j < i; j++) GEOSGeom_destroy_r(handle, geometries[j]);
+      std::string message = "Invalid geometry at index " + std::to_string(i);
+      if (context->last_error[0]) message += std::string(": ") + context->last_error;
+      Napi::Error::New(env, message).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+  }
+
+  Napi::Array result = Napi::Array::New(env, count);
+  for (uint32_t i = 0; i < count; i++) {
+    Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometries[i]);
+    result.Set(i, Geometry::NewInstance(env, external));
+  }
+
+  return result;
+}
+
+
+static Napi::Uint32Array NewOffsets(Napi::Env env, const std::vector<uint32_t>& offsets) {
+  Napi::Uint32Array array = Napi::Uint32Array::New(env, offsets.size());
+  memcpy(array.Data(), offsets.data(), offsets.size() * sizeof(uint32_t));
+  return array;
+}
+
+/**
+ * Write geometries to columnar buffers in one call.
+ * All geometries must be of the same type; single geometries
+ * are promoted if mixed with their multi type.
+ * info[0] : [Geometry]
+ * returns { type, dims, coords, geomOffsets, partOffsets, ringOffsets }
+ */
+Napi::Value ToColumnar(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("GEOS::toColumnar");
+  GEOSContextHandle_t handle = GetContext()->handle;
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: [Geometry]").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsArray()) {
+    Napi::TypeError::New(env, "Invalid argument: [Geometry]").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Array input = info[0].As<Napi::Array>();
+  uint32_t count = input.Length();
+  std::vector<const GEOSGeometry*> geometries(count);
+
+  // Single type of batch: GEOS_POINT, GEOS_LINESTRING or GEOS_POLYGON, promoted to multi:
+  int base = -1;
+  bool multi = false;
+  int hasZ = 0;
+
+  for (uint32_t i = 0; i < count; i++) {
+    Napi::Value value = input[i];
+    geometries[i] = Geometry::Unwrap(value.As<Napi::Object>())->geometry;
+
+    int type = GEOSGeomTypeId_r(handle, geometries[i]);
+    switch (type) {
+      case GEOS_LINEARRING: type = GEOS_LINESTRING; break;
+      case GEOS_MULTIPOINT: type = GEOS_POINT; multi = true; break;
+      case GEOS_MULTILINESTRING: type = GEOS_LINESTRING; multi = true; break;
+      case GEOS_MULTIPOLYGON: type = GEOS_POLYGON; multi = true; break;
+    }
+
+    if (type == GEOS_GEOMETRYCOLLECTION || (base != -1 && type != base)) {
+      Napi::TypeError::New(env, "Invalid argument: mixed geometry types").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    base = type;
+    if (GEOSHasZ_r(handle, geometries[i]) == 1) hasZ = 1;
+  }
+
+  int type = base == -1 ? GEOS_POINT : base;
+  if (multi) type = MultiType(base);
+  int dims = hasZ ? 3 : 2;
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("type", Napi::String::New(env, ColumnTypeName(type)));
+  result.Set("dims", Napi::Number::New(env, dims));
+
+  if (type == GEOS_POINT) {
+    Napi::Float64Array coords = Napi::Float64Array::New(env, count * dims);
+    for (uint32_t i = 0; i < count; i++) {
+      double* xyz = coords.Data() + i * dims;
+      if (GEOSisEmpty_r(handle, geometries[i])) {
+        for (int d = 0; d < dims; d++) xyz[d] = NAN;
+      } else {
+        GEOSCoordSeq_copyToBuffer_r(handle, GEOSGeom_getCoordSeq_r(handle, geometries[i]), xyz, hasZ, 0);
+      }
+    }
+
+    result.Set("coords", coords);
+    return result;
+  }
+
+  FlatCounts counts = { 0, 0, 0 };
+  for (uint32_t i = 0; i < count; i++) CountFlat(handle, geometries[i], &counts);
+
+  // Flat layout is written for all geometries at once;
+  // columnar offsets are flat offsets at the level required by type:
+  Napi::Float64Array coords = Napi::Float64Array::New(env, counts.coords * dims);
+  std::vector<uint32_t> ringOffsets(counts.rings + 1);
+  std::vector<uint32_t> partOffsets(counts.parts + 1);
+  std::vector<uint32_t> geomOffsets(count + 1);
+  FlatBuffers buffers = { coords.Data(), ringOffsets.data(), partOffsets.data(), hasZ, 0, 0, 0 };
+  ringOffsets[0] = partOffsets[0] = geomOffsets[0] = 0;
+
+  for (uint32_t i = 0; i < count; i++) {
+    WriteFlat(handle, geometries[i], &buffers);
+    switch (type) {
+      case GEOS_LINESTRING:
+      case GEOS_MULTIPOINT:
+        geomOffsets[i + 1] = buffers.coord;
+        break;
+      case GEOS_POLYGON:
+        geomOffsets[i + 1] = buffers.ring;
+        break;
+      default:
+        geomOffsets[i + 1] = buffers.part;
+        break;
+    }
+  }
+
+  result.Set("coords", coords);
+  result.Set("geomOffsets", NewOffsets(env, geomOffsets));
+
+  switch (type) {
+    case GEOS_POLYGON:
+      result.Set("ringOffsets", NewOffsets(env, ringOffsets));
+      break;
+    case GEOS_MULTILINESTRING:
+      // Lines are flat rings:
+      result.Set("partOffsets", NewOffsets(env, ringOffsets));
+      break;
+    case GEOS_MULTIPOLYGON:
+      result.Set("partOffsets", NewOffsets(env, partOffsets));
+      result.Set("ringOffsets", NewOffsets(env, ringOffsets));
+      break;
+  }
+
+  return result;
+}
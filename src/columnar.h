@@ -0,0 +1,22 @@
+#ifndef __COLUMNAR_H
+#define __COLUMNAR_H
+
+#include <napi.h>
+
+/**
+ * GeoArrow-style columnar batches: one geometry type per batch,
+ * interleaved coordinates and nested offset arrays:
+ *
+ *   Point            coords
+ *   LineString       geomOffsets -> coords
+ *   MultiPoint       geomOffsets -> coords
+ *   Polygon          geomOffsets -> ringOffsets -> coords
+ *   MultiLineString  geomOffsets -> partOffsets -> coords
+ *   MultiPolygon     geomOffsets -> partOffsets -> ringOffsets -> coords
+ *
+ * Empty points are encoded as NaN coordinates.
+ */
+Napi::Value FromColumnar(const Napi::CallbackInfo& info);
+Napi::Value ToColumnar(const Napi::CallbackInfo& info);
+
+#endif /* __COLUMNAR_H */
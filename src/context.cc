@@ -0,0 +1,42 @@
+#include <cstdio>
+#include "context.h"
+#include "interrupt.h"
+
+static void notice_fn(const char *message, void *userdata) {
+  fprintf(stdout, "NOTICE: %s\n", message);
+}
+
+static void error_fn(const char *message, void *userdata) {
+  Context* context = (Context*)userdata;
+  snprintf(context->last_error, sizeof(context->last_error), "%s", message);
+}
+
+Context::Context() {
+  this->last_error[0] = '\0';
+  this->handle = GEOS_init_r();
+  GEOSContext_setNoticeMessageHandler_r(this->handle, notice_fn, this);
+  GEOSContext_setErrorMessageHandler_r(this->handle, error_fn, this);
+  InitInterrupts(this->handle);
+  this->reader = GEOSWKTReader_create_r(this->handle);
+  this->writer = GEOSWKTWriter_create_r(this->handle);
+  this->wkbReader = GEOSWKBReader_create_r(this->handle);
+  this->wkbWriter = GEOSWKBWriter_create_r(this->handle);
+  this->geojsonReader = GEOSGeoJSONReader_create_r(this->handle);
+
+  // Write Z when present (default: 2D only):
+  GEOSWKBWriter_setOutputDimension_r(this->handle, this->wkbWriter, 3);
+}
+
+Context::~Context() {
+  GEOSWKTReader_destroy_r(this->handle, this->reader);
+  GEOSWKTWriter_destroy_r(this->handle, this->writer);
+  GEOSWKBReader_destroy_r(this->handle, this->wkbReader);
+  GEOSWKBWriter_destroy_r(this->handle, this->wkbWriter);
+  GEOSGeoJSONReader_destroy_r(this->handle, this->geojsonReader);
+  GEOS_finish_r(this->handle);
+}
+
+Context* GetContext() {
+  thread_local Context context;
+  return &context;
+}
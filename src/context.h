@@ -0,0 +1,36 @@
+#ifndef __CONTEXT_H
+#define __CONTEXT_H
+
+#include <geos_c.h>
+
+// Coordinate buffer copies, GeoJSON reader/writer and prepared distance:
+#if GEOS_VERSION_MAJOR < 3 || (GEOS_VERSION_MAJOR == 3 && GEOS_VERSION_MINOR < 10)
+#error "GEOS 3.10 or later is required"
+#endif
+
+/**
+ * Per-thread GEOS state: reentrant context handle,
+ * WKT/WKB/GeoJSON readers and writers and last error message.
+ */
+struct Context {
+  GEOSContextHandle_t handle;
+  GEOSWKTReader *reader;
+  GEOSWKTWriter *writer;
+  GEOSWKBReader *wkbReader;
+  GEOSWKBWriter *wkbWriter;
+  GEOSGeoJSONReader *geojsonReader;
+  char last_error[256];
+
+  Context();
+  ~Context();
+  Context(const Context&) = delete;
+  Context& operator=(const Context&) = delete;
+};
+
+/**
+ * Context of calling thread; created on first use,
+ * destroyed on thread exit.
+ */
+Context* GetContext();
+
+#endif /* __CONTEXT_H */
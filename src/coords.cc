@@ -0,0 +1,161 @@
+#include <vector>
+#include "coords.h"
+
+static uint32_t CoordSeqSize(GEOSContextHandle_t handle, const GEOSGeometry* g) {
+  unsigned int size = 0;
+  const GEOSCoordSequence* cs = GEOSGeom_getCoordSeq_r(handle, g);
+  if (cs != NULL) GEOSCoordSeq_getSize_r(handle, cs, &size);
+  return size;
+}
+
+/**
+ * Accumulate number of coordinates, rings and parts of geometry.
+ */
+void CountFlat(GEOSContextHandle_t handle, const GEOSGeometry* g, FlatCounts* counts) {
+  int type = GEOSGeomTypeId_r(handle, g);
+  int n;
+
+  switch (type) {
+    case GEOS_POINT:
+    case GEOS_LINESTRING:
+    case GEOS_LINEARRING:
+      counts->coords += CoordSeqSize(handle, g);
+      counts->rings += 1;
+      counts->parts += 1;
+      break;
+    case GEOS_POLYGON:
+      counts->coords += CoordSeqSize(handle, GEOSGetExteriorRing_r(handle, g));
+      n = GEOSGetNumInteriorRings_r(handle, g);
+      for (int i = 0; i < n; i++) {
+        counts->coords += CoordSeqSize(handle, GEOSGetInteriorRingN_r(handle, g, i));
+      }
+      counts->rings += 1 + n;
+      counts->parts += 1;
+      break;
+    case GEOS_MULTIPOINT:
+    case GEOS_MULTILINESTRING:
+    case GEOS_MULTIPOLYGON:
+    case GEOS_GEOMETRYCOLLECTION:
+      n = GEOSGetNumGeometries_r(handle, g);
+      for (int i = 0; i < n; i++) {
+        CountFlat(handle, GEOSGetGeometryN_r(handle, g, i), counts);
+      }
+      break;
+  }
+}
+
+static void WriteRing(GEOSContextHandle_t handle, const GEOSGeometry* g, FlatBuffers* buffers) {
+  uint32_t size = CoordSeqSize(handle, g);
+
+  if (size > 0) {
+    double* coords = buffers->coords + buffers->coord * (buffers->hasZ ? 3 : 2);
+    GEOSCoordSeq_copyToBuffer_r(handle, GEOSGeom_getCoordSeq_r(handle, g), coords, buffers->hasZ, 0);
+  }
+
+  buffers->coord += size;
+  buffers->ringOffsets[++buffers->ring] = buffers->coord;
+}
+
+/**
+ * Write coordinates and offsets of geometry; buffers are sized by CountFlat().
+ */
+void WriteFlat(GEOSContextHandle_t handle, const GEOSGeometry* g, FlatBuffers* buffers) {
+  int type = GEOSGeomTypeId_r(handle, g);
+  int n;
+
+  switch (type) {
+    case GEOS_POINT:
+    case GEOS_LINESTRING:
+    case GEOS_LINEARRING:
+      WriteRing(handle, g, buffers);
+      buffers->partOffsets[++buffers->part] = buffers->ring;
+      break;
+    case GEOS_POLYGON:
+      WriteRing(handle, GEOSGetExteriorRing_r(handle, g), buffers);
+      n = GEOSGetNumInteriorRings_r(handle, g);
+      for (int i = 0; i < n; i++) {
+        WriteRing(handle, GEOSGetInteriorRingN_r(handle, g, i), buffers);
+      }
+      buffers->partOffsets[++buffers->part] = buffers->ring;
+      break;
+    case GEOS_MULTIPOINT:
+    case GEOS_MULTILINESTRING:
+    case GEOS_MULTIPOLYGON:
+    case GEOS_GEOMETRYCOLLECTION:
+      n = GEOSGetNumGeometries_r(handle, g);
+      for (int i = 0; i < n; i++) {
+        WriteFlat(handle, GEOSGetGeometryN_r(handle, g, i), buffers);
+      }
+      break;
+  }
+}
+
+/**
+ * Create coordinate sequence from interleaved x, y[, z] values.
+ */
+GEOSCoordSequence* CoordSeqFromFlat(GEOSContextHandle_t handle, const double* coords, uint32_t size, int dims) {
+  return GEOSCoordSeq_copyFromBuffer_r(handle, coords, size, dims > 2, 0);
+}
+
+/**
+ * Create polygon from shell and holes; NULL on invalid rings.
+ * ringOffsets has nrings + 1 elements.
+ */
+GEOSGeometry* PolygonFromFlat(
+  GEOSContextHandle_t handle,
+  const double* coords,
+  const uint32_t* ringOffsets,
+  uint32_t nrings,
+  int dims
+) {
+  if (nrings == 0) return GEOSGeom_createEmptyPolygon_r(handle);
+
+  std::vector<GEOSGeometry*> rings(nrings);
+  for (uint32_t i = 0; i < nrings; i++) {
+    uint32_t size = ringOffsets[i + 1] - ringOffsets[i];
+    GEOSCoordSequence* cs = CoordSeqFromFlat(handle, coords + ringOffsets[i] * dims, size, dims);
+
+    // Sequence is owned by ring, even on failure:
+    rings[i] = GEOSGeom_createLinearRing_r(handle, cs);
+
+    if (rings[i] == NULL) {
+      for (uint32_t j = 0; j < i; j++) GEOSGeom_destroy_r(handle, rings[j]);
+      return NULL;
+    }
+  }
+
+  return GEOSGeom_createPolygon_r(handle, rings[0], rings.data() + 1, nrings - 1);
+}
+
+bool GetFloat64Array(Napi::Value value, const double** data, uint32_t* length) {
+  if (!value.IsTypedArray()) return false;
+  if (value.As<Napi::TypedArray>().TypedArrayType() != napi_float64_array) return false;
+
+  Napi::Float64Array array = value.As<Napi::Float64Array>();
+  *data = array.Data();
+  *length = array.ElementLength();
+  return true;
+}
+
+bool GetUint32Array(Napi::Value value, const uint32_t** data, uint32_t* length) {
+  if (!value.IsTypedArray()) return false;
+  if (value.As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array) return false;
+
+  Napi::Uint32Array array = value.As<Napi::Uint32Array>();
+  *data = array.Data();
+  *length = array.ElementLength();
+  return true;
+}
+
+/**
+ * Offsets must be non-empty, non-decreasing and not exceed max.
+ */
+bool CheckOffsets(const uint32_t* offsets, uint32_t length, uint32_t max) {
+  if (length < 1) return false;
+
+  for (uint32_t i = 1; i < length; i++) {
+    if (offsets[i] < offsets[i - 1]) return false;
+  }
+
+  return offsets[length - 1] <= max;
+}
@@ -0,0 +1,50 @@
+#ifndef __COORDS_H
+#define __COORDS_H
+
+#include <napi.h>
+#include <geos_c.h>
+#include <stdint.h>
+
+/**
+ * Flat coordinate layout (see Geometry::getCoordinates()):
+ * each Point, LineString, LinearRing and Polygon is one part of one or
+ * more rings (i.e. rings, lines or points) of interleaved coordinates.
+ * Offset arrays have one more element than parts/rings; part i spans
+ * rings partOffsets[i] to partOffsets[i + 1], ring j spans coordinates
+ * ringOffsets[j] to ringOffsets[j + 1].
+ */
+struct FlatCounts {
+  uint32_t coords;
+  uint32_t rings;
+  uint32_t parts;
+};
+
+struct FlatBuffers {
+  double* coords;
+  uint32_t* ringOffsets;
+  uint32_t* partOffsets;
+  int hasZ;
+
+  // Current write positions:
+  uint32_t coord;
+  uint32_t ring;
+  uint32_t part;
+};
+
+void CountFlat(GEOSContextHandle_t handle, const GEOSGeometry* g, FlatCounts* counts);
+void WriteFlat(GEOSContextHandle_t handle, const GEOSGeometry* g, FlatBuffers* buffers);
+
+GEOSCoordSequence* CoordSeqFromFlat(GEOSContextHandle_t handle, const double* coords, uint32_t size, int dims);
+GEOSGeometry* PolygonFromFlat(
+  GEOSContextHandle_t handle,
+  const double* coords,
+  const uint32_t* ringOffsets,
+  uint32_t nrings,
+  int dims
+);
+
+bool GetFloat64Array(Napi::Value value, const double** data, uint32_t* length);
+bool GetUint32Array(Napi::Value value, const uint32_t** data, uint32_t* length);
+bool CheckOffsets(const uint32_t* offsets, uint32_t length, uint32_t max);
+
+#endif /* __COORDS_H */
@@ -0,0 +1,516 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "dataset.h"
+#include "instance.h"
+#include "geometry.h"
+#include "async.h"
+#include "context.h"
+#include "stats.h"
+#include "rtree.h"
+
+static const char DATASET_MAGIC[8] = { 'G', 'E', 'O', 'S', 'J', 'S', 'D', 'S' };
+static const uint32_t DATASET_VERSION = 1;
+static const uint32_t DEFAULT_NODE_SIZE = 16;
+
+struct DatasetLayout {
+  uint64_t offsets;
+  uint64_t envelopes;
+  uint64_t boxes;
+  uint64_t indices;
+  uint64_t data;
+};
+
+static DatasetLayout Layout(uint32_t count, uint32_t numNodes) {
+  DatasetLayout layout;
+  layout.offsets = sizeof(DatasetHeader);
+  layout.envelopes = layout.offsets + ((uint64_t)count + 1) * sizeof(uint64_t);
+  layout.boxes = layout.envelopes + (uint64_t)count * 4 * sizeof(double);
+  layout.indices = layout.boxes + (uint64_t)numNodes * 4 * sizeof(double);
+  layout.data = (layout.indices + (uint64_t)numNodes * sizeof(uint32_t) + 7) & ~(uint64_t)7;
+  return layout;
+}
+
+DatasetFile::DatasetFile() : map(NULL), length(0), header(NULL) {
+}
+
+DatasetFile::~DatasetFile() {
+  if (this->map == NULL) return;
+#ifndef _WIN32
+  munmap((void*)this->map, this->length);
+#else
+  free((void*)this->map);
+#endif
+}
+
+/**
+ * Map file read-only and shared, i.e. pages are shared through the
+ * page cache by all processes opening the same file.
+ */
+DatasetFile* DatasetFile::Open(const char* path, std::string& error) {
+  DatasetFile* file = new DatasetFile();
+
+#ifndef _WIN32
+  int fd = open(path, O_RDONLY);
+  if (fd == -1) {
+    error = std::string("Cannot open file: ") + path;
+    delete file;
+    return NULL;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    void* map = ::mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map != MAP_FAILED) {
+      madvise(map, st.st_size, MADV_RANDOM);
+      file->map = (const char*)map;
+      file->length = st.st_size;
+    }
+  }
+
+  close(fd);
+#else
+  // No memory-mapping: read whole file.
+  FILE* input = fopen(path, "rb");
+  if (input == NULL) {
+    error = std::string("Cannot open file: ") + path;
+    delete file;
+    return NULL;
+  }
+
+  fseek(input, 0, SEEK_END);
+  long size = ftell(input);
+  fseek(input, 0, SEEK_SET);
+
+  if (size > 0) {
+    char* buffer = (char*)malloc(size);
+    if (buffer != NULL && fread(buffer, 1, size, input) == (size_t)size) {
+      file->map = buffer;
+      file->length = size;
+    } else {
+      free(buffer);
+    }
+  }
+
+  fclose(input);
+#endif
+
+  if (file->map == NULL || !file->Validate()) {
+    error = std::string("Invalid dataset: ") + path;
+    delete file;
+    return NULL;
+  }
+
+  return file;
+}
+
+/**
+ * Check header, section bounds and tree structure,
+ * so that corrupt files cannot cause out-of-bounds reads.
+ */
+bool DatasetFile::Validate() {
+  if (this->length < sizeof(DatasetHeader)) return false;
+
+  const DatasetHeader* header = (const DatasetHeader*)this->map;
+  if (memcmp(header->magic, DATASET_MAGIC, sizeof(DATASET_MAGIC)) != 0) return false;
+  if (header->version != DATASET_VERSION || header->nodeSize < 2) return false;
+
+  uint32_t count = header->count;
+  std::vector<uint32_t> levelBounds;
+  uint32_t numNodes = PackedRTree::LevelBounds(count, header->nodeSize, levelBounds);
+  if (numNodes != header->numNodes) return false;
+
+  DatasetLayout layout = Layout(count, numNodes);
+  if (header->dataOffset != layout.data || layout.data > this->length) return false;
+
+  this->header = header;
+  this->offsets = (const uint64_t*)(this->map + layout.offsets);
+  this->envelopes = (const double*)(this->map + layout.envelopes);
+  this->boxes = (const double*)(this->map + layout.boxes);
+  this->indices = (const uint32_t*)(this->map + layout.indices);
+
+  if (this->offsets[count] > this->length - layout.data) return false;
+
+  // Leaves reference items, nodes reference (earlier) child nodes:
+  for (uint32_t i = 0; i < numNodes; i++) {
+    if (i < count ? this->indices[i] >= count : this->indices[i] >= i) return false;
+  }
+
+  this->tree.Assign(this->boxes, this->indices, count, header->nodeSize);
+  return true;
+}
+
+uint32_t DatasetFile::Count() {
+  return this->header->count;
+}
+
+const double* DatasetFile::ItemEnvelope(uint32_t i) {
+  return this->envelopes + i * 4;
+}
+
+/**
+ * Decode item from WKB; NULL on error.
+ */
+GEOSGeometry* DatasetFile::Read(GEOSContextHandle_t handle, GEOSWKBReader* reader, uint32_t i) {
+  uint64_t begin = this->offsets[i];
+  uint64_t end = this->offsets[i + 1];
+  if (begin > end || end > this->offsets[this->header->count]) return NULL;
+
+  const unsigned char* wkb = (const unsigned char*)(this->map + this->header->dataOffset + begin);
+  return GEOSWKBReader_read_r(handle, reader, wkb, end - begin);
+}
+
+void DatasetFile::Query(const double envelope[4], std::vector<uint32_t>& hits) {
+  this->tree.Query(envelope, hits);
+}
+
+
+Napi::Object Dataset::Init(Napi::Env env, Napi::Object exports) {
+  Napi::HandleScope scope(env);
+
+  Napi::Function func = DefineClass(env, "Dataset", {
+    InstanceMethod("getNumItems", &Dataset::GetNumItems),
+    InstanceMethod("get", &Dataset::Get),
+    InstanceMethod("getEnvelope", &Dataset::GetEnvelope),
+    InstanceMethod("query", &Dataset::Query),
+    InstanceMethod("close", &Dataset::Close)
+  });
+
+  GetInstanceData(env)->dataset = Napi::Persistent(func);
+  return exports;
+}
+
+Napi::Object Dataset::NewInstance(Napi::Env env, Napi::External<DatasetFile> file) {
+  Napi::EscapableHandleScope scope(env);
+  Napi::Object object = GetInstanceData(env)->dataset.New({ file });
+  return scope.Escape(napi_value(object)).ToObject();
+}
+
+/**
+ * info[0] : External<DatasetFile> - file (owned by Dataset)
+ */
+Dataset::Dataset(const Napi::CallbackInfo& info) : Napi::ObjectWrap<Dataset>(info) {
+  this->file = info[0].As<Napi::External<DatasetFile>>().Data();
+}
+
+Dataset::~Dataset() {
+  delete this->file;
+}
+
+bool Dataset::IsClosed(Napi::Env env) {
+  if (this->file != NULL) return false;
+  Napi::Error::New(env, "Dataset closed").ThrowAsJavaScriptException();
+  return true;
+}
+
+bool Dataset::GetIndex(const Napi::CallbackInfo& info, uint32_t* index) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: i").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  if (!info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Invalid argument: i").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  int64_t i = info[0].As<Napi::Number>().Int64Value();
+  if (i < 0 || i >= this->file->Count()) {
+    Napi::Error::New(env, "Invalid range: i").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  *index = (uint32_t)i;
+  return true;
+}
+
+
+Napi::Value Dataset::GetNumItems(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsClosed(env)) return env.Undefined();
+  return Napi::Number::New(env, this->file->Count());
+}
+
+/**
+ * Decode item i; every call returns a new Geometry.
+ * info[0] : uint32 - i
+ */
+Napi::Value Dataset::Get(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsClosed(env)) return env.Undefined();
+  StatsScope stats("Dataset::get");
+
+  uint32_t i;
+  if (!this->GetIndex(info, &i)) return env.Undefined();
+
+  Context* context = GetContext();
+  context->last_error[0] = '\0';
+  GEOSGeometry* geometry = this->file->Read(context->handle, context->wkbReader, i);
+
+  if (geometry == NULL) {
+    Napi::Error::New(env, context->last_error[0] ? context->last_error : "Invalid dataset item").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
+  return Geometry::NewInstance(env, external);
+}
+
+/**
+ * Stored envelope of item i, without decoding it.
+ * info[0] : uint32 - i
+ * returns Float64Array [minx, miny, maxx, maxy]
+ */
+Napi::Value Dataset::GetEnvelope(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsClosed(env)) return env.Undefined();
+
+  uint32_t i;
+  if (!this->GetIndex(info, &i)) return env.Undefined();
+
+  const double* envelope = this->file->ItemEnvelope(i);
+  Napi::Float64Array array = Napi::Float64Array::New(env, 4);
+  for (int k = 0; k < 4; k++) array[k] = envelope[k];
+  return array;
+}
+
+/**
+ * Return indexes of items whose envelopes intersect query envelope;
+ * in ascending order. See SpatialIndex::query().
+ * info[0] : Geometry | Float64Array - [minx, miny, maxx, maxy]
+ */
+Napi::Value Dataset::Query(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsClosed(env)) return env.Undefined();
+  StatsScope stats("Dataset::query");
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: Geometry | envelope").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::vector<uint32_t> hits;
+
+  if (info[0].IsTypedArray()) {
+    Napi::TypedArray array = info[0].As<Napi::TypedArray>();
+    if (array.TypedArrayType() != napi_float64_array || array.ElementLength() != 4) {
+      Napi::TypeError::New(env, "Invalid argument: envelope").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    this->file->Query(info[0].As<Napi::Float64Array>().Data(), hits);
+  } else {
+    // Throws "Error: Invalid argument" if not a Geometry object:
+    Geometry* geometry = Geometry::Unwrap(info[0].As<Napi::Object>());
+    const double* envelope = geometry->Envelope();
+    if (envelope != NULL) this->file->Query(envelope, hits);
+  }
+
+  std::sort(hits.begin(), hits.end());
+  Napi::Uint32Array result = Napi::Uint32Array::New(env, hits.size());
+  std::copy(hits.begin(), hits.end(), result.Data());
+  return result;
+}
+
+/**
+ * Unmap file; decoded geometries remain valid.
+ */
+Napi::Value Dataset::Close(const Napi::CallbackInfo& info) {
+  delete this->file;
+  this->file = NULL;
+  return info.Env().Undefined();
+}
+
+
+/**
+ * Write geometries to dataset file, see GEOS::openDataset().
+ * info[0] : String - path
+ * info[1] : [Geometry]
+ * info[2] : Object - options (optional)
+ *   nodeSize : Number - R-tree node size (default: 16)
+ */
+Napi::Value WriteDataset(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("GEOS::writeDataset");
+  Context* context = GetContext();
+  GEOSContextHandle_t handle = context->handle;
+
+  if (info.Length() < 2) {
+    Napi::Error::New(env, "Missing argument(s): path, [Geometry]").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsString()) {
+    Napi::TypeError::New(env, "Invalid argument: path").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[1].IsArray()) {
+    Napi::TypeError::New(env, "Invalid argument: [Geometry]").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  uint32_t nodeSize = DEFAULT_NODE_SIZE;
+
+  if (info.Length() > 2 && !info[2].IsUndefined()) {
+    if (!info[2].IsObject()) {
+      Napi::TypeError::New(env, "Invalid argument: options").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    Napi::Value value = info[2].As<Napi::Object>().Get("nodeSize");
+    if (!value.IsUndefined()) {
+      if (!value.IsNumber()) {
+        Napi::TypeError::New(env, "Invalid argument: nodeSize").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+
+      int64_t n = value.As<Napi::Number>().Int64Value();
+      if (n < 2 || n > 65535) {
+        Napi::Error::New(env, "Invalid range: nodeSize").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+
+      nodeSize = (uint32_t)n;
+    }
+  }
+
+  std::string path = info[0].As<Napi::String>().Utf8Value();
+  Napi::Array input = info[1].As<Napi::Array>();
+  uint32_t count = input.Length();
+  std::vector<const GEOSGeometry*> geometries(count);
+  std::vector<double> envelopes(count * 4);
+
+  DatasetHeader header;
+  memcpy(header.magic, DATASET_MAGIC, sizeof(DATASET_MAGIC));
+  header.version = DATASET_VERSION;
+  header.nodeSize = nodeSize;
+  header.count = count;
+  header.bounds[0] = header.bounds[1] = INFINITY;
+  header.bounds[2] = header.bounds[3] = -INFINITY;
+
+  for (uint32_t i = 0; i < count; i++) {
+    Napi::Value value = input[i];
+    Geometry* geometry = Geometry::Unwrap(value.As<Napi::Object>());
+    geometries[i] = geometry->geometry;
+
+    // Empty geometries get an inverted envelope, matching no query:
+    const double* envelope = geometry->Envelope();
+    double* target = envelopes.data() + i * 4;
+    if (envelope == NULL) {
+      target[0] = target[1] = INFINITY;
+      target[2] = target[3] = -INFINITY;
+    } else {
+      memcpy(target, envelope, 4 * sizeof(double));
+    }
+
+    header.bounds[0] = std::min(header.bounds[0], target[0]);
+    header.bounds[1] = std::min(header.bounds[1], target[1]);
+    header.bounds[2] = std::max(header.bounds[2], target[2]);
+    header.bounds[3] = std::max(header.bounds[3], target[3]);
+  }
+
+  // Packed R-tree: leaves in Hilbert order, parents of nodeSize consecutive children:
+  std::vector<uint32_t> levelBounds;
+  uint32_t numNodes = PackedRTree::LevelBounds(count, nodeSize, levelBounds);
+  std::vector<double> boxes(numNodes * 4);
+  std::vector<uint32_t> indices(numNodes);
+  std::vector<uint32_t> order = HilbertOrder(handle, geometries);
+  PackedRTree::Pack(envelopes.data(), order, nodeSize, levelBounds, boxes.data(), indices.data());
+
+  DatasetLayout layout = Layout(count, numNodes);
+  header.numNodes = numNodes;
+  header.dataOffset = layout.data;
+
+  FILE* file = fopen(path.c_str(), "wb");
+  if (file == NULL) {
+    Napi::Error::New(env, "Cannot write file: " + path).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // Offsets are written last, once all WKB sizes are known:
+  std::vector<uint64_t> offsets(count + 1, 0);
+  const char padding[8] = { 0 };
+  uint64_t indicesEnd = layout.indices + (uint64_t)numNodes * sizeof(uint32_t);
+
+  bool ok =
+    fwrite(&header, sizeof(header), 1, file) == 1 &&
+    fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), file) == offsets.size() &&
+    fwrite(envelopes.data(), sizeof(double), envelopes.size(), file) == envelopes.size() &&
+    fwrite(boxes.data(), sizeof(double), boxes.size(), file) == boxes.size() &&
+    fwrite(indices.data(), sizeof(uint32_t), indices.size(), file) == indices.size() &&
+    fwrite(padding, 1, layout.data - indicesEnd, file) == layout.data - indicesEnd;
+
+  // Own writer: shared writer is configured per call by GEOS::writeWKB():
+  GEOSWKBWriter* writer = GEOSWKBWriter_create_r(handle);
+  GEOSWKBWriter_setOutputDimension_r(handle, writer, 3);
+  GEOSWKBWriter_setIncludeSRID_r(handle, writer, 1);
+  context->last_error[0] = '\0';
+
+  for (uint32_t i = 0; ok && i < count; i++) {
+    size_t size = 0;
+    unsigned char* wkb = GEOSWKBWriter_write_r(handle, writer, geometries[i], &size);
+    ok = wkb != NULL && fwrite(wkb, 1, size, file) == size;
+    if (wkb != NULL) GEOSFree_r(handle, wkb);
+    offsets[i + 1] = offsets[i] + size;
+  }
+
+  GEOSWKBWriter_destroy_r(handle, writer);
+
+  ok = ok &&
+    fseek(file, (long)layout.offsets, SEEK_SET) == 0 &&
+    fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), file) == offsets.size();
+
+  ok = fclose(file) == 0 && ok;
+
+  if (!ok) {
+    remove(path.c_str());
+    std::string message = "Cannot write file: " + path;
+    if (context->last_error[0]) message += std::string(": ") + context->last_error;
+    Napi::Error::New(env, message).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  return env.Undefined();
+}
+
+/**
+ * Open dataset file written by GEOS::writeDataset(); geometries
+ * are decoded on access, so opening is independent of dataset size.
+ * info[0] : String - path
+ */
+Napi::Value OpenDataset(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("GEOS::openDataset");
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: path").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsString()) {
+    Napi::TypeError::New(env, "Invalid argument: path").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::string path = info[0].As<Napi::String>().Utf8Value();
+  std::string error;
+  DatasetFile* file = DatasetFile::Open(path.c_str(), error);
+
+  if (file == NULL) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  return Dataset::NewInstance(env, Napi::External<DatasetFile>::New(env, file));
+}
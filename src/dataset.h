@@ -0,0 +1,84 @@
+#ifndef __DATASET_H
+#define __DATASET_H
+
+#include <napi.h>
+#include <geos_c.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "rtree.h"
+
+/**
+ * Dataset file layout (native byte order, sections 8-byte aligned):
+ *
+ *   header     DatasetHeader
+ *   offsets    uint64[count + 1] - WKB offsets relative to dataOffset
+ *   envelopes  double[count * 4] - per item, in item order
+ *   boxes      double[numNodes * 4] - packed Hilbert R-tree (see PackedRTree)
+ *   indices    uint32[numNodes] - leaf: item index; node: first child node
+ *   data       WKB (with SRID and Z)
+ */
+struct DatasetHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t nodeSize;
+  uint32_t count;
+  uint32_t numNodes;
+  uint64_t dataOffset;
+  double bounds[4];
+};
+
+/**
+ * Memory-mapped (read-only) dataset file; geometries are
+ * decoded from WKB on access only.
+ */
+class DatasetFile {
+ public:
+  // NULL with error set if file cannot be opened or is invalid:
+  static DatasetFile* Open(const char* path, std::string& error);
+  ~DatasetFile();
+
+  uint32_t Count();
+  const double* ItemEnvelope(uint32_t i);
+  GEOSGeometry* Read(GEOSContextHandle_t handle, GEOSWKBReader* reader, uint32_t i);
+
+  // Indexes of items whose envelopes intersect envelope:
+  void Query(const double envelope[4], std::vector<uint32_t>& hits);
+
+ private:
+  const char* map;
+  size_t length;
+  const DatasetHeader* header;
+  const uint64_t* offsets;
+  const double* envelopes;
+  const double* boxes;
+  const uint32_t* indices;
+  PackedRTree tree;
+
+  DatasetFile();
+  bool Validate();
+};
+
+class Dataset : public Napi::ObjectWrap<Dataset> {
+ public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+  static Napi::Object NewInstance(Napi::Env env, Napi::External<DatasetFile> file);
+  Dataset(const Napi::CallbackInfo& info);
+  ~Dataset();
+
+  Napi::Value GetNumItems(const Napi::CallbackInfo& info);
+  Napi::Value Get(const Napi::CallbackInfo& info);
+  Napi::Value GetEnvelope(const Napi::CallbackInfo& info);
+  Napi::Value Query(const Napi::CallbackInfo& info);
+  Napi::Value Close(const Napi::CallbackInfo& info);
+
+ private:
+  DatasetFile* file;
+  bool IsClosed(Napi::Env env);
+  bool GetIndex(const Napi::CallbackInfo& info, uint32_t* index);
+};
+
+Napi::Value WriteDataset(const Napi::CallbackInfo& info);
+Napi::Value OpenDataset(const Napi::CallbackInfo& info);
+
+#endif /* __DATASET_H */
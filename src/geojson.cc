@@ -0,0 +1,425 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "geojson.h"
+#include "geometry.h"
+#include "coords.h"
+#include "context.h"
+#include "stats.h"
+
+/**
+ * Owns geometries until handed over to a collection;
+ * releases them when an exception unwinds the stack.
+ */
+struct GeometryList {
+  GEOSContextHandle_t handle;
+  std::vector<GEOSGeometry*> geoms;
+
+  GeometryList(GEOSContextHandle_t handle) : handle(handle) {}
+
+  ~GeometryList() {
+    for (size_t i = 0; i < this->geoms.size(); i++) {
+      GEOSGeom_destroy_r(this->handle, this->geoms[i]);
+    }
+  }
+
+  GEOSGeometry* Collection(int type) {
+    GEOSGeometry* g = GEOSGeom_createCollection_r(this->handle, type, this->geoms.data(), this->geoms.size());
+    this->geoms.clear();
+    return g;
+  }
+};
+
+/**
+ * Interleaved x, y, z positions with ring offsets; z is NaN when missing.
+ */
+struct Positions {
+  std::vector<double> coords;
+  std::vector<uint32_t> ringOffsets;
+  bool hasZ;
+
+  Positions() : ringOffsets(1, 0), hasZ(false) {}
+
+  // Drop z values when no position has any:
+  int Compact() {
+    if (this->hasZ) return 3;
+    size_t n = this->coords.size() / 3;
+    for (size_t i = 0; i < n; i++) {
+      this->coords[i * 2] = this->coords[i * 3];
+      this->coords[i * 2 + 1] = this->coords[i * 3 + 1];
+    }
+    this->coords.resize(n * 2);
+    return 2;
+  }
+};
+
+static void InvalidGeoJSON(Napi::Env env) {
+  throw Napi::TypeError::New(env, "Invalid argument: GeoJSON");
+}
+
+static Napi::Array GetArray(Napi::Env env, Napi::Value value) {
+  if (!value.IsArray()) InvalidGeoJSON(env);
+  return value.As<Napi::Array>();
+}
+
+static void ReadPosition(Napi::Env env, Napi::Value value, Positions& positions) {
+  Napi::Array position = GetArray(env, value);
+  uint32_t length = position.Length();
+  if (length < 2) InvalidGeoJSON(env);
+
+  for (uint32_t i = 0; i < 3; i++) {
+    if (i == 2 && length < 3) {
+      positions.coords.push_back(NAN);
+      break;
+    }
+
+    Napi::Value coord = position.Get(i);
+    if (!coord.IsNumber()) InvalidGeoJSON(env);
+    positions.coords.push_back(coord.As<Napi::Number>().DoubleValue());
+  }
+
+  if (length > 2) positions.hasZ = true;
+}
+
+static void ReadRing(Napi::Env env, Napi::Value value, Positions& positions) {
+  Napi::Array ring = GetArray(env, value);
+  uint32_t length = ring.Length();
+  for (uint32_t i = 0; i < length; i++) ReadPosition(env, ring.Get(i), positions);
+  positions.ringOffsets.push_back(positions.coords.size() / 3);
+}
+
+static void ReadRings(Napi::Env env, Napi::Value value, Positions& positions) {
+  Napi::Array rings = GetArray(env, value);
+  uint32_t length = rings.Length();
+  for (uint32_t i = 0; i < length; i++) ReadRing(env, rings.Get(i), positions);
+}
+
+static GEOSGeometry* CheckResult(Napi::Env env, GEOSGeometry* g) {
+  if (g == NULL) throw Napi::Error::New(env, GetContext()->last_error);
+  return g;
+}
+
+static GEOSGeometry* PointFromPosition(Napi::Env env, GEOSContextHandle_t handle, Napi::Value value) {
+  if (GetArray(env, value).Length() == 0) return GEOSGeom_createEmptyPoint_r(handle);
+
+  Positions positions;
+  ReadPosition(env, value, positions);
+  int dims = positions.Compact();
+  GEOSCoordSequence* cs = CoordSeqFromFlat(handle, positions.coords.data(), 1, dims);
+  return CheckResult(env, GEOSGeom_createPoint_r(handle, cs));
+}
+
+static GEOSGeometry* LineStringFromPositions(Napi::Env env, GEOSContextHandle_t handle, Napi::Value value) {
+  Positions positions;
+  ReadRing(env, value, positions);
+  int dims = positions.Compact();
+  uint32_t size = positions.ringOffsets[1];
+  GEOSCoordSequence* cs = CoordSeqFromFlat(handle, positions.coords.data(), size, dims);
+  return CheckResult(env, GEOSGeom_createLineString_r(handle, cs));
+}
+
+static GEOSGeometry* PolygonFromPositions(Napi::Env env, GEOSContextHandle_t handle, Napi::Value value) {
+  Positions positions;
+  ReadRings(env, value, positions);
+  int dims = positions.Compact();
+  uint32_t nrings = positions.ringOffsets.size() - 1;
+  return CheckResult(env, PolygonFromFlat(handle, positions.coords.data(), positions.ringOffsets.data(), nrings, dims));
+}
+
+/**
+ * Construct geometry from GeoJSON object graph.
+ * Features yield their geometry (null: empty collection),
+ * feature collections a geometry collection.
+ */
+static GEOSGeometry* GeometryFromObject(Napi::Env env, GEOSContextHandle_t handle, Napi::Value value) {
+  if (!value.IsObject()) InvalidGeoJSON(env);
+  Napi::Object object = value.As<Napi::Object>();
+  Napi::Value typeValue = object.Get("type");
+  if (!typeValue.IsString()) InvalidGeoJSON(env);
+  std::string type = typeValue.As<Napi::String>().Utf8Value();
+
+  if (type == "Feature") {
+    Napi::Value geometry = object.Get("geometry");
+    if (geometry.IsNull()) return GEOSGeom_createEmptyCollection_r(handle, GEOS_GEOMETRYCOLLECTION);
+    return GeometryFromObject(env, handle, geometry);
+  }
+
+  if (type == "FeatureCollection" || type == "GeometryCollection") {
+    bool features = type == "FeatureCollection";
+    Napi::Array members = GetArray(env, object.Get(features ? "features" : "geometries"));
+    GeometryList list(handle);
+    for (uint32_t i = 0; i < members.Length(); i++) {
+      list.geoms.push_back(GeometryFromObject(env, handle, members.Get(i)));
+    }
+
+    return CheckResult(env, list.Collection(GEOS_GEOMETRYCOLLECTION));
+  }
+
+  Napi::Value coordinates = object.Get("coordinates");
+  if (type == "Point") return PointFromPosition(env, handle, coordinates);
+  if (type == "LineString") return LineStringFromPositions(env, handle, coordinates);
+  if (type == "Polygon") return PolygonFromPositions(env, handle, coordinates);
+
+  int collectionType;
+  GEOSGeometry* (*fn)(Napi::Env, GEOSContextHandle_t, Napi::Value);
+
+  if (type == "MultiPoint") {
+    collectionType = GEOS_MULTIPOINT;
+    fn = PointFromPosition;
+  } else if (type == "MultiLineString") {
+    collectionType = GEOS_MULTILINESTRING;
+    fn = LineStringFromPositions;
+  } else if (type == "MultiPolygon") {
+    collectionType = GEOS_MULTIPOLYGON;
+    fn = PolygonFromPositions;
+  } else {
+    InvalidGeoJSON(env);
+    return NULL;
+  }
+
+  Napi::Array members = GetArray(env, coordinates);
+  GeometryList list(handle);
+  for (uint32_t i = 0; i < members.Length(); i++) {
+    list.geoms.push_back(fn(env, handle, members.Get(i)));
+  }
+
+  return CheckResult(env, list.Collection(collectionType));
+}
+
+
+/**
+ * Parse GeoJSON returning a Geometry.
+ * Strings and Buffers are parsed natively; objects are walked directly.
+ * info[0] : String | Buffer | Object - GeoJSON geometry, feature or feature collection
+ */
+Napi::Value ReadGeoJSON(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("GEOS::readGeoJSON");
+  Context* context = GetContext();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: GeoJSON").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  GEOSGeometry* geometry;
+  context->last_error[0] = '\0';
+
+  if (info[0].IsString() || info[0].IsBuffer()) {
+    std::string json = info[0].IsString()
+      ? info[0].As<Napi::String>().Utf8Value()
+      : std::string(info[0].As<Napi::Buffer<char>>().Data(), info[0].As<Napi::Buffer<char>>().Length());
+
+    geometry = GEOSGeoJSONReader_readGeometry_r(context->handle, context->geojsonReader, json.c_str());
+
+    if (geometry == NULL) {
+      Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+  } else if (info[0].IsObject()) {
+    // Throws "TypeError: Invalid argument: GeoJSON" on malformed input:
+    geometry = GeometryFromObject(env, context->handle, info[0]);
+  } else {
+    Napi::TypeError::New(env, "Invalid argument: GeoJSON").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
+  return Geometry::NewInstance(env, external);
+}
+
+
+static void WriteNumber(double value, int precision, std::string& out) {
+  char buffer[32];
+
+  if (!std::isfinite(value)) {
+    out += "null";
+    return;
+  }
+
+  if (precision >= 0) {
+    int n = snprintf(buffer, sizeof(buffer), "%.*f", precision, value);
+
+    // Too long for fixed notation (huge magnitude or precision):
+    if (n < 0 || n >= (int)sizeof(buffer)) {
+      n = snprintf(buffer, sizeof(buffer), "%.17g", value);
+      out.append(buffer, n);
+      return;
+    }
+
+    // Strip trailing zeros and decimal point:
+    if (precision > 0) {
+      while (n > 0 && buffer[n - 1] == '0') n--;
+      if (n > 0 && buffer[n - 1] == '.') n--;
+    }
+
+    // Avoid "-0":
+    if (n == 2 && buffer[0] == '-' && buffer[1] == '0') {
+      out += '0';
+      return;
+    }
+
+    out.append(buffer, n);
+    return;
+  }
+
+  // Shortest of 15 or 17 significant digits which round-trips:
+  snprintf(buffer, sizeof(buffer), "%.15g", value);
+  if (strtod(buffer, NULL) != value) snprintf(buffer, sizeof(buffer), "%.17g", value);
+  out += buffer;
+}
+
+static void WriteCoordSeq(
+  GEOSContextHandle_t handle,
+  const GEOSGeometry* g,
+  int hasZ,
+  bool single,
+  int precision,
+  std::string& out
+) {
+  const GEOSCoordSequence* cs = GEOSGeom_getCoordSeq_r(handle, g);
+  unsigned int size = 0;
+  if (cs != NULL) GEOSCoordSeq_getSize_r(handle, cs, &size);
+
+  int dims = hasZ ? 3 : 2;
+  std::vector<double> coords(size * dims);
+  if (size > 0) GEOSCoordSeq_copyToBuffer_r(handle, cs, coords.data(), hasZ, 0);
+
+  if (!single) out += '[';
+  for (unsigned int i = 0; i < size; i++) {
+    if (i > 0) out += ',';
+    const double* coord = coords.data() + i * dims;
+    out += '[';
+    WriteNumber(coord[0], precision, out);
+    out += ',';
+    WriteNumber(coord[1], precision, out);
+    if (hasZ && !std::isnan(coord[2])) {
+      out += ',';
+      WriteNumber(coord[2], precision, out);
+    }
+    out += ']';
+  }
+  if (!single) out += ']';
+  if (single && size == 0) out += "[]";
+}
+
+static void WritePolygonRings(GEOSContextHandle_t handle, const GEOSGeometry* g, int hasZ, int precision, std::string& out) {
+  out += '[';
+  if (!GEOSisEmpty_r(handle, g)) {
+    WriteCoordSeq(handle, GEOSGetExteriorRing_r(handle, g), hasZ, false, precision, out);
+    int n = GEOSGetNumInteriorRings_r(handle, g);
+    for (int i = 0; i < n; i++) {
+      out += ',';
+      WriteCoordSeq(handle, GEOSGetInteriorRingN_r(handle, g, i), hasZ, false, precision, out);
+    }
+  }
+  out += ']';
+}
+
+/**
+ * Coordinates member of non-collection geometry.
+ */
+static void WriteCoordinates(GEOSContextHandle_t handle, const GEOSGeometry* g, int hasZ, int precision, std::string& out) {
+  switch (GEOSGeomTypeId_r(handle, g)) {
+    case GEOS_POINT:
+      WriteCoordSeq(handle, g, hasZ, true, precision, out);
+      break;
+    case GEOS_LINESTRING:
+    case GEOS_LINEARRING:
+      WriteCoordSeq(handle, g, hasZ, false, precision, out);
+      break;
+    case GEOS_POLYGON:
+      WritePolygonRings(handle, g, hasZ, precision, out);
+      break;
+  }
+}
+
+void WriteGeoJSONGeometry(GEOSContextHandle_t handle, const GEOSGeometry* g, int precision, std::string& out) {
+  int type = GEOSGeomTypeId_r(handle, g);
+  int hasZ = GEOSHasZ_r(handle, g) == 1;
+  int n;
+
+  switch (type) {
+    case GEOS_POINT:
+      out += "{\"type\":\"Point\",\"coordinates\":";
+      WriteCoordinates(handle, g, hasZ, precision, out);
+      break;
+    case GEOS_LINESTRING:
+    case GEOS_LINEARRING:
+      out += "{\"type\":\"LineString\",\"coordinates\":";
+      WriteCoordinates(handle, g, hasZ, precision, out);
+      break;
+    case GEOS_POLYGON:
+      out += "{\"type\":\"Polygon\",\"coordinates\":";
+      WriteCoordinates(handle, g, hasZ, precision, out);
+      break;
+    case GEOS_MULTIPOINT:
+    case GEOS_MULTILINESTRING:
+    case GEOS_MULTIPOLYGON:
+      out += type == GEOS_MULTIPOINT
+        ? "{\"type\":\"MultiPoint\",\"coordinates\":["
+        : type == GEOS_MULTILINESTRING
+          ? "{\"type\":\"MultiLineString\",\"coordinates\":["
+          : "{\"type\":\"MultiPolygon\",\"coordinates\":[";
+      n = GEOSGetNumGeometries_r(handle, g);
+      for (int i = 0; i < n; i++) {
+        if (i > 0) out += ',';
+        WriteCoordinates(handle, GEOSGetGeometryN_r(handle, g, i), hasZ, precision, out);
+      }
+      out += ']';
+      break;
+    case GEOS_GEOMETRYCOLLECTION:
+      out += "{\"type\":\"GeometryCollection\",\"geometries\":[";
+      n = GEOSGetNumGeometries_r(handle, g);
+      for (int i = 0; i < n; i++) {
+        if (i > 0) out += ',';
+        WriteGeoJSONGeometry(handle, GEOSGetGeometryN_r(handle, g, i), precision, out);
+      }
+      out += ']';
+      break;
+  }
+
+  out += '}';
+}
+
+/**
+ * Returns GeoJSON geometry string for the given Geometry.
+ * info[0] : Geometry
+ * info[1] : int32 - decimal places, 0 - 17 (optional; default: round-trip precision)
+ */
+Napi::Value WriteGeoJSON(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("GEOS::writeGeoJSON");
+  GEOSContextHandle_t handle = GetContext()->handle;
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: Geometry").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsObject()) {
+    Napi::TypeError::New(env, "Invalid argument: Geometry").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  int precision = -1;
+  if (info.Length() > 1 && !info[1].IsUndefined()) {
+    if (!info[1].IsNumber()) {
+      Napi::TypeError::New(env, "Invalid argument: precision").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    precision = info[1].As<Napi::Number>().Int32Value();
+    if (precision < 0 || precision > 17) {
+      Napi::Error::New(env, "Invalid range: precision").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+  }
+
+  // Throws "Error: Invalid argument" if not a Geometry object:
+  Geometry* geometry = Geometry::Unwrap(info[0].As<Napi::Object>());
+  std::string out;
+  WriteGeoJSONGeometry(handle, geometry->geometry, precision, out);
+  return Napi::String::New(env, out);
+}
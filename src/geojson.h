@@ -0,0 +1,17 @@
+#ifndef __GEOJSON_H
+#define __GEOJSON_H
+
+#include <napi.h>
+#include <geos_c.h>
+#include <string>
+
+Napi::Value ReadGeoJSON(const Napi::CallbackInfo& info);
+Napi::Value WriteGeoJSON(const Napi::CallbackInfo& info);
+
+/**
+ * Append GeoJSON geometry object to output;
+ * precision < 0 writes shortest round-trip representation.
+ */
+void WriteGeoJSONGeometry(GEOSContextHandle_t handle, const GEOSGeometry* g, int precision, std::string& out);
+
+#endif /* __GEOJSON_H */
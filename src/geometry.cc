@@ -1,12 +1,21 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
 #include "geometry.h"
+#include "instance.h"
+#include "context.h"
 #include "transform.h"
-
-Napi::FunctionReference Geometry::constructor;
+#include "prepared.h"
+#include "coords.h"
+#include "stats.h"
+#include "interrupt.h"
+#include "shared.h"
 
 Napi::Object Geometry::Init(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
 
   Napi::Function func = DefineClass(env, "Geometry", {
+    InstanceMethod("dispose", &Geometry::Dispose),
     InstanceMethod("getSRID", &Geometry::GetSRID),
     InstanceMethod("setSRID", &Geometry::SetSRID),
 
@@ -19,6 +28,9 @@ Napi::Object Geometry::Init(Napi::Env env, Napi::Object exports) {
     InstanceMethod("getY", &Geometry::GetY),
     InstanceMethod("getNumGeometries", &Geometry::GetNumGeometries),
     InstanceMethod("getGeometryN", &Geometry::GetGeometryN),
+    InstanceMethod("forEachGeometry", &Geometry::ForEachGeometry),
+    InstanceMethod("getCoordinates", &Geometry::GetCoordinates),
+    InstanceMethod("getEnvelope", &Geometry::GetEnvelope),
 
     InstanceMethod("difference", &Geometry::Difference),
     InstanceMethod("union", &Geometry::Union),
@@ -30,7 +42,29 @@ Napi::Object Geometry::Init(Napi::Env env, Napi::Object exports) {
     InstanceMethod("asValid", &Geometry::AsValid),
     InstanceMethod("interpolate", &Geometry::Interpolate),
     InstanceMethod("interpolateNormalized", &Geometry::InterpolateNormalized),
+    InstanceMethod("simplify", &Geometry::Simplify),
+    InstanceMethod("topologyPreservingSimplify", &Geometry::TopologyPreservingSimplify),
     InstanceMethod("transform", &Geometry::Transform),
+    InstanceMethod("transformBatch", &Geometry::TransformBatch),
+    InstanceMethod("affine", &Geometry::Affine),
+    InstanceMethod("translate", &Geometry::Translate),
+    InstanceMethod("scale", &Geometry::Scale),
+    InstanceMethod("rotate", &Geometry::Rotate),
+    InstanceMethod("prepare", &Geometry::Prepare),
+    InstanceMethod("toShared", &Geometry::ToShared),
+    InstanceMethod("distance", &Geometry::Distance),
+    InstanceMethod("hausdorffDistance", &Geometry::HausdorffDistance),
+    InstanceMethod("nearestPoints", &Geometry::NearestPoints),
+    InstanceMethod("isWithinDistance", &Geometry::IsWithinDistance),
+    InstanceMethod("distanceMany", &Geometry::DistanceMany),
+
+    // Asynchronous operations:
+    InstanceMethod("differenceAsync", &Geometry::DifferenceAsync),
+    InstanceMethod("unionAsync", &Geometry::UnionAsync),
+    InstanceMethod("intersectionAsync", &Geometry::IntersectionAsync),
+    InstanceMethod("convexHullAsync", &Geometry::ConvexHullAsync),
+    InstanceMethod("bufferAsync", &Geometry::BufferAsync),
+    InstanceMethod("asValidAsync", &Geometry::AsValidAsync),
 
     // Predicates:
     InstanceMethod("isValid", &Geometry::IsValid),
@@ -53,26 +87,200 @@ Napi::Object Geometry::Init(Napi::Env env, Napi::Object exports) {
     InstanceMethod("coveredBy", &Geometry::CoveredBy)
   });
 
-  constructor = Napi::Persistent(func);
-  constructor.SuppressDestruct();
+  // Support explicit resource management (`using`) where available:
+  Napi::Value dispose = env.Global().Get("Symbol").As<Napi::Object>().Get("dispose");
+  if (dispose.IsSymbol()) {
+    Napi::Object prototype = func.Get("prototype").As<Napi::Object>();
+    prototype.Set(dispose, prototype.Get("dispose"));
+  }
+
+  GetInstanceData(env)->geometry = Napi::Persistent(func);
   return exports;
 }
 
 Napi::Object Geometry::NewInstance(Napi::Env env, Napi::External<GEOSGeometry> geometry) {
   Napi::EscapableHandleScope scope(env);
-  Napi::Object object = constructor.New({ geometry });
+  Napi::Object object = GetInstanceData(env)->geometry.New({ geometry });
   return scope.Escape(napi_value(object)).ToObject();
 }
 
+/**
+ * Non-owning view of part of parent's geometry;
+ * parent is kept alive and pinned while view exists.
+ */
+Napi::Object Geometry::NewView(Napi::Env env, const GEOSGeometry* geometry, Napi::Object parent) {
+  Napi::EscapableHandleScope scope(env);
+  Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, (GEOSGeometry*)geometry);
+  Napi::Object object = GetInstanceData(env)->geometry.New({ external, parent });
+  return scope.Escape(napi_value(object)).ToObject();
+}
+
+bool Geometry::IsInstance(Napi::Value value) {
+  return value.IsObject() && value.As<Napi::Object>().InstanceOf(GetInstanceData(value.Env())->geometry.Value());
+}
+
+/**
+ * Unwrap Geometry object.
+ * Throws "Error: Invalid argument" if not a Geometry object,
+ * "Error: Geometry disposed" if disposed.
+ */
+Geometry* Geometry::Unwrap(Napi::Object object) {
+  Geometry* geometry = Napi::ObjectWrap<Geometry>::Unwrap(object);
+
+  if (geometry->geometry == NULL) {
+    throw Napi::Error::New(object.Env(), "Geometry disposed");
+  }
+
+  return geometry;
+}
+
+/**
+ * Rough estimate of GEOS heap usage: coordinates plus per-geometry overhead.
+ */
+static int64_t EstimateMemory(GEOSContextHandle_t handle, const GEOSGeometry* geometry) {
+  int64_t coords = GEOSGetNumCoordinates_r(handle, geometry);
+  int64_t dims = GEOSGeom_getCoordinateDimension_r(handle, geometry);
+  int64_t geoms = GEOSGetNumGeometries_r(handle, geometry);
+  return coords * dims * sizeof(double) + geoms * 128;
+}
+
 Geometry::Geometry(const Napi::CallbackInfo& info) : Napi::ObjectWrap<Geometry>(info) {
   Napi::Env env = info.Env();
   Napi::HandleScope scope(env);
+  GEOSContextHandle_t handle = GetContext()->handle;
   Napi::External<GEOSGeometry> external = info[0].As<Napi::External<GEOSGeometry>>();
   this->geometry = external.Data();
+  this->pins = std::make_shared<int>(0);
+  this->hasEnvelope = false;
+  this->owned = info.Length() < 2;
+
+  this->arena = NULL;
+  Arena* arena = CurrentArena(env);
+  if (arena != NULL) arena->Add(this);
+
+  if (!this->owned) {
+    Napi::Object parent = info[1].As<Napi::Object>();
+    this->parent = Napi::Persistent(parent);
+    this->parentPins = Geometry::Unwrap(parent)->Pin();
+    this->externalMemory = 0;
+    return;
+  }
+
+  // Guard against unchecked GEOS results; nothing to account for:
+  if (this->geometry == NULL) {
+    this->externalMemory = 0;
+    return;
+  }
+
+  this->externalMemory = EstimateMemory(handle, this->geometry);
+  Napi::MemoryManagement::AdjustExternalMemory(env, this->externalMemory);
+  StatsGeometryCreated();
 }
 
 Geometry::~Geometry() {
-  GEOSGeom_destroy(this->geometry);
+  this->Free(this->Env());
+}
+
+/**
+ * Release GEOS geometry and external memory accounting.
+ */
+void Geometry::Free(Napi::Env env) {
+  if (this->geometry == NULL) return;
+
+  GEOSGeometry* geometry = this->geometry;
+  this->geometry = NULL;
+  this->hasEnvelope = false;
+  if (this->arena != NULL) this->arena->Remove(this);
+
+  if (!this->owned) {
+    Geometry::Unpin(this->parentPins);
+    this->parentPins.reset();
+    this->parent.Reset();
+    return;
+  }
+
+  GEOSContextHandle_t handle = GetContext()->handle;
+  GEOSGeom_destroy_r(handle, geometry);
+  Napi::MemoryManagement::AdjustExternalMemory(env, -this->externalMemory);
+  StatsGeometryDestroyed();
+}
+
+/**
+ * Turn view into an independent copy (before mutation).
+ */
+void Geometry::Own(Napi::Env env) {
+  if (this->owned) return;
+
+  GEOSContextHandle_t handle = GetContext()->handle;
+  this->geometry = GEOSGeom_clone_r(handle, this->geometry);
+  Geometry::Unpin(this->parentPins);
+  this->parentPins.reset();
+  this->parent.Reset();
+  this->owned = true;
+  this->externalMemory = EstimateMemory(handle, this->geometry);
+  Napi::MemoryManagement::AdjustExternalMemory(env, this->externalMemory);
+  StatsGeometryCreated();
+}
+
+std::shared_ptr<int> Geometry::Pin() {
+  (*this->pins)++;
+  return this->pins;
+}
+
+void Geometry::Unpin(std::shared_ptr<int> pins) {
+  (*pins)--;
+}
+
+bool Geometry::IsPinned() {
+  return *this->pins > 0;
+}
+
+/**
+ * Throw "Error: Geometry disposed" when geometry was disposed.
+ */
+bool Geometry::IsDisposed(Napi::Env env) {
+  if (this->geometry != NULL) return false;
+
+  Napi::Error::New(env, "Geometry disposed").ThrowAsJavaScriptException();
+  return true;
+}
+
+
+/**
+ * Compute envelope on first use.
+ */
+const double* Geometry::Envelope() {
+  if (!this->hasEnvelope) {
+    GEOSContextHandle_t handle = GetContext()->handle;
+    this->isEmpty = GEOSisEmpty_r(handle, this->geometry) != 0;
+    if (!this->isEmpty) {
+      GEOSGeom_getXMin_r(handle, this->geometry, &this->envelope[0]);
+      GEOSGeom_getYMin_r(handle, this->geometry, &this->envelope[1]);
+      GEOSGeom_getXMax_r(handle, this->geometry, &this->envelope[2]);
+      GEOSGeom_getYMax_r(handle, this->geometry, &this->envelope[3]);
+    }
+
+    this->hasEnvelope = true;
+  }
+
+  return this->isEmpty ? NULL : this->envelope;
+}
+
+
+/**
+ * Free GEOS geometry immediately; further use throws.
+ * Disposing more than once has no effect.
+ */
+void Geometry::Dispose(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("Geometry::dispose");
+
+  if (this->IsPinned()) {
+    Napi::Error::New(env, "Geometry in use").ThrowAsJavaScriptException();
+    return;
+  }
+
+  this->Free(env);
 }
 
 
@@ -80,8 +288,12 @@ Geometry::~Geometry() {
  *
  */
 Napi::Value Geometry::GetSRID(const Napi::CallbackInfo& info) {
-  int srid = GEOSGetSRID(this->geometry);
-  return Napi::Number::New(info.Env(), srid);
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::getSRID", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
+  int srid = GEOSGetSRID_r(handle, this->geometry);
+  return Napi::Number::New(env, srid);
 }
 
 
@@ -90,6 +302,9 @@ Napi::Value Geometry::GetSRID(const Napi::CallbackInfo& info) {
  */
 void Geometry::SetSRID(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return;
+  StatsScope stats("Geometry::setSRID", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
 
   if (info.Length() < 1) {
     Napi::Error::New(env, "Missing argument: SRID").ThrowAsJavaScriptException();
@@ -101,8 +316,11 @@ void Geometry::SetSRID(const Napi::CallbackInfo& info) {
     return;
   }
 
+  // Do not modify parent through view:
+  this->Own(env);
+
   int srid = info[0].As<Napi::Number>().Int32Value();
-  GEOSSetSRID(this->geometry, srid);
+  GEOSSetSRID_r(handle, this->geometry, srid);
 }
 
 
@@ -110,9 +328,13 @@ void Geometry::SetSRID(const Napi::CallbackInfo& info) {
  *
  */
 Napi::Value Geometry::GetType(const Napi::CallbackInfo& info) {
-  char *type = GEOSGeomType(this->geometry);
-  Napi::String value = Napi::String::New(info.Env(), type);
-  free(type);
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::getType", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
+  char *type = GEOSGeomType_r(handle, this->geometry);
+  Napi::String value = Napi::String::New(env, type);
+  GEOSFree_r(handle, type);
   return value;
 }
 
@@ -121,8 +343,12 @@ Napi::Value Geometry::GetType(const Napi::CallbackInfo& info) {
  * Return number of points of LineString, -1 else.
  */
 Napi::Value Geometry::GetNumPoints(const Napi::CallbackInfo& info) {
-  int num = GEOSGeomGetNumPoints(this->geometry);
-  return Napi::Number::New(info.Env(), num);
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::getNumPoints", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
+  int num = GEOSGeomGetNumPoints_r(handle, this->geometry);
+  return Napi::Number::New(env, num);
 }
 
 
@@ -133,6 +359,9 @@ Napi::Value Geometry::GetNumPoints(const Napi::CallbackInfo& info) {
  */
 Napi::Value Geometry::GetPointN(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::getPointN", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
 
   if (info.Length() < 1) {
     Napi::Error::New(env, "Missing argument: n").ThrowAsJavaScriptException();
@@ -145,7 +374,7 @@ Napi::Value Geometry::GetPointN(const Napi::CallbackInfo& info) {
   }
 
   int n = info[0].As<Napi::Number>().Int32Value();
-  int num = GEOSGeomGetNumPoints(this->geometry);
+  int num = GEOSGeomGetNumPoints_r(handle, this->geometry);
 
   if (num == -1) {
     Napi::TypeError::New(env, "Unexpected geometry: expected LineString").ThrowAsJavaScriptException();
@@ -159,7 +388,12 @@ Napi::Value Geometry::GetPointN(const Napi::CallbackInfo& info) {
     return env.Undefined();
   }
 
-  GEOSGeometry *geometry = GEOSGeomGetPointN(this->geometry, n);
+  GEOSGeometry *geometry = GEOSGeomGetPointN_r(handle, this->geometry, n);
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
   Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
   return Geometry::NewInstance(env, external);
 }
@@ -170,7 +404,10 @@ Napi::Value Geometry::GetPointN(const Napi::CallbackInfo& info) {
  */
 Napi::Value Geometry::GetStartPoint(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  GEOSGeometry *geometry = GEOSGeomGetStartPoint(this->geometry);
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::getStartPoint", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
+  GEOSGeometry *geometry = GEOSGeomGetStartPoint_r(handle, this->geometry);
 
   if (geometry == NULL) {
     Napi::TypeError::New(env, "Unexpected geometry: expected LineString").ThrowAsJavaScriptException();
@@ -187,7 +424,10 @@ Napi::Value Geometry::GetStartPoint(const Napi::CallbackInfo& info) {
  */
 Napi::Value Geometry::GetEndPoint(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  GEOSGeometry *geometry = GEOSGeomGetEndPoint(this->geometry);
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::getEndPoint", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
+  GEOSGeometry *geometry = GEOSGeomGetEndPoint_r(handle, this->geometry);
 
   if (geometry == NULL) {
     Napi::TypeError::New(env, "Unexpected geometry: expected LineString").ThrowAsJavaScriptException();
@@ -203,9 +443,13 @@ Napi::Value Geometry::GetEndPoint(const Napi::CallbackInfo& info) {
  *
  */
 Napi::Value Geometry::GetX(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::getX", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
   double value;
-  GEOSGeomGetX(this->geometry, &value);
-  return Napi::Number::New(info.Env(), value);
+  GEOSGeomGetX_r(handle, this->geometry, &value);
+  return Napi::Number::New(env, value);
 }
 
 
@@ -213,9 +457,13 @@ Napi::Value Geometry::GetX(const Napi::CallbackInfo& info) {
  *
  */
 Napi::Value Geometry::GetY(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::getY", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
   double value;
-  GEOSGeomGetY(this->geometry, &value);
-  return Napi::Number::New(info.Env(), value);
+  GEOSGeomGetY_r(handle, this->geometry, &value);
+  return Napi::Number::New(env, value);
 }
 
 
@@ -223,8 +471,12 @@ Napi::Value Geometry::GetY(const Napi::CallbackInfo& info) {
  *
  */
 Napi::Value Geometry::GetNumGeometries(const Napi::CallbackInfo& info) {
-  int num = GEOSGetNumGeometries(this->geometry);
-  return Napi::Number::New(info.Env(), num);
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::getNumGeometries", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
+  int num = GEOSGetNumGeometries_r(handle, this->geometry);
+  return Napi::Number::New(env, num);
 }
 
 
@@ -233,6 +485,9 @@ Napi::Value Geometry::GetNumGeometries(const Napi::CallbackInfo& info) {
  */
 Napi::Value Geometry::GetGeometryN(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::getGeometryN", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
 
   if (info.Length() < 1) {
     Napi::Error::New(env, "Missing argument: n").ThrowAsJavaScriptException();
@@ -245,16 +500,133 @@ Napi::Value Geometry::GetGeometryN(const Napi::CallbackInfo& info) {
   }
 
   int n = info[0].As<Napi::Number>().Int32Value();
-  int num = GEOSGetNumGeometries(this->geometry);
+  int num = GEOSGetNumGeometries_r(handle, this->geometry);
 
-  if (n >= num) {
+  if (n < 0 || n >= num) {
     Napi::Error::New(env, "Invalid range: n").ThrowAsJavaScriptException();
     return env.Undefined();
   }
 
-  GEOSGeometry* geometry = GEOSGeom_clone(GEOSGetGeometryN(this->geometry, n));
-  Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
-  return Geometry::NewInstance(env, external);
+  // Borrowed view, no copy:
+  const GEOSGeometry* geometry = GEOSGetGeometryN_r(handle, this->geometry, n);
+  return Geometry::NewView(env, geometry, info.This().As<Napi::Object>());
+}
+
+
+/**
+ * Call fn(part, index) for each part; stops when fn returns false.
+ * To avoid allocations, the same view object is passed for all parts:
+ * it is only valid during the call and must not be retained.
+ * info[0] : Function - fn
+ */
+Napi::Value Geometry::ForEachGeometry(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::forEachGeometry", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: fn").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsFunction()) {
+    Napi::TypeError::New(env, "Invalid argument: fn").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Function fn = info[0].As<Napi::Function>();
+  int num = GEOSGetNumGeometries_r(handle, this->geometry);
+  if (num < 1) return env.Undefined();
+
+  Napi::Object object = Geometry::NewView(env, GEOSGetGeometryN_r(handle, this->geometry, 0), info.This().As<Napi::Object>());
+  Geometry* view = Napi::ObjectWrap<Geometry>::Unwrap(object);
+
+  try {
+    for (int i = 0; i < num; i++) {
+      const GEOSGeometry* part = GEOSGetGeometryN_r(handle, this->geometry, i);
+
+      // View may have been disposed, made independent or pinned
+      // (prepared, indexed, used by pending async operation) by callback;
+      // pinned views keep their part and parent reference:
+      if (view->geometry == NULL || view->owned || view->IsPinned()) {
+        object = Geometry::NewView(env, part, info.This().As<Napi::Object>());
+        view = Napi::ObjectWrap<Geometry>::Unwrap(object);
+      }
+
+      Napi::HandleScope scope(env);
+      view->geometry = (GEOSGeometry*)part;
+      view->hasEnvelope = false;
+      Napi::Value result = fn.Call({ object, Napi::Number::New(env, i) });
+      if (result.IsBoolean() && !result.As<Napi::Boolean>().Value()) break;
+    }
+  } catch (const Napi::Error&) {
+    if (!view->owned && !view->IsPinned()) view->Free(env);
+    throw;
+  }
+
+  // Detach view from parent; later use throws "Geometry disposed":
+  if (!view->owned && !view->IsPinned()) view->Free(env);
+  return env.Undefined();
+}
+
+
+/**
+ * Return all coordinates as { coords, dims, ringOffsets, partOffsets }:
+ * coords : Float64Array - interleaved x, y[, z]
+ * ringOffsets : Uint32Array - start of each ring/line/point in coordinates
+ * partOffsets : Uint32Array - start of each Point/LineString/Polygon in rings
+ * Offset arrays have one trailing element (end of last ring/part).
+ */
+Napi::Value Geometry::GetCoordinates(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::getCoordinates", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
+
+  FlatCounts counts = { 0, 0, 0 };
+  CountFlat(handle, this->geometry, &counts);
+
+  int hasZ = GEOSHasZ_r(handle, this->geometry) == 1;
+  int dims = hasZ ? 3 : 2;
+  Napi::Float64Array coords = Napi::Float64Array::New(env, counts.coords * dims);
+  Napi::Uint32Array ringOffsets = Napi::Uint32Array::New(env, counts.rings + 1);
+  Napi::Uint32Array partOffsets = Napi::Uint32Array::New(env, counts.parts + 1);
+
+  FlatBuffers buffers = { coords.Data(), ringOffsets.Data(), partOffsets.Data(), hasZ, 0, 0, 0 };
+  buffers.ringOffsets[0] = 0;
+  buffers.partOffsets[0] = 0;
+  WriteFlat(handle, this->geometry, &buffers);
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("coords", coords);
+  result.Set("dims", Napi::Number::New(env, dims));
+  result.Set("ringOffsets", ringOffsets);
+  result.Set("partOffsets", partOffsets);
+  return result;
+}
+
+
+/**
+ * Returns Float64Array [minx, miny, maxx, maxy];
+ * [Infinity, Infinity, -Infinity, -Infinity] for empty geometries.
+ */
+Napi::Value Geometry::GetEnvelope(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::getEnvelope", this->geometry);
+
+  const double* envelope = this->Envelope();
+  Napi::Float64Array array = Napi::Float64Array::New(env, 4);
+
+  if (envelope == NULL) {
+    array[0] = array[1] = INFINITY;
+    array[2] = array[3] = -INFINITY;
+  } else {
+    for (int i = 0; i < 4; i++) array[i] = envelope[i];
+  }
+
+  return array;
 }
 
 
@@ -263,6 +635,9 @@ Napi::Value Geometry::GetGeometryN(const Napi::CallbackInfo& info) {
  */
 Napi::Value Geometry::Difference(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::difference", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
 
   if (info.Length() < 1) {
     Napi::Error::New(env, "Missing argument: geometry").ThrowAsJavaScriptException();
@@ -270,8 +645,13 @@ Napi::Value Geometry::Difference(const Napi::CallbackInfo& info) {
   }
 
   GEOSGeometry* g1 = this->geometry;
-  GEOSGeometry* g2 = Napi::ObjectWrap<Geometry>::Unwrap(info[0].As<Napi::Object>())->geometry;
-  GEOSGeometry* geometry = GEOSDifference(g1, g2);
+  GEOSGeometry* g2 = Geometry::Unwrap(info[0].As<Napi::Object>())->geometry;
+  GEOSGeometry* geometry = GEOSDifference_r(handle, g1, g2);
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
   Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
   return Geometry::NewInstance(env, external);
 }
@@ -282,6 +662,9 @@ Napi::Value Geometry::Difference(const Napi::CallbackInfo& info) {
  */
 Napi::Value Geometry::Union(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::union", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
 
   if (info.Length() < 1) {
     Napi::Error::New(env, "Missing argument: geometry").ThrowAsJavaScriptException();
@@ -289,8 +672,13 @@ Napi::Value Geometry::Union(const Napi::CallbackInfo& info) {
   }
 
   GEOSGeometry* g1 = this->geometry;
-  GEOSGeometry* g2 = Napi::ObjectWrap<Geometry>::Unwrap(info[0].As<Napi::Object>())->geometry;
-  GEOSGeometry* geometry = GEOSUnion(g1, g2);
+  GEOSGeometry* g2 = Geometry::Unwrap(info[0].As<Napi::Object>())->geometry;
+  GEOSGeometry* geometry = GEOSUnion_r(handle, g1, g2);
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
   Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
   return Geometry::NewInstance(env, external);
 }
@@ -301,6 +689,9 @@ Napi::Value Geometry::Union(const Napi::CallbackInfo& info) {
  */
 Napi::Value Geometry::Intersection(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::intersection", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
 
   if (info.Length() < 1) {
     Napi::Error::New(env, "Missing argument: geometry").ThrowAsJavaScriptException();
@@ -308,8 +699,13 @@ Napi::Value Geometry::Intersection(const Napi::CallbackInfo& info) {
   }
 
   GEOSGeometry* g1 = this->geometry;
-  GEOSGeometry* g2 = Napi::ObjectWrap<Geometry>::Unwrap(info[0].As<Napi::Object>())->geometry;
-  GEOSGeometry* geometry = GEOSIntersection(g1, g2);
+  GEOSGeometry* g2 = Geometry::Unwrap(info[0].As<Napi::Object>())->geometry;
+  GEOSGeometry* geometry = GEOSIntersection_r(handle, g1, g2);
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
   Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
   return Geometry::NewInstance(env, external);
 }
@@ -319,19 +715,38 @@ Napi::Value Geometry::Intersection(const Napi::CallbackInfo& info) {
  */
 Napi::Value Geometry::ConvexHull(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  GEOSGeometry* geometry = GEOSConvexHull(this->geometry);
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::convexHull", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
+  GEOSGeometry* geometry = GEOSConvexHull_r(handle, this->geometry);
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
   Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
   return Geometry::NewInstance(env, external);
 }
 
 
 /**
- *
+ * Options { timeout, signal } are accepted as last argument.
+ * info[0] : double - width
+ * info[1..3] : int32 - quadsegs, endCapStyle, joinStyle (optional)
+ * info[4] : double - mitreLimit (optional, GEOS default 5.0)
  */
 Napi::Value Geometry::Buffer(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::buffer", this->geometry);
+  Context* context = GetContext();
 
-  if (info.Length() < 1) {
+  size_t argc = info.Length();
+  Napi::Value options = env.Undefined();
+  if (argc > 1 && info[argc - 1].IsObject()) options = info[--argc];
+  if (!Interrupt::Validate(options)) return env.Undefined();
+
+  if (argc < 1) {
     Napi::Error::New(env, "Missing argument: width").ThrowAsJavaScriptException();
     return env.Undefined();
   }
@@ -339,28 +754,48 @@ Napi::Value Geometry::Buffer(const Napi::CallbackInfo& info) {
   double width = info[0].As<Napi::Number>().DoubleValue();
 
   int quadsegs = 16; // default
-  if (info.Length() > 1) {
+  if (argc > 1) {
     quadsegs = info[1].As<Napi::Number>().Int32Value();
   }
 
   int endCapStyle = GEOSBUF_CAP_ROUND; // default
-  if (info.Length() > 2) {
+  if (argc > 2) {
     endCapStyle = info[2].As<Napi::Number>().Int32Value();
   }
 
   int joinStyle = GEOSBUF_JOIN_ROUND; // default
-  if (info.Length() > 3) {
+  if (argc > 3) {
     joinStyle = info[3].As<Napi::Number>().Int32Value();
   }
 
-  GEOSGeometry *geometry = GEOSBufferWithStyle(
-    this->geometry,
-    width,
-    quadsegs,
-    endCapStyle,
-    joinStyle,
-    0.0 // TODO: support mitre limit
-  );
+  double mitreLimit = 5.0; // default
+  if (argc > 4) {
+    mitreLimit = info[4].As<Napi::Number>().DoubleValue();
+  }
+
+  Interrupt interrupt(options);
+  GEOSGeometry* geometry = NULL;
+
+  if (!interrupt.Check()) {
+    InterruptScope scope(&interrupt);
+    geometry = GEOSBufferWithStyle_r(
+      context->handle,
+      this->geometry,
+      width,
+      quadsegs,
+      endCapStyle,
+      joinStyle,
+      mitreLimit
+    );
+  }
+
+  if (geometry == NULL) {
+    Napi::Error error = interrupt.Reason() != INTERRUPT_NONE
+      ? interrupt.Error(env)
+      : Napi::Error::New(env, context->last_error);
+    error.ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
 
   Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
   return Geometry::NewInstance(env, external);
@@ -372,13 +807,21 @@ Napi::Value Geometry::Buffer(const Napi::CallbackInfo& info) {
  */
 Napi::Value Geometry::AsPolygon(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::asPolygon", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
 
-  GEOSCoordSequence* cs = GEOSCoordSeq_clone(GEOSGeom_getCoordSeq(this->geometry));
-  GEOSGeometry* shell = GEOSGeom_createLinearRing(cs);
+  GEOSCoordSequence* cs = GEOSCoordSeq_clone_r(handle, GEOSGeom_getCoordSeq_r(handle, this->geometry));
+  GEOSGeometry* shell = GEOSGeom_createLinearRing_r(handle, cs);
   GEOSGeometry** holes = NULL;
   unsigned int nholes = 0;
 
-  GEOSGeometry* geometry = GEOSGeom_createPolygon(shell, holes, nholes);
+  GEOSGeometry* geometry = GEOSGeom_createPolygon_r(handle, shell, holes, nholes);
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
   Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
   return Geometry::NewInstance(env, external);
 }
@@ -389,18 +832,46 @@ Napi::Value Geometry::AsPolygon(const Napi::CallbackInfo& info) {
  */
 Napi::Value Geometry::AsBoundary(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  GEOSGeometry* geometry = GEOSBoundary(this->geometry);
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::asBoundary", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
+  GEOSGeometry* geometry = GEOSBoundary_r(handle, this->geometry);
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
   Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
   return Geometry::NewInstance(env, external);
 }
 
 
 /**
- *
+ * info[0] : Object - options { timeout, signal } (optional)
  */
 Napi::Value Geometry::AsValid(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  GEOSGeometry* geometry = GEOSMakeValid(this->geometry);
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::asValid", this->geometry);
+  Context* context = GetContext();
+  if (!Interrupt::Validate(info[0])) return env.Undefined();
+
+  Interrupt interrupt(info[0]);
+  GEOSGeometry* geometry = NULL;
+
+  if (!interrupt.Check()) {
+    InterruptScope scope(&interrupt);
+    geometry = GEOSMakeValid_r(context->handle, this->geometry);
+  }
+
+  if (geometry == NULL) {
+    Napi::Error error = interrupt.Reason() != INTERRUPT_NONE
+      ? interrupt.Error(env)
+      : Napi::Error::New(env, context->last_error);
+    error.ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
   Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
   return Geometry::NewInstance(env, external);
 }
@@ -411,6 +882,9 @@ Napi::Value Geometry::AsValid(const Napi::CallbackInfo& info) {
  */
 Napi::Value Geometry::Interpolate(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::interpolate", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
 
   if (info.Length() < 1) {
     Napi::Error::New(env, "Missing argument: d").ThrowAsJavaScriptException();
@@ -423,7 +897,12 @@ Napi::Value Geometry::Interpolate(const Napi::CallbackInfo& info) {
   }
 
   double d = info[0].As<Napi::Number>().DoubleValue();
-  GEOSGeometry *geometry = GEOSInterpolate(this->geometry, d);
+  GEOSGeometry *geometry = GEOSInterpolate_r(handle, this->geometry, d);
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
   Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
   return Geometry::NewInstance(env, external);
 }
@@ -434,6 +913,9 @@ Napi::Value Geometry::Interpolate(const Napi::CallbackInfo& info) {
  */
 Napi::Value Geometry::InterpolateNormalized(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::interpolateNormalized", this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
 
   if (info.Length() < 1) {
     Napi::Error::New(env, "Missing argument: d").ThrowAsJavaScriptException();
@@ -446,17 +928,77 @@ Napi::Value Geometry::InterpolateNormalized(const Napi::CallbackInfo& info) {
   }
 
   double d = info[0].As<Napi::Number>().DoubleValue();
-  GEOSGeometry *geometry = GEOSInterpolateNormalized(this->geometry, d);
+  GEOSGeometry *geometry = GEOSInterpolateNormalized_r(handle, this->geometry, d);
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
   Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
   return Geometry::NewInstance(env, external);
 }
 
 
+/**
+ * Douglas-Peucker simplification; tolerance in units of coordinates.
+ * info[0] : double - tolerance
+ */
+Napi::Value Geometry::SimplifyTemplate(const Napi::CallbackInfo& info, const char* name, simplify_t fn) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats(name, this->geometry);
+  Context* context = GetContext();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: tolerance").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Invalid argument: tolerance").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  double tolerance = info[0].As<Napi::Number>().DoubleValue();
+  if (!(tolerance >= 0)) {
+    Napi::Error::New(env, "Invalid range: tolerance").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  GEOSGeometry* geometry = fn(context->handle, this->geometry, tolerance);
+  if (geometry == NULL) {
+    Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
+  return Geometry::NewInstance(env, external);
+}
+
+
+/**
+ * May produce invalid (e.g. self-intersecting or collapsed) geometries.
+ */
+Napi::Value Geometry::Simplify(const Napi::CallbackInfo& info) {
+  return this->SimplifyTemplate(info, "Geometry::simplify", &GEOSSimplify_r);
+}
+
+
+/**
+ * Keeps rings valid and disjoint; slower than simplify().
+ */
+Napi::Value Geometry::TopologyPreservingSimplify(const Napi::CallbackInfo& info) {
+  return this->SimplifyTemplate(info, "Geometry::topologyPreservingSimplify", &GEOSTopologyPreserveSimplify_r);
+}
+
+
 /**
  *
  */
 Napi::Value Geometry::Transform(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::transform", this->geometry);
 
   if (info.Length() < 1) {
     Napi::Error::New(env, "Missing argument: fn").ThrowAsJavaScriptException();
@@ -471,16 +1013,500 @@ Napi::Value Geometry::Transform(const Napi::CallbackInfo& info) {
   Napi::Function fn = info[0].As<Napi::Function>();
 
   GEOSGeometry *geometry = TransformGeom(env, fn, this->geometry);
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
+  return Geometry::NewInstance(env, external);
+}
+
+/**
+ * Like transform(), but fn(coords, dims) is called once per coordinate
+ * sequence with an interleaved Float64Array to be modified in place.
+ * info[0] : Function - fn
+ */
+Napi::Value Geometry::TransformBatch(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::transformBatch", this->geometry);
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: fn").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsFunction()) {
+    Napi::TypeError::New(env, "Invalid argument: fn").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Function fn = info[0].As<Napi::Function>();
+
+  GEOSGeometry *geometry = TransformBatchGeom(env, fn, this->geometry);
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
   Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
   return Geometry::NewInstance(env, external);
 }
 
+
+Napi::Value Geometry::AffineTemplate(const Napi::CallbackInfo& info, const char* name, const double matrix[12]) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats(name, this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
+  GEOSGeometry *geometry = AffineGeom(handle, matrix, this->geometry);
+  if (geometry == NULL) {
+    Napi::Error::New(env, GetContext()->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
+  return Geometry::NewInstance(env, external);
+}
+
+
+/**
+ * Apply 2D or 3D affine transformation natively; Z is preserved.
+ * info[0] : [Number] | Float64Array -
+ *   2D: [a, b, d, e, xoff, yoff]
+ *   3D: [a, b, c, d, e, f, g, h, i, xoff, yoff, zoff]
+ */
+Napi::Value Geometry::Affine(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: matrix").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsArray() && !info[0].IsTypedArray()) {
+    Napi::TypeError::New(env, "Invalid argument: matrix").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Object input = info[0].ToObject();
+  uint32_t length = input.Get("length").As<Napi::Number>().Uint32Value();
+
+  if (length != 6 && length != 12) {
+    Napi::TypeError::New(env, "Invalid argument: matrix").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  double values[12];
+  for (uint32_t i = 0; i < length; i++) {
+    Napi::Value value = input[i];
+    if (!value.IsNumber()) {
+      Napi::TypeError::New(env, "Invalid argument: matrix").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    values[i] = value.As<Napi::Number>().DoubleValue();
+  }
+
+  if (length == 12) {
+    return this->AffineTemplate(info, "Geometry::affine", values);
+  }
+
+  const double matrix[12] = {
+    values[0], values[1], 0.0,
+    values[2], values[3], 0.0,
+    0.0, 0.0, 1.0,
+    values[4], values[5], 0.0
+  };
+
+  return this->AffineTemplate(info, "Geometry::affine", matrix);
+}
+
+
+/**
+ * See TranslateMatrix().
+ */
+Napi::Value Geometry::Translate(const Napi::CallbackInfo& info) {
+  double matrix[12];
+  if (!TranslateMatrix(info, matrix)) return info.Env().Undefined();
+  return this->AffineTemplate(info, "Geometry::translate", matrix);
+}
+
+
+/**
+ * Scale relative to origin; see ScaleMatrix().
+ */
+Napi::Value Geometry::Scale(const Napi::CallbackInfo& info) {
+  double matrix[12];
+  if (!ScaleMatrix(info, matrix)) return info.Env().Undefined();
+  return this->AffineTemplate(info, "Geometry::scale", matrix);
+}
+
+
+/**
+ * Rotate counter-clockwise around Z axis; see RotateMatrix().
+ */
+Napi::Value Geometry::Rotate(const Napi::CallbackInfo& info) {
+  double matrix[12];
+  if (!RotateMatrix(info, matrix)) return info.Env().Undefined();
+  return this->AffineTemplate(info, "Geometry::rotate", matrix);
+}
+
+
+/**
+ * Return PreparedGeometry for repeated predicate evaluation.
+ */
+Napi::Value Geometry::Prepare(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::prepare", this->geometry);
+  return PreparedGeometry::NewInstance(env, info.This().As<Napi::Object>());
+}
+
+
+/**
+ * Copy of geometry in a SharedArrayBuffer, e.g. for postMessage() to
+ * worker threads; see GEOS::fromShared().
+ */
+Napi::Value Geometry::ToShared(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::toShared", this->geometry);
+  return ::ToShared(env, this->geometry);
+}
+
+
+// Distance operations; NaN (or no result) if either geometry is empty:
+
+/**
+ * Minimum cartesian distance.
+ * info[0] : Geometry - other
+ */
+Napi::Value Geometry::Distance(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::distance", this->geometry);
+  Context* context = GetContext();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: Geometry").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Geometry* other = Geometry::Unwrap(info[0].As<Napi::Object>());
+  if (this->Envelope() == NULL || other->Envelope() == NULL) return Napi::Number::New(env, NAN);
+
+  double distance;
+  if (!GEOSDistance_r(context->handle, this->geometry, other->geometry, &distance)) {
+    Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  return Napi::Number::New(env, distance);
+}
+
+
+/**
+ * Discrete Hausdorff distance.
+ * info[0] : Geometry - other
+ * info[1] : double - densify fraction in (0, 1] (optional)
+ */
+Napi::Value Geometry::HausdorffDistance(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::hausdorffDistance", this->geometry);
+  Context* context = GetContext();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: Geometry").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Geometry* other = Geometry::Unwrap(info[0].As<Napi::Object>());
+  double densifyFrac = 0;
+
+  if (info.Length() > 1 && !info[1].IsUndefined()) {
+    if (!info[1].IsNumber()) {
+      Napi::TypeError::New(env, "Invalid argument: densifyFrac").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    densifyFrac = info[1].As<Napi::Number>().DoubleValue();
+    if (!(densifyFrac > 0 && densifyFrac <= 1)) {
+      Napi::Error::New(env, "Invalid range: densifyFrac").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+  }
+
+  if (this->Envelope() == NULL || other->Envelope() == NULL) return Napi::Number::New(env, NAN);
+
+  double distance;
+  int status = densifyFrac > 0
+    ? GEOSHausdorffDistanceDensify_r(context->handle, this->geometry, other->geometry, densifyFrac, &distance)
+    : GEOSHausdorffDistance_r(context->handle, this->geometry, other->geometry, &distance);
+
+  if (!status) {
+    Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  return Napi::Number::New(env, distance);
+}
+
+
+/**
+ * Closest points of both geometries: [x0, y0, x1, y1]; null if either is empty.
+ * info[0] : Geometry - other
+ */
+Napi::Value Geometry::NearestPoints(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::nearestPoints", this->geometry);
+  Context* context = GetContext();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: Geometry").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Geometry* other = Geometry::Unwrap(info[0].As<Napi::Object>());
+  if (this->Envelope() == NULL || other->Envelope() == NULL) return env.Null();
+
+  GEOSCoordSequence* points = GEOSNearestPoints_r(context->handle, this->geometry, other->geometry);
+  if (points == NULL) {
+    Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Float64Array array = Napi::Float64Array::New(env, 4);
+  GEOSCoordSeq_copyToBuffer_r(context->handle, points, array.Data(), 0, 0);
+  GEOSCoordSeq_destroy_r(context->handle, points);
+  return array;
+}
+
+
+/**
+ * Whether distance is less than or equal to d; false if either geometry is empty.
+ * info[0] : Geometry - other
+ * info[1] : double - d
+ */
+Napi::Value Geometry::IsWithinDistance(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::isWithinDistance", this->geometry);
+  Context* context = GetContext();
+
+  if (info.Length() < 2) {
+    Napi::Error::New(env, "Missing argument(s): Geometry, d").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Geometry* other = Geometry::Unwrap(info[0].As<Napi::Object>());
+
+  if (!info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Invalid argument: d").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  double d = info[1].As<Napi::Number>().DoubleValue();
+  const double* e1 = this->Envelope();
+  const double* e2 = other->Envelope();
+  if (e1 == NULL || e2 == NULL || d < 0) return Napi::Boolean::New(env, false);
+
+  // Envelope distance is a lower bound of distance:
+  double dx = std::max(0.0, std::max(e1[0] - e2[2], e2[0] - e1[2]));
+  double dy = std::max(0.0, std::max(e1[1] - e2[3], e2[1] - e1[3]));
+  if (dx * dx + dy * dy > d * d) return Napi::Boolean::New(env, false);
+
+  char result = GEOSDistanceWithin_r(context->handle, this->geometry, other->geometry, d);
+  if (result == 2) {
+    Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  return Napi::Boolean::New(env, result == 1);
+}
+
+
+/**
+ * Distances to many geometries in one call; this geometry is prepared once.
+ * info[0] : [Geometry]
+ * returns Float64Array - NaN for empty geometries
+ */
+Napi::Value Geometry::DistanceMany(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats("Geometry::distanceMany", this->geometry);
+  Context* context = GetContext();
+  GEOSContextHandle_t handle = context->handle;
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: [Geometry]").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsArray()) {
+    Napi::TypeError::New(env, "Invalid argument: [Geometry]").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Array input = info[0].As<Napi::Array>();
+  uint32_t length = input.Length();
+  std::vector<Geometry*> others(length);
+  for (uint32_t i = 0; i < length; i++) {
+    Napi::Value value = input[i];
+    others[i] = Geometry::Unwrap(value.As<Napi::Object>());
+  }
+
+  Napi::Float64Array result = Napi::Float64Array::New(env, length);
+  if (this->Envelope() == NULL) {
+    for (uint32_t i = 0; i < length; i++) result[i] = NAN;
+    return result;
+  }
+
+  const GEOSPreparedGeometry* prepared = GEOSPrepare_r(handle, this->geometry);
+  for (uint32_t i = 0; i < length; i++) {
+    if (others[i]->Envelope() == NULL) {
+      result[i] = NAN;
+      continue;
+    }
+
+    double distance;
+    if (!GEOSPreparedDistance_r(handle, prepared, others[i]->geometry, &distance)) {
+      GEOSPreparedGeom_destroy_r(handle, prepared);
+      Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    result[i] = distance;
+  }
+
+  GEOSPreparedGeom_destroy_r(handle, prepared);
+  return result;
+}
+
+
+// Asynchronous operations:
+
+// Options { timeout, signal } are accepted as last argument:
+
+Napi::Value Geometry::UnaryOpAsyncTemplate(const Napi::CallbackInfo& info, const char* name, unary_op_t fn) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  if (!Interrupt::Validate(info[0])) return env.Undefined();
+  GeometryWorker* worker = new UnaryOpWorker(env, name, info.This().As<Napi::Object>(), fn, info[0]);
+  return worker->Start();
+}
+
+Napi::Value Geometry::BinaryOpAsyncTemplate(const Napi::CallbackInfo& info, const char* name, binary_op_t fn) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: geometry").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // Throws "Error: Invalid argument" if not a Geometry object:
+  Geometry::Unwrap(info[0].As<Napi::Object>());
+  if (!Interrupt::Validate(info[1])) return env.Undefined();
+
+  GeometryWorker* worker = new BinaryOpWorker(
+    env,
+    name,
+    info.This().As<Napi::Object>(),
+    info[0].As<Napi::Object>(),
+    fn,
+    info[1]
+  );
+
+  return worker->Start();
+}
+
+Napi::Value Geometry::DifferenceAsync(const Napi::CallbackInfo& info) {
+  return this->BinaryOpAsyncTemplate(info, "Geometry::differenceAsync", &GEOSDifference_r);
+}
+
+Napi::Value Geometry::UnionAsync(const Napi::CallbackInfo& info) {
+  return this->BinaryOpAsyncTemplate(info, "Geometry::unionAsync", &GEOSUnion_r);
+}
+
+Napi::Value Geometry::IntersectionAsync(const Napi::CallbackInfo& info) {
+  return this->BinaryOpAsyncTemplate(info, "Geometry::intersectionAsync", &GEOSIntersection_r);
+}
+
+Napi::Value Geometry::ConvexHullAsync(const Napi::CallbackInfo& info) {
+  return this->UnaryOpAsyncTemplate(info, "Geometry::convexHullAsync", &GEOSConvexHull_r);
+}
+
+Napi::Value Geometry::AsValidAsync(const Napi::CallbackInfo& info) {
+  return this->UnaryOpAsyncTemplate(info, "Geometry::asValidAsync", &GEOSMakeValid_r);
+}
+
+/**
+ * Same arguments as buffer(); resolves to buffered geometry.
+ * info[4] : double - mitreLimit (optional, GEOS default 5.0)
+ */
+Napi::Value Geometry::BufferAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+
+  size_t argc = info.Length();
+  Napi::Value options = env.Undefined();
+  if (argc > 1 && info[argc - 1].IsObject()) options = info[--argc];
+  if (!Interrupt::Validate(options)) return env.Undefined();
+
+  if (argc < 1) {
+    Napi::Error::New(env, "Missing argument: width").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  double width = info[0].As<Napi::Number>().DoubleValue();
+
+  int quadsegs = 16; // default
+  if (argc > 1) {
+    quadsegs = info[1].As<Napi::Number>().Int32Value();
+  }
+
+  int endCapStyle = GEOSBUF_CAP_ROUND; // default
+  if (argc > 2) {
+    endCapStyle = info[2].As<Napi::Number>().Int32Value();
+  }
+
+  int joinStyle = GEOSBUF_JOIN_ROUND; // default
+  if (argc > 3) {
+    joinStyle = info[3].As<Napi::Number>().Int32Value();
+  }
+
+  double mitreLimit = 5.0; // default
+  if (argc > 4) {
+    mitreLimit = info[4].As<Napi::Number>().DoubleValue();
+  }
+
+  GeometryWorker* worker = new BufferWorker(
+    env,
+    "Geometry::bufferAsync",
+    info.This().As<Napi::Object>(),
+    width,
+    quadsegs,
+    endCapStyle,
+    joinStyle,
+    mitreLimit,
+    options
+  );
+
+  return worker->Start();
+}
+
 // Predicates:
 
-Napi::Value Geometry::PredicateTemplate(const Napi::CallbackInfo& info, predicate_t fn) {
+Napi::Value Geometry::PredicateTemplate(const Napi::CallbackInfo& info, const char* name, predicate_t fn) {
   Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats(name, this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
 
-  switch (fn(this->geometry)) {
+  switch (fn(handle, this->geometry)) {
   case 0:
     return Napi::Boolean::New(env, false);
     break;
@@ -495,44 +1521,81 @@ Napi::Value Geometry::PredicateTemplate(const Napi::CallbackInfo& info, predicat
 }
 
 Napi::Value Geometry::IsValid(const Napi::CallbackInfo& info) {
-  return this->PredicateTemplate(info, &GEOSisValid);
+  return this->PredicateTemplate(info, "Geometry::isValid", &GEOSisValid_r);
 }
 
 Napi::Value Geometry::IsEmpty(const Napi::CallbackInfo& info) {
-  return this->PredicateTemplate(info, &GEOSisEmpty);
+  return this->PredicateTemplate(info, "Geometry::isEmpty", &GEOSisEmpty_r);
 }
 
 Napi::Value Geometry::IsSimple(const Napi::CallbackInfo& info) {
-  return this->PredicateTemplate(info, &GEOSisSimple);
+  return this->PredicateTemplate(info, "Geometry::isSimple", &GEOSisSimple_r);
 }
 
 Napi::Value Geometry::IsRing(const Napi::CallbackInfo& info) {
-  return this->PredicateTemplate(info, &GEOSisRing);
+  return this->PredicateTemplate(info, "Geometry::isRing", &GEOSisRing_r);
 }
 
 Napi::Value Geometry::HasZ(const Napi::CallbackInfo& info) {
-  return this->PredicateTemplate(info, &GEOSHasZ);
+  return this->PredicateTemplate(info, "Geometry::hasZ", &GEOSHasZ_r);
 }
 
 Napi::Value Geometry::IsClosed(const Napi::CallbackInfo& info) {
-  return this->PredicateTemplate(info, &GEOSisClosed);
+  return this->PredicateTemplate(info, "Geometry::isClosed", &GEOSisClosed_r);
 }
 
 
 // Unary predicates:
 
-Napi::Value Geometry::UnaryPredicateTemplate(const Napi::CallbackInfo& info, unary_predicate_t fn) {
+/**
+ * Decide predicate from envelopes alone; -1 if inconclusive.
+ */
+static int EnvelopeTest(const double* a, const double* b, envelope_test_t test) {
+  bool disjoint = a[2] < b[0] || b[2] < a[0] || a[3] < b[1] || b[3] < a[1];
+
+  switch (test) {
+  case ENVELOPE_INTERSECTS:
+    return disjoint ? 0 : -1;
+  case ENVELOPE_DISJOINT:
+    return disjoint ? 1 : -1;
+  case ENVELOPE_CONTAINS:
+    return a[0] <= b[0] && a[1] <= b[1] && a[2] >= b[2] && a[3] >= b[3] ? -1 : 0;
+  case ENVELOPE_WITHIN:
+    return b[0] <= a[0] && b[1] <= a[1] && b[2] >= a[2] && b[3] >= a[3] ? -1 : 0;
+  case ENVELOPE_EQUALS:
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2] && a[3] == b[3] ? -1 : 0;
+  default:
+    return -1;
+  }
+}
+
+Napi::Value Geometry::UnaryPredicateTemplate(
+  const Napi::CallbackInfo& info,
+  const char* name,
+  unary_predicate_t fn,
+  envelope_test_t test
+) {
   Napi::Env env = info.Env();
+  if (this->IsDisposed(env)) return env.Undefined();
+  StatsScope stats(name, this->geometry);
+  GEOSContextHandle_t handle = GetContext()->handle;
 
   if (info.Length() < 1) {
     Napi::Error::New(env, "Missing argument: Geometry").ThrowAsJavaScriptException();
     return env.Undefined();
   }
 
+  Geometry* other = Geometry::Unwrap(info[0].As<Napi::Object>());
   GEOSGeometry* g1 = this->geometry;
-  GEOSGeometry* g2 = Napi::ObjectWrap<Geometry>::Unwrap(info[0].As<Napi::Object>())->geometry;
+  GEOSGeometry* g2 = other->geometry;
+
+  // Empty geometries are left to GEOS:
+  const double* e1 = this->Envelope();
+  const double* e2 = other->Envelope();
+  int result = e1 && e2 ? EnvelopeTest(e1, e2, test) : -1;
+  if (result == -1) result = fn(handle, g1, g2);
 
-  switch (fn(g1, g2)) {
+  switch (result) {
   case 0:
     return Napi::Boolean::New(env, false);
     break;
@@ -547,41 +1610,41 @@ Napi::Value Geometry::UnaryPredicateTemplate(const Napi::CallbackInfo& info, una
 }
 
 Napi::Value Geometry::Disjoint(const Napi::CallbackInfo& info) {
-  return this->UnaryPredicateTemplate(info, &GEOSDisjoint);
+  return this->UnaryPredicateTemplate(info, "Geometry::disjoint", &GEOSDisjoint_r, ENVELOPE_DISJOINT);
 }
 
 Napi::Value Geometry::Touches(const Napi::CallbackInfo& info) {
-  return this->UnaryPredicateTemplate(info, &GEOSTouches);
+  return this->UnaryPredicateTemplate(info, "Geometry::touches", &GEOSTouches_r, ENVELOPE_INTERSECTS);
 }
 
 Napi::Value Geometry::Intersects(const Napi::CallbackInfo& info) {
-  return this->UnaryPredicateTemplate(info, &GEOSIntersects);
+  return this->UnaryPredicateTemplate(info, "Geometry::intersects", &GEOSIntersects_r, ENVELOPE_INTERSECTS);
 }
 
 Napi::Value Geometry::Crosses(const Napi::CallbackInfo& info) {
-  return this->UnaryPredicateTemplate(info, &GEOSCrosses);
+  return this->UnaryPredicateTemplate(info, "Geometry::crosses", &GEOSCrosses_r, ENVELOPE_INTERSECTS);
 }
 
 Napi::Value Geometry::Within(const Napi::CallbackInfo& info) {
-  return this->UnaryPredicateTemplate(info, &GEOSWithin);
+  return this->UnaryPredicateTemplate(info, "Geometry::within", &GEOSWithin_r, ENVELOPE_WITHIN);
 }
 
 Napi::Value Geometry::Contains(const Napi::CallbackInfo& info) {
-  return this->UnaryPredicateTemplate(info, &GEOSContains);
+  return this->UnaryPredicateTemplate(info, "Geometry::contains", &GEOSContains_r, ENVELOPE_CONTAINS);
 }
 
 Napi::Value Geometry::Overlaps(const Napi::CallbackInfo& info) {
-  return this->UnaryPredicateTemplate(info, &GEOSOverlaps);
+  return this->UnaryPredicateTemplate(info, "Geometry::overlaps", &GEOSOverlaps_r, ENVELOPE_INTERSECTS);
 }
 
 Napi::Value Geometry::Equals(const Napi::CallbackInfo& info) {
-  return this->UnaryPredicateTemplate(info, &GEOSEquals);
+  return this->UnaryPredicateTemplate(info, "Geometry::equals", &GEOSEquals_r, ENVELOPE_EQUALS);
 }
 
 Napi::Value Geometry::Covers(const Napi::CallbackInfo& info) {
-  return this->UnaryPredicateTemplate(info, &GEOSCovers);
+  return this->UnaryPredicateTemplate(info, "Geometry::covers", &GEOSCovers_r, ENVELOPE_CONTAINS);
 }
 
 Napi::Value Geometry::CoveredBy(const Napi::CallbackInfo& info) {
-  return this->UnaryPredicateTemplate(info, &GEOSCoveredBy);
+  return this->UnaryPredicateTemplate(info, "Geometry::coveredBy", &GEOSCoveredBy_r, ENVELOPE_WITHIN);
 }
@@ -3,18 +3,51 @@
 
 #include <napi.h>
 #include <geos_c.h>
+#include <memory>
+#include "async.h"
+#include "arena.h"
 
-typedef char (*predicate_t)(const GEOSGeometry*);
-typedef char (*unary_predicate_t)(const GEOSGeometry*, const GEOSGeometry*);
+typedef char (*predicate_t)(GEOSContextHandle_t, const GEOSGeometry*);
+typedef char (*unary_predicate_t)(GEOSContextHandle_t, const GEOSGeometry*, const GEOSGeometry*);
+typedef GEOSGeometry* (*simplify_t)(GEOSContextHandle_t, const GEOSGeometry*, double);
+
+// Bounding box test deciding predicate without GEOS where possible:
+enum envelope_test_t {
+  ENVELOPE_NONE,
+  ENVELOPE_INTERSECTS, // false if envelopes are disjoint
+  ENVELOPE_DISJOINT, // true if envelopes are disjoint
+  ENVELOPE_CONTAINS, // false unless envelope contains other envelope
+  ENVELOPE_WITHIN, // false unless envelope is within other envelope
+  ENVELOPE_EQUALS // false unless envelopes are equal
+};
 
 class Geometry : public Napi::ObjectWrap<Geometry> {
  public:
   GEOSGeometry *geometry;
   static Napi::Object Init(Napi::Env env, Napi::Object exports);
   static Napi::Object NewInstance(Napi::Env env, Napi::External<GEOSGeometry> geometry);
+  static Napi::Object NewView(Napi::Env env, const GEOSGeometry* geometry, Napi::Object parent);
+  static Geometry* Unwrap(Napi::Object object);
+  static bool IsInstance(Napi::Value value);
   Geometry(const Napi::CallbackInfo& info);
   ~Geometry();
 
+  // Pinned geometries are referenced natively and cannot be disposed;
+  // the shared counter outlives the Geometry, so holders may be finalized in any order:
+  std::shared_ptr<int> Pin();
+  static void Unpin(std::shared_ptr<int> pins);
+  bool IsPinned();
+
+  // Scope (GEOS.scope()) geometry was created in, if any:
+  Arena* arena;
+  size_t arenaIndex;
+  void Free(Napi::Env env);
+
+  void Dispose(const Napi::CallbackInfo& info);
+
+  // Cached [minx, miny, maxx, maxy]; NULL for empty geometries:
+  const double* Envelope();
+
   Napi::Value GetSRID(const Napi::CallbackInfo& info);
   void SetSRID(const Napi::CallbackInfo& info);
   Napi::Value GetType(const Napi::CallbackInfo& info);
@@ -26,6 +59,9 @@ class Geometry : public Napi::ObjectWrap<Geometry> {
   Napi::Value GetX(const Napi::CallbackInfo& info);
   Napi::Value GetY(const Napi::CallbackInfo& info);
   Napi::Value GetGeometryN(const Napi::CallbackInfo& info);
+  Napi::Value ForEachGeometry(const Napi::CallbackInfo& info);
+  Napi::Value GetCoordinates(const Napi::CallbackInfo& info);
+  Napi::Value GetEnvelope(const Napi::CallbackInfo& info);
   Napi::Value Difference(const Napi::CallbackInfo& info);
   Napi::Value Union(const Napi::CallbackInfo& info);
   Napi::Value Intersection(const Napi::CallbackInfo& info);
@@ -36,9 +72,31 @@ class Geometry : public Napi::ObjectWrap<Geometry> {
   Napi::Value AsValid(const Napi::CallbackInfo& info);
   Napi::Value Interpolate(const Napi::CallbackInfo& info);
   Napi::Value InterpolateNormalized(const Napi::CallbackInfo& info);
+  Napi::Value Simplify(const Napi::CallbackInfo& info);
+  Napi::Value TopologyPreservingSimplify(const Napi::CallbackInfo& info);
   Napi::Value Transform(const Napi::CallbackInfo& info);
+  Napi::Value TransformBatch(const Napi::CallbackInfo& info);
+  Napi::Value Affine(const Napi::CallbackInfo& info);
+  Napi::Value Translate(const Napi::CallbackInfo& info);
+  Napi::Value Scale(const Napi::CallbackInfo& info);
+  Napi::Value Rotate(const Napi::CallbackInfo& info);
+  Napi::Value Prepare(const Napi::CallbackInfo& info);
+  Napi::Value ToShared(const Napi::CallbackInfo& info);
+  Napi::Value Distance(const Napi::CallbackInfo& info);
+  Napi::Value HausdorffDistance(const Napi::CallbackInfo& info);
+  Napi::Value NearestPoints(const Napi::CallbackInfo& info);
+  Napi::Value IsWithinDistance(const Napi::CallbackInfo& info);
+  Napi::Value DistanceMany(const Napi::CallbackInfo& info);
   Napi::Value IsValid(const Napi::CallbackInfo& info);
 
+  // Asynchronous operations (Promise):
+  Napi::Value DifferenceAsync(const Napi::CallbackInfo& info);
+  Napi::Value UnionAsync(const Napi::CallbackInfo& info);
+  Napi::Value IntersectionAsync(const Napi::CallbackInfo& info);
+  Napi::Value ConvexHullAsync(const Napi::CallbackInfo& info);
+  Napi::Value BufferAsync(const Napi::CallbackInfo& info);
+  Napi::Value AsValidAsync(const Napi::CallbackInfo& info);
+
   // Predicates:
   Napi::Value IsEmpty(const Napi::CallbackInfo& info);
   Napi::Value IsSimple(const Napi::CallbackInfo& info);
@@ -60,9 +118,33 @@ class Geometry : public Napi::ObjectWrap<Geometry> {
   Napi::Value CoveredBy(const Napi::CallbackInfo& info);
 
  private:
-  static Napi::FunctionReference constructor;
-  Napi::Value PredicateTemplate(const Napi::CallbackInfo& info, predicate_t fn);
-  Napi::Value UnaryPredicateTemplate(const Napi::CallbackInfo& info, unary_predicate_t fn);
+  // Estimated size of GEOS heap memory reported to V8:
+  int64_t externalMemory;
+  std::shared_ptr<int> pins;
+
+  // Views borrow a part of their (pinned) parent's geometry:
+  bool owned;
+  Napi::ObjectReference parent;
+  std::shared_ptr<int> parentPins;
+  void Own(Napi::Env env);
+
+  // Lazily computed envelope; geometry is immutable:
+  double envelope[4];
+  bool hasEnvelope;
+  bool isEmpty;
+
+  bool IsDisposed(Napi::Env env);
+  Napi::Value PredicateTemplate(const Napi::CallbackInfo& info, const char* name, predicate_t fn);
+  Napi::Value UnaryPredicateTemplate(
+    const Napi::CallbackInfo& info,
+    const char* name,
+    unary_predicate_t fn,
+    envelope_test_t test
+  );
+  Napi::Value SimplifyTemplate(const Napi::CallbackInfo& info, const char* name, simplify_t fn);
+  Napi::Value AffineTemplate(const Napi::CallbackInfo& info, const char* name, const double matrix[12]);
+  Napi::Value UnaryOpAsyncTemplate(const Napi::CallbackInfo& info, const char* name, unary_op_t fn);
+  Napi::Value BinaryOpAsyncTemplate(const Napi::CallbackInfo& info, const char* name, binary_op_t fn);
 };
 
 
@@ -0,0 +1,35 @@
+#ifndef __INSTANCE_H
+#define __INSTANCE_H
+
+#include <napi.h>
+#include <stdint.h>
+#include <vector>
+
+class Arena;
+
+/**
+ * Addon state of one environment (main thread or worker thread);
+ * created by module initialization, deleted with the environment.
+ * GEOS state is per thread (see Context).
+ */
+struct InstanceData {
+  // Class constructors:
+  Napi::FunctionReference geometry;
+  Napi::FunctionReference preparedGeometry;
+  Napi::FunctionReference spatialIndex;
+  Napi::FunctionReference reader;
+  Napi::FunctionReference dataset;
+  Napi::FunctionReference pipeline;
+
+  // Active GEOS.scope() arenas, innermost last:
+  std::vector<Arena*> arenas;
+  uint64_t nextArenaId = 0;
+};
+
+inline InstanceData* GetInstanceData(Napi::Env env) {
+  void* data = NULL;
+  napi_get_instance_data(env, &data);
+  return (InstanceData*)data;
+}
+
+#endif /* __INSTANCE_H */
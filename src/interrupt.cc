@@ -0,0 +1,159 @@
+#include <cmath>
+#include "interrupt.h"
+
+static thread_local Interrupt* current = NULL;
+
+#if GEOS_HAS_INTERRUPT_CALLBACK
+
+static int interrupt_fn(void *userdata) {
+  return current != NULL && current->Check();
+}
+
+void InitInterrupts(GEOSContextHandle_t handle) {
+  GEOSContext_setInterruptCallback_r(handle, interrupt_fn, NULL);
+}
+
+#else
+
+/**
+ * Before GEOS 3.12, interrupt requests are process-wide and would fail
+ * unrelated operations on other threads; options are rejected instead.
+ */
+void InitInterrupts(GEOSContextHandle_t handle) {}
+
+#endif
+
+
+Interrupt::Interrupt(Napi::Value options)
+  : hasDeadline(false),
+    aborted(std::make_shared<std::atomic<bool>>(false)),
+    reason(INTERRUPT_NONE) {
+  if (!options.IsObject()) return;
+  Napi::Object object = options.As<Napi::Object>();
+
+  Napi::Value timeout = object.Get("timeout");
+  if (timeout.IsNumber()) {
+    auto duration = std::chrono::duration<double, std::milli>(timeout.As<Napi::Number>().DoubleValue());
+    this->deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration);
+    this->hasDeadline = true;
+  }
+
+  Napi::Value signal = object.Get("signal");
+  if (signal.IsObject()) {
+    this->signal = Napi::Persistent(signal.As<Napi::Object>());
+    if (signal.As<Napi::Object>().Get("aborted").ToBoolean()) this->aborted->store(true);
+  }
+}
+
+/**
+ * info[n] : Object - options (optional)
+ *   timeout : Number - milliseconds from call
+ *   signal : AbortSignal
+ */
+bool Interrupt::Validate(Napi::Value options) {
+  Napi::Env env = options.Env();
+  if (options.IsUndefined()) return true;
+
+  if (!options.IsObject()) {
+    Napi::TypeError::New(env, "Invalid argument: options").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  Napi::Object object = options.As<Napi::Object>();
+  Napi::Value timeout = object.Get("timeout");
+
+#if !GEOS_HAS_INTERRUPT_CALLBACK
+  if (!timeout.IsUndefined() || !object.Get("signal").IsUndefined()) {
+    Napi::Error::New(env, "Not supported: timeout, signal (requires GEOS 3.12)").ThrowAsJavaScriptException();
+    return false;
+  }
+#endif
+
+  if (!timeout.IsUndefined()) {
+    if (!timeout.IsNumber()) {
+      Napi::TypeError::New(env, "Invalid argument: timeout").ThrowAsJavaScriptException();
+      return false;
+    }
+
+    double value = timeout.As<Napi::Number>().DoubleValue();
+    if (!(value >= 0) || std::isinf(value)) {
+      Napi::Error::New(env, "Invalid range: timeout").ThrowAsJavaScriptException();
+      return false;
+    }
+  }
+
+  Napi::Value signal = object.Get("signal");
+  if (!signal.IsUndefined()) {
+    if (!signal.IsObject() ||
+        !signal.As<Napi::Object>().Get("addEventListener").IsFunction() ||
+        !signal.As<Napi::Object>().Get("removeEventListener").IsFunction()) {
+      Napi::TypeError::New(env, "Invalid argument: signal").ThrowAsJavaScriptException();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void Interrupt::Listen() {
+  if (this->signal.IsEmpty() || this->aborted->load()) return;
+
+  Napi::Env env = this->signal.Env();
+  Napi::Object signal = this->signal.Value();
+
+  // Listener may outlive interrupt:
+  std::shared_ptr<std::atomic<bool>> aborted = this->aborted;
+  Napi::Function listener = Napi::Function::New(env, [aborted](const Napi::CallbackInfo& info) {
+    aborted->store(true);
+  });
+
+  signal.Get("addEventListener").As<Napi::Function>().Call(signal, { Napi::String::New(env, "abort"), listener });
+  this->listener = Napi::Persistent(listener);
+}
+
+void Interrupt::Release() {
+  if (this->listener.IsEmpty()) return;
+
+  Napi::Env env = this->signal.Env();
+  Napi::Object signal = this->signal.Value();
+  signal.Get("removeEventListener").As<Napi::Function>().Call(signal, {
+    Napi::String::New(env, "abort"),
+    this->listener.Value()
+  });
+
+  this->listener.Reset();
+}
+
+bool Interrupt::Check() {
+  if (this->reason.load() != INTERRUPT_NONE) return true;
+
+  int reason = INTERRUPT_NONE;
+  if (this->aborted->load()) reason = INTERRUPT_ABORT;
+  else if (this->hasDeadline && std::chrono::steady_clock::now() >= this->deadline) reason = INTERRUPT_TIMEOUT;
+  if (reason == INTERRUPT_NONE) return false;
+
+  int expected = INTERRUPT_NONE;
+  this->reason.compare_exchange_strong(expected, reason);
+  return true;
+}
+
+interrupt_reason_t Interrupt::Reason() {
+  return (interrupt_reason_t)this->reason.load();
+}
+
+Napi::Error Interrupt::Error(Napi::Env env) {
+  bool abort = this->Reason() == INTERRUPT_ABORT;
+  Napi::Error error = Napi::Error::New(env, abort ? "Operation aborted" : "Operation timed out");
+  if (abort) error.Set("name", Napi::String::New(env, "AbortError"));
+  error.Set("code", Napi::String::New(env, abort ? "ABORT_ERR" : "GEOS_TIMEOUT"));
+  return error;
+}
+
+
+InterruptScope::InterruptScope(Interrupt* interrupt) : previous(current) {
+  current = interrupt;
+}
+
+InterruptScope::~InterruptScope() {
+  current = this->previous;
+}
@@ -0,0 +1,70 @@
+#ifndef __INTERRUPT_H
+#define __INTERRUPT_H
+
+#include <napi.h>
+#include <geos_c.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+// Per-context interrupt callbacks; earlier interrupts are process-wide:
+#define GEOS_HAS_INTERRUPT_CALLBACK \
+  (GEOS_VERSION_MAJOR > 3 || (GEOS_VERSION_MAJOR == 3 && GEOS_VERSION_MINOR >= 12))
+
+enum interrupt_reason_t {
+  INTERRUPT_NONE,
+  INTERRUPT_TIMEOUT,
+  INTERRUPT_ABORT
+};
+
+/**
+ * Deadline and/or abort signal of an interruptible operation,
+ * from options { timeout, signal }. GEOS polls the interrupt installed
+ * on its thread (see InterruptScope) and fails the running operation;
+ * partial results are freed by GEOS. Requires GEOS 3.12; with earlier
+ * versions, options { timeout, signal } are rejected by Validate().
+ */
+class Interrupt {
+ public:
+  // Options are validated by Interrupt::Validate():
+  Interrupt(Napi::Value options);
+
+  // False (with pending JS exception) if options are invalid:
+  static bool Validate(Napi::Value options);
+
+  // Follow signal's 'abort' event while operation is pending; main thread only:
+  void Listen();
+  void Release();
+
+  // Whether operation should stop; first reason is kept (thread-safe):
+  bool Check();
+  interrupt_reason_t Reason();
+
+  // Error with code 'GEOS_TIMEOUT' or AbortError with code 'ABORT_ERR':
+  Napi::Error Error(Napi::Env env);
+
+ private:
+  bool hasDeadline;
+  std::chrono::steady_clock::time_point deadline;
+  std::shared_ptr<std::atomic<bool>> aborted;
+  std::atomic<int> reason;
+  Napi::ObjectReference signal;
+  Napi::FunctionReference listener;
+};
+
+/**
+ * Installs interrupt for GEOS calls on calling thread while in scope.
+ */
+class InterruptScope {
+ public:
+  InterruptScope(Interrupt* interrupt);
+  ~InterruptScope();
+
+ private:
+  Interrupt* previous;
+};
+
+// Register interrupt callback for (thread's) context handle:
+void InitInterrupts(GEOSContextHandle_t handle);
+
+#endif /* __INTERRUPT_H */
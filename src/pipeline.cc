@@ -0,0 +1,559 @@
+#include <cmath>
+#include "pipeline.h"
+#include "instance.h"
+#include "transform.h"
+#include "context.h"
+#include "interrupt.h"
+#include "stats.h"
+
+
+/**
+ * Applies pipeline to geometries on thread pool; resolves to
+ * Geometry | boolean, or array thereof for array input.
+ */
+class PipelineWorker : public Napi::AsyncWorker {
+ public:
+  PipelineWorker(Napi::Env env, Napi::Object pipeline, Napi::Value input, Napi::Value options)
+    : Napi::AsyncWorker(env),
+      deferred(Napi::Promise::Deferred::New(env)),
+      reference(Napi::Persistent(pipeline)),
+      array(input.IsArray()),
+      interrupt(options) {
+    this->pipeline = Napi::ObjectWrap<Pipeline>::Unwrap(pipeline);
+
+    if (this->array) {
+      Napi::Array geometries = input.As<Napi::Array>();
+      for (uint32_t i = 0; i < geometries.Length(); i++) this->Retain(geometries.Get(i));
+    } else {
+      this->Retain(input);
+    }
+
+    this->results.resize(this->inputs.size(), NULL);
+    this->values.resize(this->inputs.size(), 0);
+    this->interrupt.Listen();
+  }
+
+  ~PipelineWorker() {
+    for (size_t i = 0; i < this->pins.size(); i++) {
+      Geometry::Unpin(this->pins[i]);
+    }
+
+    for (size_t i = 0; i < this->results.size(); i++) {
+      if (this->results[i] != NULL) {
+        GEOSGeom_destroy_r(GetContext()->handle, this->results[i]);
+      }
+    }
+  }
+
+  Napi::Promise Start() {
+    Napi::Promise promise = this->deferred.Promise();
+    this->Queue();
+    return promise;
+  }
+
+ protected:
+  void Execute() {
+    Context* context = GetContext();
+    context->last_error[0] = '\0';
+    InterruptScope scope(&this->interrupt);
+
+    for (size_t i = 0; i < this->inputs.size(); i++) {
+      // Also between inputs, since not all ops poll for interrupts:
+      if (this->interrupt.Check()) {
+        SetError("Operation interrupted");
+        return;
+      }
+
+      if (!this->pipeline->Run(context->handle, this->inputs[i], &this->results[i], &this->values[i])) {
+        SetError(context->last_error[0] ? context->last_error : "Operation failed");
+        return;
+      }
+    }
+  }
+
+  void OnOK() {
+    Napi::Env env = Env();
+    this->interrupt.Release();
+
+    if (!this->array) {
+      this->deferred.Resolve(this->Result(env, 0));
+      return;
+    }
+
+    Napi::Array result = Napi::Array::New(env, this->inputs.size());
+    for (size_t i = 0; i < this->inputs.size(); i++) result.Set(i, this->Result(env, i));
+    this->deferred.Resolve(result);
+  }
+
+  void OnError(const Napi::Error& error) {
+    this->interrupt.Release();
+    this->deferred.Reject(this->interrupt.Reason() != INTERRUPT_NONE
+      ? this->interrupt.Error(Env()).Value()
+      : error.Value());
+  }
+
+ private:
+  Napi::Promise::Deferred deferred;
+  Napi::ObjectReference reference;
+  Pipeline* pipeline;
+  bool array;
+  std::vector<Napi::ObjectReference> references;
+  std::vector<std::shared_ptr<int>> pins;
+  std::vector<const GEOSGeometry*> inputs;
+  std::vector<GEOSGeometry*> results;
+  std::vector<char> values;
+  Interrupt interrupt;
+
+  /**
+   * Throws "Error: Invalid argument" if not a Geometry object.
+   */
+  void Retain(Napi::Value value) {
+    Napi::Object object = value.As<Napi::Object>();
+    Geometry* geometry = Geometry::Unwrap(object);
+    this->references.push_back(Napi::Persistent(object));
+    this->pins.push_back(geometry->Pin());
+    this->inputs.push_back(geometry->geometry);
+  }
+
+  Napi::Value Result(Napi::Env env, size_t i) {
+    if (this->pipeline->IsPredicate()) return Napi::Boolean::New(env, this->values[i] == 1);
+
+    Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, this->results[i]);
+    this->results[i] = NULL; // owned by Geometry
+    return Geometry::NewInstance(env, external);
+  }
+};
+
+
+Napi::Object Pipeline::Init(Napi::Env env, Napi::Object exports) {
+  Napi::HandleScope scope(env);
+
+  Napi::Function func = DefineClass(env, "Pipeline", {
+    InstanceMethod("difference", &Pipeline::Difference),
+    InstanceMethod("union", &Pipeline::Union),
+    InstanceMethod("intersection", &Pipeline::Intersection),
+    InstanceMethod("convexHull", &Pipeline::ConvexHull),
+    InstanceMethod("buffer", &Pipeline::Buffer),
+    InstanceMethod("simplify", &Pipeline::Simplify),
+    InstanceMethod("asBoundary", &Pipeline::AsBoundary),
+    InstanceMethod("asValid", &Pipeline::AsValid),
+    InstanceMethod("translate", &Pipeline::Translate),
+    InstanceMethod("scale", &Pipeline::Scale),
+    InstanceMethod("rotate", &Pipeline::Rotate),
+    InstanceMethod("disjoint", &Pipeline::Disjoint),
+    InstanceMethod("touches", &Pipeline::Touches),
+    InstanceMethod("intersects", &Pipeline::Intersects),
+    InstanceMethod("crosses", &Pipeline::Crosses),
+    InstanceMethod("within", &Pipeline::Within),
+    InstanceMethod("contains", &Pipeline::Contains),
+    InstanceMethod("overlaps", &Pipeline::Overlaps),
+    InstanceMethod("equals", &Pipeline::Equals),
+    InstanceMethod("covers", &Pipeline::Covers),
+    InstanceMethod("coveredBy", &Pipeline::CoveredBy),
+    InstanceMethod("build", &Pipeline::Build),
+    InstanceMethod("apply", &Pipeline::Apply),
+    InstanceMethod("applyAsync", &Pipeline::ApplyAsync)
+  });
+
+  GetInstanceData(env)->pipeline = Napi::Persistent(func);
+  return exports;
+}
+
+Napi::Object Pipeline::NewInstance(Napi::Env env) {
+  Napi::EscapableHandleScope scope(env);
+  Napi::Object object = GetInstanceData(env)->pipeline.New({});
+  return scope.Escape(napi_value(object)).ToObject();
+}
+
+Pipeline::Pipeline(const Napi::CallbackInfo& info) : Napi::ObjectWrap<Pipeline>(info) {
+  this->built = false;
+}
+
+Pipeline::~Pipeline() {
+  for (size_t i = 0; i < this->pins.size(); i++) {
+    Geometry::Unpin(this->pins[i]);
+  }
+}
+
+bool Pipeline::IsPredicate() {
+  return !this->ops.empty() && this->ops.back().kind == OP_PREDICATE;
+}
+
+/**
+ * Intermediate results are destroyed as soon as the next op has consumed them.
+ */
+bool Pipeline::Run(GEOSContextHandle_t handle, const GEOSGeometry* input, GEOSGeometry** result, char* value) {
+  const GEOSGeometry* current = input;
+  GEOSGeometry* owned = NULL;
+
+  for (size_t i = 0; i < this->ops.size(); i++) {
+    const PipelineOp& op = this->ops[i];
+    const double* params = op.params;
+    StatsScope stats(op.name, current);
+
+    if (op.kind == OP_PREDICATE) {
+      *value = op.predicate(handle, current, op.other);
+      if (owned != NULL) GEOSGeom_destroy_r(handle, owned);
+      return *value != 2;
+    }
+
+    GEOSGeometry* next = NULL;
+    switch (op.kind) {
+      case OP_UNARY:
+        next = op.unary(handle, current);
+        break;
+      case OP_BINARY:
+        next = op.binary(handle, current, op.other);
+        break;
+      case OP_BUFFER:
+        next = GEOSBufferWithStyle_r(handle, current, params[0], (int)params[1], (int)params[2], (int)params[3], params[4]);
+        break;
+      case OP_SIMPLIFY:
+        next = params[1] != 0.0
+          ? GEOSTopologyPreserveSimplify_r(handle, current, params[0])
+          : GEOSSimplify_r(handle, current, params[0]);
+        break;
+      case OP_AFFINE:
+        next = AffineGeom(handle, params, current);
+        break;
+      default:
+        break;
+    }
+
+    if (owned != NULL) GEOSGeom_destroy_r(handle, owned);
+    if (next == NULL) return false;
+    current = owned = next;
+  }
+
+  *result = owned != NULL ? owned : GEOSGeom_clone_r(handle, input);
+  return *result != NULL;
+}
+
+
+/**
+ * Throws if pipeline is already built or terminated by a predicate.
+ */
+bool Pipeline::Append(Napi::Env env, PipelineOp op) {
+  if (this->built) {
+    Napi::Error::New(env, "Pipeline built").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  if (this->IsPredicate()) {
+    Napi::Error::New(env, "Pipeline terminated by predicate").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  this->ops.push_back(op);
+  return true;
+}
+
+static PipelineOp CreateOp(pipeline_op_kind_t kind, const char* name) {
+  PipelineOp op = { kind, name, NULL, NULL, NULL, NULL, { 0.0 } };
+  return op;
+}
+
+Napi::Value Pipeline::UnaryOpTemplate(const Napi::CallbackInfo& info, const char* name, unary_op_t fn) {
+  PipelineOp op = CreateOp(OP_UNARY, name);
+  op.unary = fn;
+  if (!this->Append(info.Env(), op)) return info.Env().Undefined();
+  return info.This();
+}
+
+/**
+ * info[0] : Geometry - other
+ */
+Napi::Value Pipeline::BinaryOpTemplate(const Napi::CallbackInfo& info, const char* name, binary_op_t fn) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: geometry").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Object object = info[0].As<Napi::Object>();
+  Geometry* geometry = Geometry::Unwrap(object);
+
+  PipelineOp op = CreateOp(OP_BINARY, name);
+  op.binary = fn;
+  op.other = geometry->geometry;
+  if (!this->Append(env, op)) return env.Undefined();
+
+  this->references.push_back(Napi::Persistent(object));
+  this->pins.push_back(geometry->Pin());
+  return info.This();
+}
+
+Napi::Value Pipeline::AffineTemplate(const Napi::CallbackInfo& info, const char* name, const double matrix[12]) {
+  PipelineOp op = CreateOp(OP_AFFINE, name);
+  for (int i = 0; i < 12; i++) op.params[i] = matrix[i];
+  if (!this->Append(info.Env(), op)) return info.Env().Undefined();
+  return info.This();
+}
+
+/**
+ * info[0] : Geometry - other
+ */
+Napi::Value Pipeline::PredicateTemplate(const Napi::CallbackInfo& info, const char* name, unary_predicate_t fn) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: geometry").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Object object = info[0].As<Napi::Object>();
+  Geometry* geometry = Geometry::Unwrap(object);
+
+  PipelineOp op = CreateOp(OP_PREDICATE, name);
+  op.predicate = fn;
+  op.other = geometry->geometry;
+  if (!this->Append(env, op)) return env.Undefined();
+
+  this->references.push_back(Napi::Persistent(object));
+  this->pins.push_back(geometry->Pin());
+  return info.This();
+}
+
+
+Napi::Value Pipeline::Difference(const Napi::CallbackInfo& info) {
+  return this->BinaryOpTemplate(info, "Pipeline::difference", &GEOSDifference_r);
+}
+
+Napi::Value Pipeline::Union(const Napi::CallbackInfo& info) {
+  return this->BinaryOpTemplate(info, "Pipeline::union", &GEOSUnion_r);
+}
+
+Napi::Value Pipeline::Intersection(const Napi::CallbackInfo& info) {
+  return this->BinaryOpTemplate(info, "Pipeline::intersection", &GEOSIntersection_r);
+}
+
+Napi::Value Pipeline::ConvexHull(const Napi::CallbackInfo& info) {
+  return this->UnaryOpTemplate(info, "Pipeline::convexHull", &GEOSConvexHull_r);
+}
+
+Napi::Value Pipeline::AsBoundary(const Napi::CallbackInfo& info) {
+  return this->UnaryOpTemplate(info, "Pipeline::asBoundary", &GEOSBoundary_r);
+}
+
+Napi::Value Pipeline::AsValid(const Napi::CallbackInfo& info) {
+  return this->UnaryOpTemplate(info, "Pipeline::asValid", &GEOSMakeValid_r);
+}
+
+
+/**
+ * See Geometry::buffer().
+ * info[0] : double - width
+ * info[1] : int32 - quadsegs (optional, default 16)
+ * info[2] : int32 - endCapStyle (optional, default round)
+ * info[3] : int32 - joinStyle (optional, default round)
+ * info[4] : double - mitreLimit (optional, default 5.0)
+ */
+Napi::Value Pipeline::Buffer(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: width").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  for (size_t i = 0; i < info.Length() && i < 5; i++) {
+    if (!info[i].IsNumber()) {
+      Napi::TypeError::New(env, "Invalid argument: width, quadsegs, endCapStyle, joinStyle, mitreLimit").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+  }
+
+  PipelineOp op = CreateOp(OP_BUFFER, "Pipeline::buffer");
+  op.params[0] = info[0].As<Napi::Number>().DoubleValue();
+  op.params[1] = info.Length() > 1 ? info[1].As<Napi::Number>().Int32Value() : 16;
+  op.params[2] = info.Length() > 2 ? info[2].As<Napi::Number>().Int32Value() : GEOSBUF_CAP_ROUND;
+  op.params[3] = info.Length() > 3 ? info[3].As<Napi::Number>().Int32Value() : GEOSBUF_JOIN_ROUND;
+  op.params[4] = info.Length() > 4 ? info[4].As<Napi::Number>().DoubleValue() : 5.0;
+  if (!this->Append(env, op)) return env.Undefined();
+  return info.This();
+}
+
+/**
+ * Douglas-Peucker simplification.
+ * info[0] : double - tolerance
+ * info[1] : boolean - preserveTopology (optional, default false)
+ */
+Napi::Value Pipeline::Simplify(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: tolerance").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Invalid argument: tolerance").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  PipelineOp op = CreateOp(OP_SIMPLIFY, "Pipeline::simplify");
+  op.params[0] = info[0].As<Napi::Number>().DoubleValue();
+  op.params[1] = info.Length() > 1 && info[1].ToBoolean().Value() ? 1.0 : 0.0;
+  if (!this->Append(env, op)) return env.Undefined();
+  return info.This();
+}
+
+
+/**
+ * See TranslateMatrix().
+ */
+Napi::Value Pipeline::Translate(const Napi::CallbackInfo& info) {
+  double matrix[12];
+  if (!TranslateMatrix(info, matrix)) return info.Env().Undefined();
+  return this->AffineTemplate(info, "Pipeline::translate", matrix);
+}
+
+/**
+ * Scale relative to origin; see ScaleMatrix().
+ */
+Napi::Value Pipeline::Scale(const Napi::CallbackInfo& info) {
+  double matrix[12];
+  if (!ScaleMatrix(info, matrix)) return info.Env().Undefined();
+  return this->AffineTemplate(info, "Pipeline::scale", matrix);
+}
+
+/**
+ * Rotate counter-clockwise around Z axis; see RotateMatrix().
+ */
+Napi::Value Pipeline::Rotate(const Napi::CallbackInfo& info) {
+  double matrix[12];
+  if (!RotateMatrix(info, matrix)) return info.Env().Undefined();
+  return this->AffineTemplate(info, "Pipeline::rotate", matrix);
+}
+
+
+Napi::Value Pipeline::Disjoint(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "Pipeline::disjoint", &GEOSDisjoint_r);
+}
+
+Napi::Value Pipeline::Touches(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "Pipeline::touches", &GEOSTouches_r);
+}
+
+Napi::Value Pipeline::Intersects(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "Pipeline::intersects", &GEOSIntersects_r);
+}
+
+Napi::Value Pipeline::Crosses(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "Pipeline::crosses", &GEOSCrosses_r);
+}
+
+Napi::Value Pipeline::Within(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "Pipeline::within", &GEOSWithin_r);
+}
+
+Napi::Value Pipeline::Contains(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "Pipeline::contains", &GEOSContains_r);
+}
+
+Napi::Value Pipeline::Overlaps(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "Pipeline::overlaps", &GEOSOverlaps_r);
+}
+
+Napi::Value Pipeline::Equals(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "Pipeline::equals", &GEOSEquals_r);
+}
+
+Napi::Value Pipeline::Covers(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "Pipeline::covers", &GEOSCovers_r);
+}
+
+Napi::Value Pipeline::CoveredBy(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "Pipeline::coveredBy", &GEOSCoveredBy_r);
+}
+
+
+/**
+ * Freeze op list; returns pipeline.
+ */
+Napi::Value Pipeline::Build(const Napi::CallbackInfo& info) {
+  this->built = true;
+  return info.This();
+}
+
+/**
+ * Apply pipeline synchronously.
+ * info[0] : Geometry | [Geometry] - input
+ * returns Geometry | boolean, or array thereof
+ */
+Napi::Value Pipeline::Apply(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!this->built) {
+    Napi::Error::New(env, "Pipeline not built").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: geometry").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Context* context = GetContext();
+  bool array = info[0].IsArray();
+  Napi::Array input = array ? info[0].As<Napi::Array>() : Napi::Array::New(env, 1);
+  if (!array) input.Set((uint32_t)0, info[0]);
+
+  Napi::Array output = Napi::Array::New(env, input.Length());
+
+  for (uint32_t i = 0; i < input.Length(); i++) {
+    Napi::Value value = input[i];
+    Geometry* geometry = Geometry::Unwrap(value.As<Napi::Object>());
+
+    GEOSGeometry* result = NULL;
+    char predicate = 0;
+    context->last_error[0] = '\0';
+
+    if (!this->Run(context->handle, geometry->geometry, &result, &predicate)) {
+      Napi::Error::New(env, context->last_error[0] ? context->last_error : "Operation failed").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    if (this->IsPredicate()) {
+      output.Set(i, Napi::Boolean::New(env, predicate == 1));
+    } else {
+      Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, result);
+      output.Set(i, Geometry::NewInstance(env, external));
+    }
+  }
+
+  return array ? Napi::Value(output) : output.Get((uint32_t)0);
+}
+
+/**
+ * Apply pipeline on thread pool; inputs are pinned until completion.
+ * info[0] : Geometry | [Geometry] - input
+ * info[1] : Object - options { timeout, signal } (optional)
+ * returns Promise of Geometry | boolean, or array thereof
+ */
+Napi::Value Pipeline::ApplyAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (!this->built) {
+    Napi::Error::New(env, "Pipeline not built").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: geometry").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // Validate before worker pins anything:
+  if (info[0].IsArray()) {
+    Napi::Array input = info[0].As<Napi::Array>();
+    for (uint32_t i = 0; i < input.Length(); i++) Geometry::Unwrap(input.Get(i).As<Napi::Object>());
+  } else {
+    Geometry::Unwrap(info[0].As<Napi::Object>());
+  }
+
+  if (!Interrupt::Validate(info[1])) return env.Undefined();
+  PipelineWorker* worker = new PipelineWorker(env, info.This().As<Napi::Object>(), info[0], info[1]);
+  return worker->Start();
+}
@@ -0,0 +1,90 @@
+#ifndef __PIPELINE_H
+#define __PIPELINE_H
+
+#include <napi.h>
+#include <geos_c.h>
+#include <vector>
+#include <memory>
+#include "geometry.h"
+
+enum pipeline_op_kind_t {
+  OP_UNARY,
+  OP_BINARY,
+  OP_BUFFER,
+  OP_SIMPLIFY,
+  OP_AFFINE,
+  OP_PREDICATE // terminal; pipeline yields boolean
+};
+
+struct PipelineOp {
+  pipeline_op_kind_t kind;
+  const char* name; // statistics
+  unary_op_t unary;
+  binary_op_t binary;
+  unary_predicate_t predicate;
+  const GEOSGeometry* other;
+  // buffer: width, quadsegs, endCapStyle, joinStyle; simplify: tolerance; affine: matrix
+  double params[12];
+};
+
+/**
+ * Chain of geometry operations applied natively in one call;
+ * intermediate results are never wrapped as Geometry objects.
+ * Ops are appended until build(), which makes the pipeline immutable.
+ */
+class Pipeline : public Napi::ObjectWrap<Pipeline> {
+ public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+  static Napi::Object NewInstance(Napi::Env env);
+  Pipeline(const Napi::CallbackInfo& info);
+  ~Pipeline();
+
+  // Run ops on input; false on GEOS error.
+  // Either *result (geometry) or *value (terminal predicate) is set:
+  bool Run(GEOSContextHandle_t handle, const GEOSGeometry* input, GEOSGeometry** result, char* value);
+  bool IsPredicate();
+
+  Napi::Value Difference(const Napi::CallbackInfo& info);
+  Napi::Value Union(const Napi::CallbackInfo& info);
+  Napi::Value Intersection(const Napi::CallbackInfo& info);
+  Napi::Value ConvexHull(const Napi::CallbackInfo& info);
+  Napi::Value Buffer(const Napi::CallbackInfo& info);
+  Napi::Value Simplify(const Napi::CallbackInfo& info);
+  Napi::Value AsBoundary(const Napi::CallbackInfo& info);
+  Napi::Value AsValid(const Napi::CallbackInfo& info);
+  Napi::Value Translate(const Napi::CallbackInfo& info);
+  Napi::Value Scale(const Napi::CallbackInfo& info);
+  Napi::Value Rotate(const Napi::CallbackInfo& info);
+
+  // Terminal predicates:
+  Napi::Value Disjoint(const Napi::CallbackInfo& info);
+  Napi::Value Touches(const Napi::CallbackInfo& info);
+  Napi::Value Intersects(const Napi::CallbackInfo& info);
+  Napi::Value Crosses(const Napi::CallbackInfo& info);
+  Napi::Value Within(const Napi::CallbackInfo& info);
+  Napi::Value Contains(const Napi::CallbackInfo& info);
+  Napi::Value Overlaps(const Napi::CallbackInfo& info);
+  Napi::Value Equals(const Napi::CallbackInfo& info);
+  Napi::Value Covers(const Napi::CallbackInfo& info);
+  Napi::Value CoveredBy(const Napi::CallbackInfo& info);
+
+  Napi::Value Build(const Napi::CallbackInfo& info);
+  Napi::Value Apply(const Napi::CallbackInfo& info);
+  Napi::Value ApplyAsync(const Napi::CallbackInfo& info);
+
+ private:
+  std::vector<PipelineOp> ops;
+  bool built;
+
+  // Operand geometries are referenced and pinned until pipeline is collected:
+  std::vector<Napi::ObjectReference> references;
+  std::vector<std::shared_ptr<int>> pins;
+
+  bool Append(Napi::Env env, PipelineOp op);
+  Napi::Value UnaryOpTemplate(const Napi::CallbackInfo& info, const char* name, unary_op_t fn);
+  Napi::Value BinaryOpTemplate(const Napi::CallbackInfo& info, const char* name, binary_op_t fn);
+  Napi::Value AffineTemplate(const Napi::CallbackInfo& info, const char* name, const double matrix[12]);
+  Napi::Value PredicateTemplate(const Napi::CallbackInfo& info, const char* name, unary_predicate_t fn);
+};
+
+#endif /* __PIPELINE_H */
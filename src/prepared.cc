@@ -0,0 +1,148 @@
+#include "prepared.h"
+#include "instance.h"
+#include "geometry.h"
+#include "context.h"
+#include "stats.h"
+
+Napi::Object PreparedGeometry::Init(Napi::Env env, Napi::Object exports) {
+  Napi::HandleScope scope(env);
+
+  Napi::Function func = DefineClass(env, "PreparedGeometry", {
+    InstanceMethod("dispose", &PreparedGeometry::Dispose),
+    InstanceMethod("intersects", &PreparedGeometry::Intersects),
+    InstanceMethod("contains", &PreparedGeometry::Contains),
+    InstanceMethod("containsProperly", &PreparedGeometry::ContainsProperly),
+    InstanceMethod("covers", &PreparedGeometry::Covers),
+    InstanceMethod("coveredBy", &PreparedGeometry::CoveredBy),
+    InstanceMethod("within", &PreparedGeometry::Within),
+    InstanceMethod("touches", &PreparedGeometry::Touches),
+    InstanceMethod("crosses", &PreparedGeometry::Crosses),
+    InstanceMethod("overlaps", &PreparedGeometry::Overlaps),
+    InstanceMethod("disjoint", &PreparedGeometry::Disjoint)
+  });
+
+  Napi::Value dispose = env.Global().Get("Symbol").As<Napi::Object>().Get("dispose");
+  if (dispose.IsSymbol()) {
+    Napi::Object prototype = func.Get("prototype").As<Napi::Object>();
+    prototype.Set(dispose, prototype.Get("dispose"));
+  }
+
+  GetInstanceData(env)->preparedGeometry = Napi::Persistent(func);
+  return exports;
+}
+
+Napi::Object PreparedGeometry::NewInstance(Napi::Env env, Napi::Object geometry) {
+  Napi::EscapableHandleScope scope(env);
+  Napi::Object object = GetInstanceData(env)->preparedGeometry.New({ geometry });
+  return scope.Escape(napi_value(object)).ToObject();
+}
+
+PreparedGeometry::PreparedGeometry(const Napi::CallbackInfo& info) : Napi::ObjectWrap<PreparedGeometry>(info) {
+  Napi::Env env = info.Env();
+  Napi::HandleScope scope(env);
+  GEOSContextHandle_t handle = GetContext()->handle;
+
+  // Throws "Error: Invalid argument" if not a Geometry object:
+  Napi::Object object = info[0].As<Napi::Object>();
+  Geometry* geometry = Geometry::Unwrap(object);
+  this->geometry = Napi::Persistent(object);
+  this->pins = geometry->Pin();
+  this->prepared = GEOSPrepare_r(handle, geometry->geometry);
+}
+
+PreparedGeometry::~PreparedGeometry() {
+  this->Free();
+}
+
+/**
+ * Release prepared geometry and unpin base geometry.
+ */
+void PreparedGeometry::Free() {
+  if (this->prepared == NULL) return;
+
+  GEOSContextHandle_t handle = GetContext()->handle;
+  GEOSPreparedGeom_destroy_r(handle, this->prepared);
+  this->prepared = NULL;
+  Geometry::Unpin(this->pins);
+  this->pins.reset();
+}
+
+/**
+ * Free prepared geometry immediately; base geometry may be disposed afterwards.
+ */
+void PreparedGeometry::Dispose(const Napi::CallbackInfo& info) {
+  this->Free();
+  this->geometry.Reset();
+}
+
+
+Napi::Value PreparedGeometry::PredicateTemplate(const Napi::CallbackInfo& info, const char* name, prepared_predicate_t fn) {
+  Napi::Env env = info.Env();
+  Context* context = GetContext();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: Geometry").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (this->prepared == NULL) {
+    Napi::Error::New(env, "Geometry disposed").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  GEOSGeometry* g = Geometry::Unwrap(info[0].As<Napi::Object>())->geometry;
+  StatsScope stats(name, g);
+
+  switch (fn(context->handle, this->prepared, g)) {
+  case 0:
+    return Napi::Boolean::New(env, false);
+    break;
+  case 1:
+    return Napi::Boolean::New(env, true);
+    break;
+  default:
+    Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+    return env.Undefined();
+    break;
+  }
+}
+
+Napi::Value PreparedGeometry::Intersects(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "PreparedGeometry::intersects", &GEOSPreparedIntersects_r);
+}
+
+Napi::Value PreparedGeometry::Contains(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "PreparedGeometry::contains", &GEOSPreparedContains_r);
+}
+
+Napi::Value PreparedGeometry::ContainsProperly(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "PreparedGeometry::containsProperly", &GEOSPreparedContainsProperly_r);
+}
+
+Napi::Value PreparedGeometry::Covers(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "PreparedGeometry::covers", &GEOSPreparedCovers_r);
+}
+
+Napi::Value PreparedGeometry::CoveredBy(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "PreparedGeometry::coveredBy", &GEOSPreparedCoveredBy_r);
+}
+
+Napi::Value PreparedGeometry::Within(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "PreparedGeometry::within", &GEOSPreparedWithin_r);
+}
+
+Napi::Value PreparedGeometry::Touches(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "PreparedGeometry::touches", &GEOSPreparedTouches_r);
+}
+
+Napi::Value PreparedGeometry::Crosses(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "PreparedGeometry::crosses", &GEOSPreparedCrosses_r);
+}
+
+Napi::Value PreparedGeometry::Overlaps(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "PreparedGeometry::overlaps", &GEOSPreparedOverlaps_r);
+}
+
+Napi::Value PreparedGeometry::Disjoint(const Napi::CallbackInfo& info) {
+  return this->PredicateTemplate(info, "PreparedGeometry::disjoint", &GEOSPreparedDisjoint_r);
+}
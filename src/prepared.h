@@ -0,0 +1,39 @@
+#ifndef __PREPARED_H
+#define __PREPARED_H
+
+#include <napi.h>
+#include <geos_c.h>
+#include <memory>
+
+typedef char (*prepared_predicate_t)(GEOSContextHandle_t, const GEOSPreparedGeometry*, const GEOSGeometry*);
+
+class PreparedGeometry : public Napi::ObjectWrap<PreparedGeometry> {
+ public:
+  const GEOSPreparedGeometry *prepared;
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+  static Napi::Object NewInstance(Napi::Env env, Napi::Object geometry);
+  PreparedGeometry(const Napi::CallbackInfo& info);
+  ~PreparedGeometry();
+
+  void Dispose(const Napi::CallbackInfo& info);
+
+  Napi::Value Intersects(const Napi::CallbackInfo& info);
+  Napi::Value Contains(const Napi::CallbackInfo& info);
+  Napi::Value ContainsProperly(const Napi::CallbackInfo& info);
+  Napi::Value Covers(const Napi::CallbackInfo& info);
+  Napi::Value CoveredBy(const Napi::CallbackInfo& info);
+  Napi::Value Within(const Napi::CallbackInfo& info);
+  Napi::Value Touches(const Napi::CallbackInfo& info);
+  Napi::Value Crosses(const Napi::CallbackInfo& info);
+  Napi::Value Overlaps(const Napi::CallbackInfo& info);
+  Napi::Value Disjoint(const Napi::CallbackInfo& info);
+
+ private:
+  // Prepared geometry references (does not own) base geometry:
+  Napi::ObjectReference geometry;
+  std::shared_ptr<int> pins;
+  void Free();
+  Napi::Value PredicateTemplate(const Napi::CallbackInfo& info, const char* name, prepared_predicate_t fn);
+};
+
+#endif /* __PREPARED_H */
@@ -0,0 +1,461 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "reader.h"
+#include "instance.h"
+#include "geometry.h"
+#include "context.h"
+
+#define CHUNK_SIZE (1 << 20)
+
+/**
+ * Empty line or CR of CRLF line ending only; skipped by reader.
+ */
+static inline bool IsBlank(const char* line, size_t length) {
+  return length == 0 || (length == 1 && line[0] == '\r');
+}
+
+LineSource::LineSource()
+  : lineNumber(0), file(NULL), start(0), end(0), eof(false), lines(0), partial(0),
+    map(NULL), mapLength(0), offset(0) {
+}
+
+/**
+ * Open file for reading; NULL if file cannot be opened.
+ * Falls back to buffered input where memory-mapping is not available.
+ */
+LineSource* LineSource::Open(const char* path, bool mmap) {
+  LineSource* source = new LineSource();
+
+#ifndef _WIN32
+  if (mmap) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+      delete source;
+      return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* map = ::mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map != MAP_FAILED) {
+        madvise(map, st.st_size, MADV_SEQUENTIAL);
+        source->map = (const char*)map;
+        source->mapLength = st.st_size;
+      }
+    }
+
+    close(fd);
+    if (source->map != NULL) return source;
+  }
+#endif
+
+  source->file = fopen(path, "rb");
+  if (source->file == NULL) {
+    delete source;
+    return NULL;
+  }
+
+  source->buffer.resize(CHUNK_SIZE);
+  return source;
+}
+
+/**
+ * Empty source for input pushed from a stream.
+ */
+LineSource* LineSource::Create() {
+  LineSource* source = new LineSource();
+  source->buffer.resize(CHUNK_SIZE);
+  return source;
+}
+
+LineSource::~LineSource() {
+  if (this->file != NULL) fclose(this->file);
+#ifndef _WIN32
+  if (this->map != NULL) munmap((void*)this->map, this->mapLength);
+#endif
+}
+
+/**
+ * Next line without line terminator; false at end of input.
+ */
+bool LineSource::Next(const char** line, size_t* length) {
+  if (this->map != NULL) {
+    if (this->offset >= this->mapLength) return false;
+
+    const char* begin = this->map + this->offset;
+    size_t remaining = this->mapLength - this->offset;
+    const char* newline = (const char*)memchr(begin, '\n', remaining);
+    *line = begin;
+    *length = newline ? newline - begin : remaining;
+    this->offset += newline ? *length + 1 : remaining;
+    this->lineNumber++;
+    return true;
+  }
+
+  for (;;) {
+    char* begin = this->buffer.data() + this->start;
+    size_t available = this->end - this->start;
+    char* newline = (char*)memchr(begin, '\n', available);
+
+    if (newline != NULL || (this->eof && available > 0)) {
+      *line = begin;
+      *length = newline ? newline - begin : available;
+      this->start += newline ? *length + 1 : available;
+      if (newline != NULL && this->file == NULL && !IsBlank(*line, *length)) this->lines--;
+      this->lineNumber++;
+      return true;
+    }
+
+    // Pushed input waits for next chunk:
+    if (this->eof || this->file == NULL) return false;
+
+    // Move partial line to front; grow buffer for lines longer than a chunk:
+    memmove(this->buffer.data(), begin, available);
+    this->start = 0;
+    this->end = available;
+    if (this->end == this->buffer.size()) this->buffer.resize(this->buffer.size() * 2);
+
+    size_t count = fread(this->buffer.data() + this->end, 1, this->buffer.size() - this->end, this->file);
+    this->end += count;
+    if (count == 0) this->eof = true;
+  }
+}
+
+/**
+ * Append chunk; lines may span chunks.
+ */
+void LineSource::Push(const char* data, size_t length) {
+  if (length == 0) return;
+
+  // Drop lines already returned before growing buffer:
+  size_t available = this->end - this->start;
+  memmove(this->buffer.data(), this->buffer.data() + this->start, available);
+  this->start = 0;
+  this->end = available;
+  if (this->end + length > this->buffer.size()) {
+    this->buffer.resize(std::max(this->buffer.size() * 2, this->end + length));
+  }
+
+  memcpy(this->buffer.data() + this->end, data, length);
+
+  // Count lines completed by chunk; only new bytes are scanned:
+  const char* line = this->buffer.data() + this->end - this->partial;
+  const char* scan = this->buffer.data() + this->end;
+  const char* last = scan + length;
+  this->end += length;
+
+  const char* newline;
+  while ((newline = (const char*)memchr(scan, '\n', last - scan)) != NULL) {
+    if (!IsBlank(line, newline - line)) this->lines++;
+    line = scan = newline + 1;
+  }
+
+  this->partial = last - line;
+}
+
+/**
+ * Mark end of pushed input; last line needs no terminator.
+ */
+void LineSource::End() {
+  this->eof = true;
+}
+
+/**
+ * True if Next() can return given number of non-blank lines or input is complete.
+ */
+bool LineSource::Ready(size_t lines) const {
+  return this->eof || this->lines >= lines;
+}
+
+
+/**
+ * Parses next batch on thread pool; resolves to iterator result.
+ */
+class ReaderWorker : public Napi::AsyncWorker {
+ public:
+  ReaderWorker(Napi::Env env, Napi::Object object, Napi::Promise::Deferred deferred)
+    : Napi::AsyncWorker(env),
+      deferred(deferred),
+      reference(Napi::Persistent(object)) {
+    this->reader = Napi::ObjectWrap<Reader>::Unwrap(object);
+  }
+
+  ~ReaderWorker() {
+    for (size_t i = 0; i < this->geometries.size(); i++) {
+      if (this->geometries[i] != NULL) {
+        GEOSGeom_destroy_r(GetContext()->handle, this->geometries[i]);
+      }
+    }
+  }
+
+ protected:
+  void Execute() {
+    std::string error;
+    if (!this->reader->ReadBatch(GetContext(), this->geometries, error)) {
+      SetError(error);
+    }
+  }
+
+  void OnOK() {
+    Napi::Env env = Env();
+    Napi::Object result = Napi::Object::New(env);
+    this->reader->busy = false;
+
+    if (this->geometries.empty() || this->reader->returned) {
+      this->reader->Release();
+      result.Set("value", env.Undefined());
+      result.Set("done", Napi::Boolean::New(env, true));
+    } else {
+      Napi::Array batch = Napi::Array::New(env, this->geometries.size());
+      for (size_t i = 0; i < this->geometries.size(); i++) {
+        Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, this->geometries[i]);
+        this->geometries[i] = NULL; // owned by Geometry
+        batch.Set(i, Geometry::NewInstance(env, external));
+      }
+
+      result.Set("value", batch);
+      result.Set("done", Napi::Boolean::New(env, false));
+    }
+
+    this->deferred.Resolve(result);
+  }
+
+  void OnError(const Napi::Error& error) {
+    this->reader->busy = false;
+    this->reader->Release();
+    this->deferred.Reject(error.Value());
+  }
+
+ private:
+  Napi::Promise::Deferred deferred;
+  Napi::ObjectReference reference;
+  Reader* reader;
+  std::vector<GEOSGeometry*> geometries;
+};
+
+
+Napi::Object Reader::Init(Napi::Env env, Napi::Object exports) {
+  Napi::HandleScope scope(env);
+
+  Napi::Function func = DefineClass(env, "Reader", {
+    InstanceMethod("next", &Reader::Next),
+    InstanceMethod("return", &Reader::Return),
+    InstanceMethod("close", &Reader::Close)
+  });
+
+  // for await (const batch of reader) { ... }
+  Napi::Value asyncIterator = env.Global().Get("Symbol").As<Napi::Object>().Get("asyncIterator");
+  if (asyncIterator.IsSymbol()) {
+    Napi::Object prototype = func.Get("prototype").As<Napi::Object>();
+    prototype.Set(asyncIterator, Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
+      return info.This();
+    }));
+  }
+
+  GetInstanceData(env)->reader = Napi::Persistent(func);
+  return exports;
+}
+
+Napi::Object Reader::NewInstance(
+  Napi::Env env,
+  Napi::External<LineSource> source,
+  Napi::Number format,
+  Napi::Number batchSize,
+  Napi::Value iterator
+) {
+  Napi::EscapableHandleScope scope(env);
+  Napi::Object object = GetInstanceData(env)->reader.New({ source, format, batchSize, iterator });
+  return scope.Escape(napi_value(object)).ToObject();
+}
+
+/**
+ * Arguments are validated by GEOS::createReader().
+ * info[0] : External<LineSource> - opened source (owned by reader)
+ * info[1] : int32 - format
+ * info[2] : uint32 - batch size
+ * info[3] : Object - async iterator of stream chunks | undefined for files
+ */
+Reader::Reader(const Napi::CallbackInfo& info) : Napi::ObjectWrap<Reader>(info) {
+  Napi::Env env = info.Env();
+  Napi::HandleScope scope(env);
+  this->busy = false;
+  this->returned = false;
+  this->source = info[0].As<Napi::External<LineSource>>().Data();
+  this->format = info[1].As<Napi::Number>().Int32Value();
+  this->batchSize = info[2].As<Napi::Number>().Uint32Value();
+  if (info[3].IsObject()) this->iterator = Napi::Persistent(info[3].As<Napi::Object>());
+}
+
+Reader::~Reader() {
+  // No JavaScript calls from finalizer; stream is left to garbage collection:
+  delete this->source;
+}
+
+/**
+ * Close underlying file or stream; further reads are done.
+ * Stream is destroyed through iterator's return().
+ */
+void Reader::Release() {
+  delete this->source;
+  this->source = NULL;
+
+  if (!this->iterator.IsEmpty()) {
+    Napi::Object iterator = this->iterator.Value();
+    this->iterator.Reset();
+    Napi::Value close = iterator.Get("return");
+    if (close.IsFunction()) close.As<Napi::Function>().Call(iterator, {});
+  }
+}
+
+/**
+ * Pull stream chunks until one batch is buffered, then parse batch on
+ * thread pool. Stream is only read on demand, i.e. it stays paused
+ * while the consumer processes previous batches.
+ */
+void Reader::Fill(Napi::Env env, Napi::Promise::Deferred deferred) {
+  if (this->iterator.IsEmpty() || this->returned || this->source->Ready(this->batchSize)) {
+    ReaderWorker* worker = new ReaderWorker(env, this->Value(), deferred);
+    worker->Queue();
+    return;
+  }
+
+  Napi::Object iterator = this->iterator.Value();
+  Napi::Object promise = iterator.Get("next").As<Napi::Function>().Call(iterator, {}).As<Napi::Object>();
+
+  // Keep reader alive while chunk is pending:
+  this->Ref();
+
+  Napi::Function onChunk = Napi::Function::New(env, [this, deferred](const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    this->Unref();
+
+    Napi::Object result = info[0].As<Napi::Object>();
+    Napi::Value chunk = result.Get("value");
+
+    if (result.Get("done").ToBoolean()) this->source->End();
+    else if (chunk.IsTypedArray()) {
+      Napi::TypedArray array = chunk.As<Napi::TypedArray>();
+      this->source->Push((const char*)array.ArrayBuffer().Data() + array.ByteOffset(), array.ByteLength());
+    } else if (chunk.IsString()) {
+      std::string string = chunk.As<Napi::String>().Utf8Value();
+      this->source->Push(string.data(), string.length());
+    } else {
+      this->busy = false;
+      this->Release();
+      deferred.Reject(Napi::TypeError::New(env, "Invalid argument: chunk").Value());
+      return;
+    }
+
+    this->Fill(env, deferred);
+  });
+
+  Napi::Function onError = Napi::Function::New(env, [this, deferred](const Napi::CallbackInfo& info) {
+    this->Unref();
+    this->busy = false;
+    this->Release();
+    deferred.Reject(info[0]);
+  });
+
+  promise.Get("then").As<Napi::Function>().Call(promise, { onChunk, onError });
+}
+
+/**
+ * Parse up to batchSize geometries; blank lines are skipped.
+ */
+bool Reader::ReadBatch(Context* context, std::vector<GEOSGeometry*>& geometries, std::string& error) {
+  if (this->source == NULL) return true;
+
+  std::string wkt;
+  const char* line;
+  size_t length;
+
+  while (geometries.size() < this->batchSize && this->source->Next(&line, &length)) {
+    if (IsBlank(line, length)) continue;
+    if (line[length - 1] == '\r') length--;
+
+    context->last_error[0] = '\0';
+    GEOSGeometry* geometry = NULL;
+
+    if (this->format == READER_FORMAT_WKB) {
+      geometry = GEOSWKBReader_readHEX_r(
+        context->handle,
+        context->wkbReader,
+        (const unsigned char*)line,
+        length
+      );
+    } else {
+      // WKT reader expects NUL-terminated input:
+      wkt.assign(line, length);
+      geometry = GEOSWKTReader_read_r(context->handle, context->reader, wkt.c_str());
+    }
+
+    if (geometry == NULL) {
+      error = "Parse error at line " + std::to_string(this->source->lineNumber);
+      if (context->last_error[0]) error += std::string(": ") + context->last_error;
+      return false;
+    }
+
+    geometries.push_back(geometry);
+  }
+
+  return true;
+}
+
+
+/**
+ * Resolves to { value: [Geometry], done: false } or { value: undefined, done: true }.
+ * Rejects on parse or stream error; reader is closed afterwards.
+ */
+Napi::Value Reader::Next(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (this->busy) {
+    Napi::Error::New(env, "Reader busy").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+  this->busy = true;
+  this->Fill(env, deferred);
+  return deferred.Promise();
+}
+
+/**
+ * Async iterator return(); closes reader, e.g. on break.
+ */
+Napi::Value Reader::Return(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->busy) this->returned = true;
+  else this->Release();
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("value", env.Undefined());
+  result.Set("done", Napi::Boolean::New(env, true));
+
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+  deferred.Resolve(result);
+  return deferred.Promise();
+}
+
+/**
+ * Close reader synchronously, e.g. when not iterated to the end.
+ * Throws while a batch is pending; use return() instead.
+ */
+Napi::Value Reader::Close(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (this->busy) {
+    Napi::Error::New(env, "Reader busy").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  this->Release();
+  return env.Undefined();
+}
@@ -0,0 +1,93 @@
+#ifndef __READER_H
+#define __READER_H
+
+#include <napi.h>
+#include <geos_c.h>
+#include <string>
+#include <vector>
+
+struct Context;
+
+#define READER_FORMAT_WKT 0
+#define READER_FORMAT_WKB 1 // hex-encoded
+
+/**
+ * Newline-delimited input, either read in chunks, memory-mapped or
+ * pushed from a stream. Lines returned by Next() are valid until the next call.
+ */
+class LineSource {
+ public:
+  static LineSource* Open(const char* path, bool mmap);
+  static LineSource* Create();
+  ~LineSource();
+
+  bool Next(const char** line, size_t* length);
+  size_t lineNumber;
+
+  // Pushed input (main thread only, never while batch is parsed):
+  void Push(const char* data, size_t length);
+  void End();
+  bool Ready(size_t lines) const;
+
+ private:
+  LineSource();
+
+  // Buffered or pushed input:
+  FILE* file;
+  std::vector<char> buffer;
+  size_t start;
+  size_t end;
+  bool eof;
+
+  // Pushed complete non-blank lines not yet returned by Next(),
+  // length of trailing incomplete line:
+  size_t lines;
+  size_t partial;
+
+  // Memory-mapped input:
+  const char* map;
+  size_t mapLength;
+  size_t offset;
+};
+
+/**
+ * Pull-based reader yielding batches of geometries as async iterator;
+ * at most one batch is parsed (on the thread pool) at a time.
+ * Stream input is pulled chunk by chunk until one batch is buffered.
+ */
+class Reader : public Napi::ObjectWrap<Reader> {
+ public:
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+  static Napi::Object NewInstance(
+    Napi::Env env,
+    Napi::External<LineSource> source,
+    Napi::Number format,
+    Napi::Number batchSize,
+    Napi::Value iterator
+  );
+
+  Reader(const Napi::CallbackInfo& info);
+  ~Reader();
+
+  Napi::Value Next(const Napi::CallbackInfo& info);
+  Napi::Value Return(const Napi::CallbackInfo& info);
+  Napi::Value Close(const Napi::CallbackInfo& info);
+
+  // Called on thread pool; returns false on parse error:
+  bool ReadBatch(Context* context, std::vector<GEOSGeometry*>& geometries, std::string& error);
+  void Fill(Napi::Env env, Napi::Promise::Deferred deferred);
+  void Release();
+
+  bool busy;
+
+  // return() called while batch was pending; release when it settles:
+  bool returned;
+
+ private:
+  LineSource* source;
+  Napi::ObjectReference iterator; // stream input only
+  int format;
+  uint32_t batchSize;
+};
+
+#endif /* __READER_H */
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include "rtree.h"
+
+PackedRTree::PackedRTree() : boxes(NULL), indices(NULL), count(0), nodeSize(2) {
+}
+
+uint32_t PackedRTree::LevelBounds(uint32_t count, uint32_t nodeSize, std::vector<uint32_t>& bounds) {
+  bounds.clear();
+  if (count == 0) return 0;
+
+  uint32_t n = count;
+  uint32_t numNodes = count;
+  bounds.push_back(numNodes);
+
+  do {
+    n = (n + nodeSize - 1) / nodeSize;
+    numNodes += n;
+    bounds.push_back(numNodes);
+  } while (n != 1);
+
+  return numNodes;
+}
+
+void PackedRTree::Pack(
+  const double* envelopes,
+  const std::vector<uint32_t>& order,
+  uint32_t nodeSize,
+  const std::vector<uint32_t>& levelBounds,
+  double* boxes,
+  uint32_t* indices
+) {
+  uint32_t count = order.size();
+  for (uint32_t i = 0; i < count; i++) {
+    memcpy(boxes + i * 4, envelopes + order[i] * 4, 4 * sizeof(double));
+    indices[i] = order[i];
+  }
+
+  uint32_t pos = 0;
+  for (size_t level = 0; level + 1 < levelBounds.size(); level++) {
+    uint32_t end = levelBounds[level];
+    uint32_t parent = end;
+
+    while (pos < end) {
+      double* box = boxes + parent * 4;
+      box[0] = box[1] = INFINITY;
+      box[2] = box[3] = -INFINITY;
+      indices[parent] = pos;
+
+      for (uint32_t k = 0; k < nodeSize && pos < end; k++, pos++) {
+        const double* child = boxes + pos * 4;
+        box[0] = std::min(box[0], child[0]);
+        box[1] = std::min(box[1], child[1]);
+        box[2] = std::max(box[2], child[2]);
+        box[3] = std::max(box[3], child[3]);
+      }
+
+      parent++;
+    }
+  }
+}
+
+/**
+ * Boxes and indices must outlive the view.
+ */
+void PackedRTree::Assign(const double* boxes, const uint32_t* indices, uint32_t count, uint32_t nodeSize) {
+  this->boxes = boxes;
+  this->indices = indices;
+  this->count = count;
+  this->nodeSize = nodeSize;
+  LevelBounds(count, nodeSize, this->levelBounds);
+}
+
+/**
+ * End (exclusive) of children starting at first; last node of a level may be partial.
+ */
+uint32_t PackedRTree::ChildrenEnd(uint32_t first) const {
+  uint32_t bound = *std::upper_bound(this->levelBounds.begin(), this->levelBounds.end(), first);
+  return std::min(first + this->nodeSize, bound);
+}
+
+void PackedRTree::Query(const double envelope[4], std::vector<uint32_t>& hits) const {
+  if (this->count == 0) return;
+
+  std::vector<uint32_t> stack;
+  uint32_t node = this->levelBounds.back() - 1; // root
+
+  for (;;) {
+    uint32_t first = this->indices[node];
+    uint32_t end = this->ChildrenEnd(first);
+
+    for (uint32_t child = first; child < end; child++) {
+      const double* box = this->boxes + child * 4;
+      if (box[0] > envelope[2] || box[1] > envelope[3] || box[2] < envelope[0] || box[3] < envelope[1]) continue;
+      if (child < this->count) hits.push_back(this->indices[child]);
+      else stack.push_back(child);
+    }
+
+    if (stack.empty()) break;
+    node = stack.back();
+    stack.pop_back();
+  }
+}
+
+/**
+ * Lower bound of distance between geometries with envelopes a and b;
+ * infinite for inverted (empty) envelopes.
+ */
+static double EnvelopeDistance(const double* a, const double* b) {
+  if (b[0] > b[2]) return INFINITY;
+  double dx = std::max(0.0, std::max(a[0] - b[2], b[0] - a[2]));
+  double dy = std::max(0.0, std::max(a[1] - b[3], b[1] - a[3]));
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+struct NearestEntry {
+  double distance;
+  uint32_t node;
+  bool exact; // distance to leaf's item itself, not its envelope
+};
+
+/**
+ * Queue order: nearest first; on ties, bounds are expanded before exact
+ * items are reported, and items are reported by ascending index.
+ */
+struct NearestOrder {
+  const uint32_t* indices;
+
+  bool operator()(const NearestEntry& a, const NearestEntry& b) const {
+    if (a.distance != b.distance) return a.distance > b.distance;
+    if (a.exact != b.exact) return a.exact;
+    return a.exact && this->indices[a.node] > this->indices[b.node];
+  }
+};
+
+/**
+ * Best-first search: envelope distances bound subtrees, exact distances
+ * are only computed for items whose envelope is nearer than the k-th
+ * result: roughly O((log n + k) log n) for well-distributed items.
+ * Empty items are never reported.
+ */
+bool PackedRTree::Nearest(const double envelope[4], uint32_t k, item_distance_t distance, void* userdata, std::vector<uint32_t>& found) const {
+  if (this->count == 0) return true;
+
+  NearestOrder order = { this->indices };
+  std::priority_queue<NearestEntry, std::vector<NearestEntry>, NearestOrder> queue(order);
+  uint32_t root = this->levelBounds.back() - 1;
+  queue.push({ EnvelopeDistance(envelope, this->boxes + root * 4), root, false });
+
+  uint32_t reported = 0;
+  while (reported < k && !queue.empty()) {
+    NearestEntry next = queue.top();
+    queue.pop();
+    if (std::isinf(next.distance)) break;
+
+    if (next.exact) {
+      found.push_back(this->indices[next.node]);
+      reported++;
+    } else if (next.node < this->count) {
+      double d;
+      if (!distance(this->indices[next.node], &d, userdata)) return false;
+      queue.push({ d, next.node, true });
+    } else {
+      uint32_t first = this->indices[next.node];
+      uint32_t end = this->ChildrenEnd(first);
+      for (uint32_t child = first; child < end; child++) {
+        queue.push({ EnvelopeDistance(envelope, this->boxes + child * 4), child, false });
+      }
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,53 @@
+#ifndef __RTREE_H
+#define __RTREE_H
+
+#include <stdint.h>
+#include <vector>
+
+// Exact distance to item; false on error:
+typedef bool (*item_distance_t)(uint32_t item, double* distance, void* userdata);
+
+/**
+ * Read-only view of packed Hilbert R-tree: leaves (one per item, in
+ * Hilbert order) followed by parent levels of nodeSize consecutive
+ * children; the root is the last node. Per node:
+ *   boxes    double[4] - minx, miny, maxx, maxy
+ *   indices  uint32 - leaf: item index; node: first child node
+ * Empty items have inverted envelopes and never match.
+ */
+class PackedRTree {
+ public:
+  PackedRTree();
+
+  // End (exclusive node index) of each level, leaves first; returns number of nodes:
+  static uint32_t LevelBounds(uint32_t count, uint32_t nodeSize, std::vector<uint32_t>& bounds);
+
+  // Fill boxes and indices (sized by LevelBounds) from item envelopes and Hilbert order:
+  static void Pack(
+    const double* envelopes,
+    const std::vector<uint32_t>& order,
+    uint32_t nodeSize,
+    const std::vector<uint32_t>& levelBounds,
+    double* boxes,
+    uint32_t* indices
+  );
+
+  void Assign(const double* boxes, const uint32_t* indices, uint32_t count, uint32_t nodeSize);
+
+  // Indexes of items whose envelopes intersect envelope:
+  void Query(const double envelope[4], std::vector<uint32_t>& hits) const;
+
+  // Append up to k nearest items, nearest first; false on error:
+  bool Nearest(const double envelope[4], uint32_t k, item_distance_t distance, void* userdata, std::vector<uint32_t>& found) const;
+
+ private:
+  const double* boxes;
+  const uint32_t* indices;
+  uint32_t count;
+  uint32_t nodeSize;
+  std::vector<uint32_t> levelBounds;
+
+  uint32_t ChildrenEnd(uint32_t first) const;
+};
+
+#endif /* __RTREE_H */
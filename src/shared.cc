@@ -0,0 +1,252 @@
+#include <cstring>
+#include <vector>
+#include "shared.h"
+#include "geometry.h"
+#include "context.h"
+#include "stats.h"
+
+static const char SHARED_MAGIC[4] = { 'G', 'J', 'S', 'G' };
+
+// Bounds recursion on malformed input:
+#define MAX_SHARED_DEPTH 64
+
+static uint32_t CoordSeqSize(GEOSContextHandle_t handle, const GEOSGeometry* g) {
+  unsigned int size = 0;
+  const GEOSCoordSequence* cs = GEOSGeom_getCoordSeq_r(handle, g);
+  if (cs != NULL) GEOSCoordSeq_getSize_r(handle, cs, &size);
+  return size;
+}
+
+/**
+ * Node count (coordinates, rings or parts) of geometry.
+ */
+static uint32_t NodeCount(GEOSContextHandle_t handle, const GEOSGeometry* g, int type) {
+  switch (type) {
+    case GEOS_POINT:
+    case GEOS_LINESTRING:
+    case GEOS_LINEARRING:
+      return CoordSeqSize(handle, g);
+    case GEOS_POLYGON:
+      return GEOSisEmpty_r(handle, g) ? 0 : 1 + GEOSGetNumInteriorRings_r(handle, g);
+    default:
+      return GEOSGetNumGeometries_r(handle, g);
+  }
+}
+
+static const GEOSGeometry* Child(GEOSContextHandle_t handle, const GEOSGeometry* g, int type, uint32_t i) {
+  if (type != GEOS_POLYGON) return GEOSGetGeometryN_r(handle, g, i);
+  return i == 0 ? GEOSGetExteriorRing_r(handle, g) : GEOSGetInteriorRingN_r(handle, g, i - 1);
+}
+
+static void CountShared(GEOSContextHandle_t handle, const GEOSGeometry* g, uint32_t* nodes, uint64_t* coords) {
+  int type = GEOSGeomTypeId_r(handle, g);
+  uint32_t count = NodeCount(handle, g, type);
+  *nodes += 1;
+
+  if (type == GEOS_POINT || type == GEOS_LINESTRING || type == GEOS_LINEARRING) {
+    *coords += count;
+    return;
+  }
+
+  for (uint32_t i = 0; i < count; i++) CountShared(handle, Child(handle, g, type, i), nodes, coords);
+}
+
+struct SharedCursor {
+  uint32_t* nodes;
+  double* coords;
+  int hasZ;
+  uint32_t node;
+  uint64_t coord;
+};
+
+static void WriteShared(GEOSContextHandle_t handle, const GEOSGeometry* g, SharedCursor* cursor) {
+  int type = GEOSGeomTypeId_r(handle, g);
+  uint32_t count = NodeCount(handle, g, type);
+  cursor->nodes[cursor->node * 2] = type;
+  cursor->nodes[cursor->node * 2 + 1] = count;
+  cursor->node++;
+
+  if (type == GEOS_POINT || type == GEOS_LINESTRING || type == GEOS_LINEARRING) {
+    if (count > 0) {
+      double* coords = cursor->coords + cursor->coord * (cursor->hasZ ? 3 : 2);
+      GEOSCoordSeq_copyToBuffer_r(handle, GEOSGeom_getCoordSeq_r(handle, g), coords, cursor->hasZ, 0);
+    }
+
+    cursor->coord += count;
+    return;
+  }
+
+  for (uint32_t i = 0; i < count; i++) WriteShared(handle, Child(handle, g, type, i), cursor);
+}
+
+/**
+ * Copy geometry into new SharedArrayBuffer.
+ */
+Napi::Value ToShared(Napi::Env env, const GEOSGeometry* geometry) {
+  GEOSContextHandle_t handle = GetContext()->handle;
+  int hasZ = GEOSHasZ_r(handle, geometry) == 1;
+  uint32_t dims = hasZ ? 3 : 2;
+
+  uint32_t numNodes = 0;
+  uint64_t numCoords = 0;
+  CountShared(handle, geometry, &numNodes, &numCoords);
+
+  size_t size = sizeof(SharedHeader) + numCoords * dims * sizeof(double) + numNodes * 2 * sizeof(uint32_t);
+  Napi::Function SharedArrayBuffer = env.Global().Get("SharedArrayBuffer").As<Napi::Function>();
+  Napi::Object buffer = SharedArrayBuffer.New({ Napi::Number::New(env, size) });
+
+  // N-API has no SharedArrayBuffer accessors; typed array views expose data:
+  Napi::Function Uint8Array = env.Global().Get("Uint8Array").As<Napi::Function>();
+  uint8_t* data = Uint8Array.New({ buffer }).As<Napi::Uint8Array>().Data();
+
+  SharedHeader* header = (SharedHeader*)data;
+  memcpy(header->magic, SHARED_MAGIC, sizeof(SHARED_MAGIC));
+  header->dims = dims;
+  header->srid = GEOSGetSRID_r(handle, geometry);
+  header->numNodes = numNodes;
+  header->numCoords = numCoords;
+
+  double* coords = (double*)(data + sizeof(SharedHeader));
+  SharedCursor cursor = { (uint32_t*)(coords + numCoords * dims), coords, hasZ, 0, 0 };
+  WriteShared(handle, geometry, &cursor);
+  return buffer;
+}
+
+
+struct SharedReader {
+  const uint32_t* nodes;
+  const double* coords;
+  uint32_t dims;
+  uint32_t numNodes;
+  uint64_t numCoords;
+  uint32_t node;
+  uint64_t coord;
+};
+
+static void DestroyAll(GEOSContextHandle_t handle, std::vector<GEOSGeometry*>& geometries) {
+  for (size_t i = 0; i < geometries.size(); i++) GEOSGeom_destroy_r(handle, geometries[i]);
+}
+
+/**
+ * Read geometry at current node; NULL if malformed.
+ */
+static GEOSGeometry* ReadShared(GEOSContextHandle_t handle, SharedReader* reader, int depth) {
+  if (depth > MAX_SHARED_DEPTH || reader->node >= reader->numNodes) return NULL;
+
+  int type = reader->nodes[reader->node * 2];
+  uint32_t count = reader->nodes[reader->node * 2 + 1];
+  reader->node++;
+
+  if (type == GEOS_POINT || type == GEOS_LINESTRING || type == GEOS_LINEARRING) {
+    if (count > reader->numCoords - reader->coord || (type == GEOS_POINT && count > 1)) return NULL;
+
+    if (count == 0 && type == GEOS_POINT) return GEOSGeom_createEmptyPoint_r(handle);
+    if (count == 0 && type == GEOS_LINESTRING) return GEOSGeom_createEmptyLineString_r(handle);
+
+    const double* coords = reader->coords + reader->coord * reader->dims;
+    GEOSCoordSequence* cs = GEOSCoordSeq_copyFromBuffer_r(handle, coords, count, reader->dims == 3, 0);
+    reader->coord += count;
+
+    // Sequence is owned by geometry, even on failure:
+    switch (type) {
+      case GEOS_POINT: return GEOSGeom_createPoint_r(handle, cs);
+      case GEOS_LINESTRING: return GEOSGeom_createLineString_r(handle, cs);
+      default: return GEOSGeom_createLinearRing_r(handle, cs);
+    }
+  }
+
+  // Each part is at least one node:
+  if (count > reader->numNodes - reader->node) return NULL;
+
+  int partType;
+  switch (type) {
+    case GEOS_POLYGON: partType = GEOS_LINEARRING; break;
+    case GEOS_MULTIPOINT: partType = GEOS_POINT; break;
+    case GEOS_MULTILINESTRING: partType = GEOS_LINESTRING; break;
+    case GEOS_MULTIPOLYGON: partType = GEOS_POLYGON; break;
+    case GEOS_GEOMETRYCOLLECTION: partType = -1; break;
+    default: return NULL;
+  }
+
+  std::vector<GEOSGeometry*> parts;
+  parts.reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    GEOSGeometry* part = ReadShared(handle, reader, depth + 1);
+    if (part != NULL) parts.push_back(part);
+    if (part == NULL || (partType != -1 && GEOSGeomTypeId_r(handle, part) != partType)) {
+      DestroyAll(handle, parts);
+      return NULL;
+    }
+  }
+
+  if (type != GEOS_POLYGON) {
+    return GEOSGeom_createCollection_r(handle, type, parts.data(), count);
+  }
+
+  if (count == 0) return GEOSGeom_createEmptyPolygon_r(handle);
+  return GEOSGeom_createPolygon_r(handle, parts[0], parts.data() + 1, count - 1);
+}
+
+/**
+ * Create geometry from SharedArrayBuffer written by Geometry::toShared(),
+ * possibly on another thread; coordinates are copied once.
+ * info[0] : SharedArrayBuffer
+ */
+Napi::Value FromShared(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("GEOS::fromShared");
+  GEOSContextHandle_t handle = GetContext()->handle;
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: SharedArrayBuffer").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Function SharedArrayBuffer = env.Global().Get("SharedArrayBuffer").As<Napi::Function>();
+  if (!info[0].IsObject() || !info[0].As<Napi::Object>().InstanceOf(SharedArrayBuffer)) {
+    Napi::TypeError::New(env, "Invalid argument: SharedArrayBuffer").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Function Uint8Array = env.Global().Get("Uint8Array").As<Napi::Function>();
+  Napi::Uint8Array view = Uint8Array.New({ info[0] }).As<Napi::Uint8Array>();
+  const uint8_t* data = view.Data();
+  size_t length = view.ByteLength();
+
+  // Other threads may write the buffer concurrently; validate and use one snapshot:
+  SharedHeader header;
+  bool valid = length >= sizeof(SharedHeader);
+  if (valid) memcpy(&header, data, sizeof(SharedHeader));
+  valid = valid &&
+    memcmp(header.magic, SHARED_MAGIC, sizeof(SHARED_MAGIC)) == 0 &&
+    (header.dims == 2 || header.dims == 3);
+
+  // Sections must fit (checked without overflow):
+  size_t available = valid ? length - sizeof(SharedHeader) : 0;
+  if (valid) valid = header.numNodes <= available / (2 * sizeof(uint32_t));
+  if (valid) available -= header.numNodes * 2 * sizeof(uint32_t);
+  if (valid) valid = header.numCoords <= available / (header.dims * sizeof(double));
+
+  GEOSGeometry* geometry = NULL;
+  if (valid) {
+    const double* coords = (const double*)(data + sizeof(SharedHeader));
+    const uint32_t* nodes = (const uint32_t*)(coords + header.numCoords * header.dims);
+    SharedReader reader = { nodes, coords, header.dims, header.numNodes, header.numCoords, 0, 0 };
+    geometry = ReadShared(handle, &reader, 0);
+
+    // Everything must be consumed:
+    if (geometry != NULL && (reader.node != reader.numNodes || reader.coord != reader.numCoords)) {
+      GEOSGeom_destroy_r(handle, geometry);
+      geometry = NULL;
+    }
+  }
+
+  if (geometry == NULL) {
+    Napi::Error::New(env, "Invalid shared geometry").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  GEOSSetSRID_r(handle, geometry, header.srid);
+  Napi::External<GEOSGeometry> external = Napi::External<GEOSGeometry>::New(env, geometry);
+  return Geometry::NewInstance(env, external);
+}
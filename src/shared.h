@@ -0,0 +1,31 @@
+#ifndef __SHARED_H
+#define __SHARED_H
+
+#include <napi.h>
+#include <geos_c.h>
+#include <stdint.h>
+
+/**
+ * Geometry in a SharedArrayBuffer, for exchange between worker threads
+ * (native byte order):
+ *
+ *   header  SharedHeader
+ *   coords  double[numCoords * dims] - interleaved, in node order
+ *   nodes   uint32[numNodes * 2] - (type, count), geometries in pre-order
+ *
+ * count is number of coordinates for Point, LineString and LinearRing,
+ * number of rings (LinearRing nodes) for Polygon and number of parts
+ * for multi geometries and collections.
+ */
+struct SharedHeader {
+  char magic[4];
+  uint32_t dims;
+  int32_t srid;
+  uint32_t numNodes;
+  uint64_t numCoords;
+};
+
+Napi::Value ToShared(Napi::Env env, const GEOSGeometry* geometry);
+Napi::Value FromShared(const Napi::CallbackInfo& info);
+
+#endif /* __SHARED_H */
@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <cmath>
+#include "spatialindex.h"
+#include "instance.h"
+#include "geometry.h"
+#include "context.h"
+#include "stats.h"
+#include "async.h"
+
+/**
+ * Collects indexes of items matching a query.
+ */
+static void query_callback(void *item, void *userdata) {
+  std::vector<uint32_t>* hits = (std::vector<uint32_t>*)userdata;
+  hits->push_back((uint32_t)(uintptr_t)item - 1);
+}
+
+/**
+ * Construct a rectangular Polygon from envelope coordinates.
+ */
+GEOSGeometry* CreateRectangle(
+  GEOSContextHandle_t handle,
+  double minx,
+  double miny,
+  double maxx,
+  double maxy
+) {
+  GEOSCoordSequence* cs = GEOSCoordSeq_create_r(handle, 5, 2);
+  GEOSCoordSeq_setXY_r(handle, cs, 0, minx, miny);
+  GEOSCoordSeq_setXY_r(handle, cs, 1, maxx, miny);
+  GEOSCoordSeq_setXY_r(handle, cs, 2, maxx, maxy);
+  GEOSCoordSeq_setXY_r(handle, cs, 3, minx, maxy);
+  GEOSCoordSeq_setXY_r(handle, cs, 4, minx, miny);
+  GEOSGeometry* shell = GEOSGeom_createLinearRing_r(handle, cs);
+  return GEOSGeom_createPolygon_r(handle, shell, NULL, 0);
+}
+
+Napi::Object SpatialIndex::Init(Napi::Env env, Napi::Object exports) {
+  Napi::HandleScope scope(env);
+
+  Napi::Function func = DefineClass(env, "SpatialIndex", {
+    InstanceMethod("getNumItems", &SpatialIndex::GetNumItems),
+    InstanceMethod("query", &SpatialIndex::Query),
+    InstanceMethod("nearest", &SpatialIndex::Nearest)
+  });
+
+  GetInstanceData(env)->spatialIndex = Napi::Persistent(func);
+  return exports;
+}
+
+Napi::Object SpatialIndex::NewInstance(Napi::Env env, Napi::Value items, Napi::Number nodeCapacity) {
+  Napi::EscapableHandleScope scope(env);
+  Napi::Object object = GetInstanceData(env)->spatialIndex.New({ items, nodeCapacity });
+  return scope.Escape(napi_value(object)).ToObject();
+}
+
+/**
+ * Bulk-load tree; arguments are validated by GEOS::createSpatialIndex().
+ * info[0] : [Geometry] | Float64Array - [minx, miny, maxx, maxy, ...]
+ * info[1] : int32 - node capacity
+ */
+SpatialIndex::SpatialIndex(const Napi::CallbackInfo& info) : Napi::ObjectWrap<SpatialIndex>(info) {
+  Napi::Env env = info.Env();
+  Napi::HandleScope scope(env);
+  GEOSContextHandle_t handle = GetContext()->handle;
+
+  int nodeCapacity = info[1].As<Napi::Number>().Int32Value();
+  this->tree = GEOSSTRtree_create_r(handle, nodeCapacity);
+
+  if (info[0].IsTypedArray()) {
+    Napi::Float64Array input = info[0].As<Napi::Float64Array>();
+    const double* envelope = input.Data();
+    this->size = input.ElementLength() / 4;
+    this->envelopes.reserve(this->size);
+
+    for (uint32_t i = 0; i < this->size; i++, envelope += 4) {
+      GEOSGeometry* rectangle = CreateRectangle(handle, envelope[0], envelope[1], envelope[2], envelope[3]);
+      this->envelopes.push_back(rectangle);
+      GEOSSTRtree_insert_r(handle, this->tree, rectangle, (void*)(uintptr_t)(i + 1));
+    }
+  } else {
+    Napi::Array input = info[0].As<Napi::Array>();
+    this->size = input.Length();
+    this->geometries.reserve(this->size);
+    this->pins.reserve(this->size);
+
+    // Private copy of input array keeps geometries alive:
+    Napi::Array array = Napi::Array::New(env, this->size);
+
+    for (uint32_t i = 0; i < this->size; i++) {
+      Napi::Value value = input[i];
+      Geometry* geometry = Geometry::Unwrap(value.As<Napi::Object>());
+      array.Set(i, value);
+      this->geometries.push_back(geometry->geometry);
+      this->pins.push_back(geometry->Pin());
+      GEOSSTRtree_insert_r(handle, this->tree, geometry->geometry, (void*)(uintptr_t)(i + 1));
+    }
+
+    this->items = Napi::Persistent(array.As<Napi::Object>());
+  }
+
+  this->BuildNearest(handle, nodeCapacity);
+}
+
+SpatialIndex::~SpatialIndex() {
+  GEOSContextHandle_t handle = GetContext()->handle;
+  GEOSSTRtree_destroy_r(handle, this->tree);
+
+  for (size_t i = 0; i < this->envelopes.size(); i++) {
+    GEOSGeom_destroy_r(handle, this->envelopes[i]);
+  }
+
+  for (size_t i = 0; i < this->pins.size(); i++) {
+    Geometry::Unpin(this->pins[i]);
+  }
+}
+
+
+/**
+ *
+ */
+Napi::Value SpatialIndex::GetNumItems(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), this->size);
+}
+
+
+/**
+ * Return indexes of items whose envelopes intersect query envelope;
+ * in ascending order.
+ * info[0] : Geometry | Float64Array - [minx, miny, maxx, maxy]
+ */
+Napi::Value SpatialIndex::Query(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("SpatialIndex::query");
+  GEOSContextHandle_t handle = GetContext()->handle;
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: Geometry | envelope").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::vector<uint32_t> hits;
+
+  if (info[0].IsTypedArray()) {
+    Napi::TypedArray array = info[0].As<Napi::TypedArray>();
+    if (array.TypedArrayType() != napi_float64_array || array.ElementLength() != 4) {
+      Napi::TypeError::New(env, "Invalid argument: envelope").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    const double* envelope = info[0].As<Napi::Float64Array>().Data();
+    GEOSGeometry* rectangle = CreateRectangle(handle, envelope[0], envelope[1], envelope[2], envelope[3]);
+    GEOSSTRtree_query_r(handle, this->tree, rectangle, query_callback, &hits);
+    GEOSGeom_destroy_r(handle, rectangle);
+  } else {
+    // Throws "Error: Invalid argument" if not a Geometry object:
+    Geometry* geometry = Geometry::Unwrap(info[0].As<Napi::Object>());
+    GEOSSTRtree_query_r(handle, this->tree, geometry->geometry, query_callback, &hits);
+  }
+
+  std::sort(hits.begin(), hits.end());
+  Napi::Uint32Array result = Napi::Uint32Array::New(env, hits.size());
+  std::copy(hits.begin(), hits.end(), result.Data());
+  return result;
+}
+
+
+const GEOSGeometry* SpatialIndex::Item(uint32_t i) {
+  return this->geometries.empty() ? this->envelopes[i] : this->geometries[i];
+}
+
+/**
+ * Pack item envelopes (inverted for empty items) into nearestTree.
+ */
+void SpatialIndex::BuildNearest(GEOSContextHandle_t handle, uint32_t nodeCapacity) {
+  std::vector<const GEOSGeometry*> items(this->size);
+  std::vector<double> envelopes(this->size * 4);
+
+  for (uint32_t i = 0; i < this->size; i++) {
+    items[i] = this->Item(i);
+    double* envelope = envelopes.data() + i * 4;
+
+    if (GEOSisEmpty_r(handle, items[i])) {
+      envelope[0] = envelope[1] = INFINITY;
+      envelope[2] = envelope[3] = -INFINITY;
+    } else {
+      GEOSGeom_getXMin_r(handle, items[i], &envelope[0]);
+      GEOSGeom_getYMin_r(handle, items[i], &envelope[1]);
+      GEOSGeom_getXMax_r(handle, items[i], &envelope[2]);
+      GEOSGeom_getYMax_r(handle, items[i], &envelope[3]);
+    }
+  }
+
+  std::vector<uint32_t> levelBounds;
+  uint32_t numNodes = PackedRTree::LevelBounds(this->size, nodeCapacity, levelBounds);
+  this->boxes.resize(numNodes * 4);
+  this->indices.resize(numNodes);
+  std::vector<uint32_t> order = HilbertOrder(handle, items);
+  PackedRTree::Pack(envelopes.data(), order, nodeCapacity, levelBounds, this->boxes.data(), this->indices.data());
+  this->nearestTree.Assign(this->boxes.data(), this->indices.data(), this->size, nodeCapacity);
+}
+
+struct NearestQuery {
+  SpatialIndex* index;
+  GEOSContextHandle_t handle;
+  const GEOSPreparedGeometry* prepared;
+};
+
+bool SpatialIndex::NearestDistance(uint32_t item, double* distance, void* userdata) {
+  NearestQuery* query = (NearestQuery*)userdata;
+  return GEOSPreparedDistance_r(query->handle, query->prepared, query->index->Item(item), distance) == 1;
+}
+
+/**
+ * Append up to k nearest items of (non-empty) geometry, nearest first;
+ * see PackedRTree::Nearest(). Returns false on GEOS error.
+ */
+bool SpatialIndex::FindNearest(GEOSContextHandle_t handle, const GEOSGeometry* geometry, uint32_t k, std::vector<uint32_t>& found) {
+  double envelope[4];
+  GEOSGeom_getXMin_r(handle, geometry, &envelope[0]);
+  GEOSGeom_getYMin_r(handle, geometry, &envelope[1]);
+  GEOSGeom_getXMax_r(handle, geometry, &envelope[2]);
+  GEOSGeom_getYMax_r(handle, geometry, &envelope[3]);
+
+  NearestQuery query = { this, handle, GEOSPrepare_r(handle, geometry) };
+  bool ok = this->nearestTree.Nearest(envelope, k, &SpatialIndex::NearestDistance, &query, found);
+  GEOSPreparedGeom_destroy_r(handle, query.prepared);
+  return ok;
+}
+
+
+/**
+ * Return indexes of up to k nearest items by distance, nearest first;
+ * ties by ascending index, empty items are never returned.
+ * For an array of n geometries, returns their nearest items in one
+ * Uint32Array of n rows of min(k, numItems) indexes; rows are padded
+ * with 0xFFFFFFFF where less items are found (e.g. for empty geometries).
+ * info[0] : Geometry | [Geometry]
+ * info[1] : uint32 - k (optional, default 1)
+ */
+Napi::Value SpatialIndex::Nearest(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  StatsScope stats("SpatialIndex::nearest");
+  Context* context = GetContext();
+  GEOSContextHandle_t handle = context->handle;
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: Geometry | [Geometry]").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  uint32_t k = 1;
+  if (info.Length() > 1 && !info[1].IsUndefined()) {
+    if (!info[1].IsNumber()) {
+      Napi::TypeError::New(env, "Invalid argument: k").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    double value = info[1].As<Napi::Number>().DoubleValue();
+    if (!(value >= 1) || value != std::floor(value)) {
+      Napi::Error::New(env, "Invalid range: k").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    k = (uint32_t)std::min(value, (double)UINT32_MAX);
+  }
+
+  // Throws "Error: Invalid argument" if not a Geometry object:
+  bool batch = info[0].IsArray();
+  std::vector<const GEOSGeometry*> geometries;
+  if (batch) {
+    Napi::Array input = info[0].As<Napi::Array>();
+    geometries.resize(input.Length());
+    for (uint32_t i = 0; i < geometries.size(); i++) {
+      Napi::Value value = input[i];
+      geometries[i] = Geometry::Unwrap(value.As<Napi::Object>())->geometry;
+    }
+  } else {
+    geometries.push_back(Geometry::Unwrap(info[0].As<Napi::Object>())->geometry);
+  }
+
+  uint32_t rowLength = std::min(k, this->size);
+  std::vector<uint32_t> result;
+  result.reserve(geometries.size() * rowLength);
+  context->last_error[0] = '\0';
+
+  for (size_t i = 0; i < geometries.size(); i++) {
+    size_t begin = result.size();
+    if (!GEOSisEmpty_r(handle, geometries[i]) && !this->FindNearest(handle, geometries[i], rowLength, result)) {
+      Napi::Error::New(env, context->last_error).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    if (batch) result.resize(begin + rowLength, UINT32_MAX);
+  }
+
+  Napi::Uint32Array array = Napi::Uint32Array::New(env, result.size());
+  std::copy(result.begin(), result.end(), array.Data());
+  return array;
+}
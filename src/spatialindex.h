@@ -0,0 +1,56 @@
+#ifndef __SPATIALINDEX_H
+#define __SPATIALINDEX_H
+
+#include <napi.h>
+#include <geos_c.h>
+#include <vector>
+#include <memory>
+#include "rtree.h"
+
+/**
+ * Immutable STRtree over geometries or envelopes;
+ * items are identified by their index in the input
+ * (stored offset by one, so item 0 is not NULL).
+ */
+class SpatialIndex : public Napi::ObjectWrap<SpatialIndex> {
+ public:
+  GEOSSTRtree *tree;
+  static Napi::Object Init(Napi::Env env, Napi::Object exports);
+  static Napi::Object NewInstance(Napi::Env env, Napi::Value items, Napi::Number nodeCapacity);
+  SpatialIndex(const Napi::CallbackInfo& info);
+  ~SpatialIndex();
+
+  Napi::Value GetNumItems(const Napi::CallbackInfo& info);
+  Napi::Value Query(const Napi::CallbackInfo& info);
+  Napi::Value Nearest(const Napi::CallbackInfo& info);
+
+ private:
+  // Geometries are referenced (not owned) by tree;
+  // envelope rectangles are owned by index:
+  Napi::ObjectReference items;
+  std::vector<const GEOSGeometry*> geometries;
+  std::vector<std::shared_ptr<int>> pins;
+  std::vector<GEOSGeometry*> envelopes;
+  uint32_t size;
+
+  // Packed Hilbert R-tree for k-nearest search (GEOSSTRtree nodes are
+  // not accessible through C API); nodes are owned by index:
+  std::vector<double> boxes;
+  std::vector<uint32_t> indices;
+  PackedRTree nearestTree;
+
+  const GEOSGeometry* Item(uint32_t i);
+  void BuildNearest(GEOSContextHandle_t handle, uint32_t nodeCapacity);
+  static bool NearestDistance(uint32_t item, double* distance, void* userdata);
+  bool FindNearest(GEOSContextHandle_t handle, const GEOSGeometry* geometry, uint32_t k, std::vector<uint32_t>& found);
+};
+
+GEOSGeometry* CreateRectangle(
+  GEOSContextHandle_t handle,
+  double minx,
+  double miny,
+  double maxx,
+  double maxy
+);
+
+#endif /* __SPATIALINDEX_H */
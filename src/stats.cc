@@ -0,0 +1,112 @@
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "stats.h"
+#include "context.h"
+
+std::atomic<bool> statsEnabled(false);
+
+struct OperationStats {
+  int64_t count;
+  int64_t totalTime; // ns
+  int64_t maxTime; // ns
+  int64_t vertices;
+};
+
+// Guards operations map; written from main and thread pool threads:
+static std::mutex mutex;
+static std::unordered_map<std::string, OperationStats> operations;
+static std::atomic<int64_t> created(0);
+static std::atomic<int64_t> destroyed(0);
+
+void StatsRecord(const char* name, int64_t nanos, int64_t vertices) {
+  std::lock_guard<std::mutex> lock(mutex);
+  OperationStats& stats = operations[name];
+  stats.count++;
+  stats.totalTime += nanos;
+  if (nanos > stats.maxTime) stats.maxTime = nanos;
+  stats.vertices += vertices;
+}
+
+// Geometries are always counted, so created - destroyed is the number
+// of live geometries regardless of when statistics were enabled:
+void StatsGeometryCreated() {
+  created.fetch_add(1, std::memory_order_relaxed);
+}
+
+void StatsGeometryDestroyed() {
+  destroyed.fetch_add(1, std::memory_order_relaxed);
+}
+
+StatsScope::StatsScope(const char* name, const GEOSGeometry* input) : name(NULL), vertices(0) {
+  if (!StatsEnabled()) return;
+
+  this->name = name;
+  if (input != NULL) {
+    int count = GEOSGetNumCoordinates_r(GetContext()->handle, input);
+    if (count > 0) this->vertices = count;
+  }
+
+  this->start = std::chrono::steady_clock::now();
+}
+
+StatsScope::~StatsScope() {
+  if (this->name == NULL) return;
+
+  std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - this->start;
+  StatsRecord(this->name, elapsed.count(), this->vertices);
+}
+
+
+/**
+ * Turn statistics on or off; collected values are kept.
+ * info[0] : Boolean - enabled (optional, default: true)
+ */
+Napi::Value EnableStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  bool enabled = info.Length() < 1 || info[0].ToBoolean();
+  statsEnabled.store(enabled);
+  return env.Undefined();
+}
+
+/**
+ * Snapshot of statistics; times in milliseconds:
+ * { enabled, operations: { [name]: { count, totalTime, maxTime, vertices } },
+ *   geometries: { created, destroyed } }
+ * Geometry counters are cumulative since startup, even while disabled.
+ */
+Napi::Value GetStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  Napi::Object result = Napi::Object::New(env);
+  Napi::Object ops = Napi::Object::New(env);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = operations.begin(); it != operations.end(); ++it) {
+      Napi::Object stats = Napi::Object::New(env);
+      stats.Set("count", Napi::Number::New(env, it->second.count));
+      stats.Set("totalTime", Napi::Number::New(env, it->second.totalTime / 1e6));
+      stats.Set("maxTime", Napi::Number::New(env, it->second.maxTime / 1e6));
+      stats.Set("vertices", Napi::Number::New(env, it->second.vertices));
+      ops.Set(it->first, stats);
+    }
+  }
+
+  Napi::Object geometries = Napi::Object::New(env);
+  geometries.Set("created", Napi::Number::New(env, created.load()));
+  geometries.Set("destroyed", Napi::Number::New(env, destroyed.load()));
+
+  result.Set("enabled", Napi::Boolean::New(env, StatsEnabled()));
+  result.Set("operations", ops);
+  result.Set("geometries", geometries);
+  return result;
+}
+
+/**
+ * Clear operation statistics; geometry counters are kept.
+ */
+Napi::Value ResetStats(const Napi::CallbackInfo& info) {
+  std::lock_guard<std::mutex> lock(mutex);
+  operations.clear();
+  return info.Env().Undefined();
+}
@@ -0,0 +1,44 @@
+#ifndef __STATS_H
+#define __STATS_H
+
+#include <napi.h>
+#include <geos_c.h>
+#include <atomic>
+#include <chrono>
+
+/**
+ * Opt-in operation statistics (GEOS.enableStats()).
+ * When disabled, recording costs one relaxed atomic load.
+ */
+extern std::atomic<bool> statsEnabled;
+
+inline bool StatsEnabled() {
+  return statsEnabled.load(std::memory_order_relaxed);
+}
+
+void StatsRecord(const char* name, int64_t nanos, int64_t vertices);
+void StatsGeometryCreated();
+void StatsGeometryDestroyed();
+
+/**
+ * Records call count, native time and input vertices of enclosing scope.
+ * name must be a string literal (static storage).
+ */
+class StatsScope {
+ public:
+  StatsScope(const char* name, const GEOSGeometry* input = NULL);
+  ~StatsScope();
+  StatsScope(const StatsScope&) = delete;
+  StatsScope& operator=(const StatsScope&) = delete;
+
+ private:
+  const char* name;
+  int64_t vertices;
+  std::chrono::steady_clock::time_point start;
+};
+
+Napi::Value EnableStats(const Napi::CallbackInfo& info);
+Napi::Value GetStats(const Napi::CallbackInfo& info);
+Napi::Value ResetStats(const Napi::CallbackInfo& info);
+
+#endif /* __STATS_H */
@@ -1,23 +1,38 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
 #include "transform.h"
+#include "context.h"
 
+struct TransformData {
+  Napi::Env env;
+  Napi::Function fn;
+};
+
+/**
+ * Transform coordinates through JS callback fn(x, y) => [x, y].
+ */
 GEOSCoordSequence* TransformCoordSeq(
-  Napi::Env env,
-  Napi::Function fn,
-  const GEOSCoordSequence* cs
+  GEOSContextHandle_t handle,
+  const GEOSCoordSequence* cs,
+  void* userdata
 )
 {
-	GEOSCoordSequence* coordSeq = GEOSCoordSeq_clone(cs);
+	TransformData* data = (TransformData*)userdata;
+	Napi::Env env = data->env;
+	Napi::Function fn = data->fn;
+	GEOSCoordSequence* coordSeq = GEOSCoordSeq_clone_r(handle, cs);
 
   unsigned int size; // number of points, e.g. 75 points
   unsigned int dims; // dimension of one point, e.g. 2 dimensions, X and Y
 
-  GEOSCoordSeq_getSize(coordSeq, &size);
-  GEOSCoordSeq_getDimensions(coordSeq, &dims);
+  GEOSCoordSeq_getSize_r(handle, coordSeq, &size);
+  GEOSCoordSeq_getDimensions_r(handle, coordSeq, &dims);
 
   double x;
   double y;
   for (unsigned int i = 0; i < size; i++) {
-    GEOSCoordSeq_getXY(coordSeq, i, &x, &y);
+    GEOSCoordSeq_getXY_r(handle, coordSeq, i, &x, &y);
     Napi::Object result = fn.Call(env.Global(), {
       Napi::Number::New(env, x),
       Napi::Number::New(env, y)
@@ -25,7 +40,8 @@ GEOSCoordSequence* TransformCoordSeq(
 
     Napi::Value vx = result[(uint32_t)0];
     Napi::Value vy = result[(uint32_t)1];
-    GEOSCoordSeq_setXY(
+    GEOSCoordSeq_setXY_r(
+      handle,
       coordSeq,
       i,
       vx.As<Napi::Number>().DoubleValue(),
@@ -36,7 +52,200 @@ GEOSCoordSequence* TransformCoordSeq(
   return coordSeq;
 }
 
+/**
+ * Transform coordinates through JS callback fn(coords, dims), invoked once
+ * per sequence with interleaved Float64Array which is modified in place.
+ */
+GEOSCoordSequence* TransformBatchCoordSeq(
+  GEOSContextHandle_t handle,
+  const GEOSCoordSequence* cs,
+  void* userdata
+)
+{
+  TransformData* data = (TransformData*)userdata;
+  Napi::Env env = data->env;
+  Napi::HandleScope scope(env);
+  unsigned int size;
+  unsigned int dims;
+
+  GEOSCoordSeq_getSize_r(handle, cs, &size);
+  GEOSCoordSeq_getDimensions_r(handle, cs, &dims);
+
+  int hasZ = dims > 2;
+  unsigned int stride = hasZ ? 3 : 2;
+  Napi::Float64Array coords = Napi::Float64Array::New(env, size * stride);
+  GEOSCoordSeq_copyToBuffer_r(handle, cs, coords.Data(), hasZ, 0);
+
+  data->fn.Call(env.Global(), { coords, Napi::Number::New(env, stride) });
+  return GEOSCoordSeq_copyFromBuffer_r(handle, coords.Data(), size, hasZ, 0);
+}
+
+/**
+ * Apply affine matrix [a, b, c, d, e, f, g, h, i, xoff, yoff, zoff]:
+ * x' = a * x + b * y + c * z + xoff
+ * y' = d * x + e * y + f * z + yoff
+ * z' = g * x + h * y + i * z + zoff
+ * Coordinates are processed in place in one interleaved buffer.
+ */
+GEOSCoordSequence* AffineCoordSeq(
+  GEOSContextHandle_t handle,
+  const GEOSCoordSequence* cs,
+  void* userdata
+)
+{
+  const double* m = (const double*)userdata;
+  unsigned int size;
+  unsigned int dims;
+
+  GEOSCoordSeq_getSize_r(handle, cs, &size);
+  GEOSCoordSeq_getDimensions_r(handle, cs, &dims);
+
+  int hasZ = dims > 2;
+  std::vector<double> buffer(size * (hasZ ? 3 : 2));
+  GEOSCoordSeq_copyToBuffer_r(handle, cs, buffer.data(), hasZ, 0);
+  double* p = buffer.data();
+
+  if (hasZ) {
+    for (unsigned int i = 0; i < size; i++, p += 3) {
+      double x = p[0], y = p[1], z = p[2];
+      p[0] = m[0] * x + m[1] * y + m[2] * z + m[9];
+      p[1] = m[3] * x + m[4] * y + m[5] * z + m[10];
+      p[2] = m[6] * x + m[7] * y + m[8] * z + m[11];
+    }
+  } else {
+    const double a = m[0], b = m[1], d = m[3], e = m[4];
+    const double xoff = m[9], yoff = m[10];
+    for (unsigned int i = 0; i < size; i++, p += 2) {
+      double x = p[0], y = p[1];
+      p[0] = a * x + b * y + xoff;
+      p[1] = d * x + e * y + yoff;
+    }
+  }
+
+  return GEOSCoordSeq_copyFromBuffer_r(handle, buffer.data(), size, hasZ, 0);
+}
+
 GEOSGeometry* TransformGeom(Napi::Env env, Napi::Function fn, const GEOSGeometry* g1) {
+	TransformData data = { env, fn };
+	return MapGeom(GetContext()->handle, TransformCoordSeq, &data, g1);
+}
+
+GEOSGeometry* TransformBatchGeom(Napi::Env env, Napi::Function fn, const GEOSGeometry* g1) {
+	TransformData data = { env, fn };
+	return MapGeom(GetContext()->handle, TransformBatchCoordSeq, &data, g1);
+}
+
+GEOSGeometry* AffineGeom(GEOSContextHandle_t handle, const double matrix[12], const GEOSGeometry* g1) {
+	GEOSGeometry* g2 = MapGeom(handle, AffineCoordSeq, (void*)matrix, g1);
+	if (g2 != NULL) GEOSSetSRID_r(handle, g2, GEOSGetSRID_r(handle, g1));
+	return g2;
+}
+
+/**
+ * info[0] : double - xoff
+ * info[1] : double - yoff
+ * info[2] : double - zoff (optional)
+ */
+bool TranslateMatrix(const Napi::CallbackInfo& info, double matrix[12]) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2) {
+    Napi::Error::New(env, "Missing argument(s): xoff, yoff").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  if (!info[0].IsNumber() || !info[1].IsNumber() || (info.Length() > 2 && !info[2].IsNumber())) {
+    Napi::TypeError::New(env, "Invalid argument: offset").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  const double values[12] = {
+    1.0, 0.0, 0.0,
+    0.0, 1.0, 0.0,
+    0.0, 0.0, 1.0,
+    info[0].As<Napi::Number>().DoubleValue(),
+    info[1].As<Napi::Number>().DoubleValue(),
+    info.Length() > 2 ? info[2].As<Napi::Number>().DoubleValue() : 0.0
+  };
+
+  std::copy(values, values + 12, matrix);
+  return true;
+}
+
+/**
+ * Scale relative to origin (0, 0, 0).
+ * info[0] : double - xfact
+ * info[1] : double - yfact
+ * info[2] : double - zfact (optional)
+ */
+bool ScaleMatrix(const Napi::CallbackInfo& info, double matrix[12]) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2) {
+    Napi::Error::New(env, "Missing argument(s): xfact, yfact").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  if (!info[0].IsNumber() || !info[1].IsNumber() || (info.Length() > 2 && !info[2].IsNumber())) {
+    Napi::TypeError::New(env, "Invalid argument: factor").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  const double values[12] = {
+    info[0].As<Napi::Number>().DoubleValue(), 0.0, 0.0,
+    0.0, info[1].As<Napi::Number>().DoubleValue(), 0.0,
+    0.0, 0.0, info.Length() > 2 ? info[2].As<Napi::Number>().DoubleValue() : 1.0,
+    0.0, 0.0, 0.0
+  };
+
+  std::copy(values, values + 12, matrix);
+  return true;
+}
+
+/**
+ * Rotate counter-clockwise around Z axis.
+ * info[0] : double - angle in radians
+ * info[1] : double - origin x (optional, default 0)
+ * info[2] : double - origin y (optional, default 0)
+ */
+bool RotateMatrix(const Napi::CallbackInfo& info, double matrix[12]) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1) {
+    Napi::Error::New(env, "Missing argument: angle").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  for (size_t i = 0; i < info.Length() && i < 3; i++) {
+    if (!info[i].IsNumber()) {
+      Napi::TypeError::New(env, "Invalid argument: angle, x, y").ThrowAsJavaScriptException();
+      return false;
+    }
+  }
+
+  double angle = info[0].As<Napi::Number>().DoubleValue();
+  double x0 = info.Length() > 1 ? info[1].As<Napi::Number>().DoubleValue() : 0.0;
+  double y0 = info.Length() > 2 ? info[2].As<Napi::Number>().DoubleValue() : 0.0;
+  double cosa = std::cos(angle);
+  double sina = std::sin(angle);
+
+  const double values[12] = {
+    cosa, -sina, 0.0,
+    sina, cosa, 0.0,
+    0.0, 0.0, 1.0,
+    x0 - x0 * cosa + y0 * sina,
+    y0 - x0 * sina - y0 * cosa,
+    0.0
+  };
+
+  std::copy(values, values + 12, matrix);
+  return true;
+}
+
+/**
+ * Rebuild geometry with each coordinate sequence mapped through fn.
+ */
+GEOSGeometry* MapGeom(GEOSContextHandle_t handle, coordseq_fn_t fn, void* userdata, const GEOSGeometry* g1) {
 	GEOSCoordSequence* cs;
 	GEOSGeometry* g2;
 	GEOSGeometry* shell;
@@ -46,37 +255,37 @@ GEOSGeometry* TransformGeom(Napi::Env env, Napi::Function fn, const GEOSGeometry
 	int type;
 
 	/* Geometry reconstruction from CoordSeq */
-	type = GEOSGeomTypeId(g1);
+	type = GEOSGeomTypeId_r(handle, g1);
 
 	switch ( type )
 	{
 		case GEOS_POINT:
-			cs = TransformCoordSeq(env, fn, GEOSGeom_getCoordSeq(g1));
-			g2 = GEOSGeom_createPoint(cs);
+			cs = fn(handle, GEOSGeom_getCoordSeq_r(handle, g1), userdata);
+			g2 = GEOSGeom_createPoint_r(handle, cs);
 			return g2;
 			break;
 		case GEOS_LINESTRING:
-			cs = TransformCoordSeq(env, fn, GEOSGeom_getCoordSeq(g1));
-			g2 = GEOSGeom_createLineString(cs);
+			cs = fn(handle, GEOSGeom_getCoordSeq_r(handle, g1), userdata);
+			g2 = GEOSGeom_createLineString_r(handle, cs);
 			return g2;
 			break;
 		case GEOS_LINEARRING:
-			cs = TransformCoordSeq(env, fn, GEOSGeom_getCoordSeq(g1));
-			g2 = GEOSGeom_createLinearRing(cs);
+			cs = fn(handle, GEOSGeom_getCoordSeq_r(handle, g1), userdata);
+			g2 = GEOSGeom_createLinearRing_r(handle, cs);
 			return g2;
 			break;
 		case GEOS_POLYGON:
-			gtmp = GEOSGetExteriorRing(g1);
-			cs = TransformCoordSeq(env, fn, GEOSGeom_getCoordSeq(gtmp));
-			shell = GEOSGeom_createLinearRing(cs);
-			ngeoms = GEOSGetNumInteriorRings(g1);
+			gtmp = GEOSGetExteriorRing_r(handle, g1);
+			cs = fn(handle, GEOSGeom_getCoordSeq_r(handle, gtmp), userdata);
+			shell = GEOSGeom_createLinearRing_r(handle, cs);
+			ngeoms = GEOSGetNumInteriorRings_r(handle, g1);
 			geoms = (GEOSGeometry**)malloc(ngeoms * sizeof(GEOSGeometry*));
 			for (i = 0; i < ngeoms; i++) {
-				gtmp = GEOSGetInteriorRingN(g1, i);
-				cs = TransformCoordSeq(env, fn, GEOSGeom_getCoordSeq(gtmp));
-				geoms[i] = GEOSGeom_createLinearRing(cs);
+				gtmp = GEOSGetInteriorRingN_r(handle, g1, i);
+				cs = fn(handle, GEOSGeom_getCoordSeq_r(handle, gtmp), userdata);
+				geoms[i] = GEOSGeom_createLinearRing_r(handle, cs);
 			}
-			g2 = GEOSGeom_createPolygon(shell, geoms, ngeoms);
+			g2 = GEOSGeom_createPolygon_r(handle, shell, geoms, ngeoms);
 			free(geoms);
 			return g2;
 			break;
@@ -84,13 +293,13 @@ GEOSGeometry* TransformGeom(Napi::Env env, Napi::Function fn, const GEOSGeometry
 		case GEOS_MULTILINESTRING:
 		case GEOS_MULTIPOLYGON:
 		case GEOS_GEOMETRYCOLLECTION:
-			ngeoms = GEOSGetNumGeometries(g1);
+			ngeoms = GEOSGetNumGeometries_r(handle, g1);
 			geoms = (GEOSGeometry**)malloc(ngeoms*sizeof(GEOSGeometry*));
 			for (i = 0; i < ngeoms; i++) {
-				gtmp = GEOSGetGeometryN(g1, i);
-				geoms[i] = TransformGeom(env, fn, gtmp);
+				gtmp = GEOSGetGeometryN_r(handle, g1, i);
+				geoms[i] = MapGeom(handle, fn, userdata, gtmp);
 			}
-			g2 = GEOSGeom_createCollection(type, geoms, ngeoms);
+			g2 = GEOSGeom_createCollection_r(handle, type, geoms, ngeoms);
 			free(geoms);
 			return g2;
 			break;
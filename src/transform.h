@@ -4,6 +4,17 @@
 #include <napi.h>
 #include <geos_c.h>
 
+typedef GEOSCoordSequence* (*coordseq_fn_t)(GEOSContextHandle_t, const GEOSCoordSequence*, void*);
+
+GEOSGeometry* MapGeom(GEOSContextHandle_t handle, coordseq_fn_t fn, void* userdata, const GEOSGeometry* g1);
 GEOSGeometry* TransformGeom(Napi::Env env, Napi::Function fn, const GEOSGeometry* g1);
+GEOSGeometry* TransformBatchGeom(Napi::Env env, Napi::Function fn, const GEOSGeometry* g1);
+GEOSGeometry* AffineGeom(GEOSContextHandle_t handle, const double matrix[12], const GEOSGeometry* g1);
+
+// Affine matrices from translate/scale/rotate arguments;
+// false (with pending JS exception) on invalid arguments:
+bool TranslateMatrix(const Napi::CallbackInfo& info, double matrix[12]);
+bool ScaleMatrix(const Napi::CallbackInfo& info, double matrix[12]);
+bool RotateMatrix(const Napi::CallbackInfo& info, double matrix[12]);
 
-#endif /* __TRANSFORM_H */
\ No newline at end of file
+#endif /* __TRANSFORM_H */
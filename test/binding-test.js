@@ -1,6 +1,9 @@
 const GEOS = require('bindings')('geos')
 const assert = require('assert')
 
+const assertError = message => fn => assert.throws(fn, { message, name: "Error" })
+const assertTypeError = message => fn => assert.throws(fn, { message, name: "TypeError" })
+
 const assertStringProperty = object => name => function () {
   assert(typeof object[name] === 'string')
 }
@@ -29,9 +32,32 @@ describe('GEOS', function () {
   it('exports JOIN_BEVEL integer property', assertInteger('JOIN_BEVEL'))
   it('exports readWKT function property', assertFunction('readWKT'))
   it('exports writeWKT function property', assertFunction('writeWKT'))
+  it('exports readWKB function property', assertFunction('readWKB'))
+  it('exports readHexWKB function property', assertFunction('readHexWKB'))
+  it('exports writeWKB function property', assertFunction('writeWKB'))
+  it('exports readGeoJSON function property', assertFunction('readGeoJSON'))
+  it('exports writeGeoJSON function property', assertFunction('writeGeoJSON'))
+  it('exports fromColumnar function property', assertFunction('fromColumnar'))
+  it('exports toColumnar function property', assertFunction('toColumnar'))
+  it('exports fromShared function property', assertFunction('fromShared'))
   it('exports createLineString function property', assertFunction('createLineString'))
   it('exports createPoint function property', assertFunction('createPoint'))
+  it('exports createPolygon function property', assertFunction('createPolygon'))
+  it('exports createMultiLineString function property', assertFunction('createMultiLineString'))
+  it('exports createMultiPolygon function property', assertFunction('createMultiPolygon'))
   it('exports createCollection function property', assertFunction('createCollection'))
+  it('exports createSpatialIndex function property', assertFunction('createSpatialIndex'))
+  it('exports createReader function property', assertFunction('createReader'))
+  it('exports writeDataset function property', assertFunction('writeDataset'))
+  it('exports openDataset function property', assertFunction('openDataset'))
+  it('exports unionAll function property', assertFunction('unionAll'))
+  it('exports join function property', assertFunction('join'))
+  it('exports buildLOD function property', assertFunction('buildLOD'))
+  it('exports scope function property', assertFunction('scope'))
+  it('exports pipeline function property', assertFunction('pipeline'))
+  it('exports enableStats function property', assertFunction('enableStats'))
+  it('exports stats function property', assertFunction('stats'))
+  it('exports resetStats function property', assertFunction('resetStats'))
 
   // https://www.ogc.org/standards/sfa
 
@@ -121,6 +147,499 @@ describe('GEOS', function () {
   })
 
 
+  describe('GEOS::writeWKB()/readWKB()', function () {
+    it('round-trips any geometry through WKB', function () {
+      wkt.map(GEOS.readWKT).forEach(geometry => {
+        const wkb = GEOS.writeWKB(geometry)
+        assert(Buffer.isBuffer(wkb))
+        assert(GEOS.readWKB(wkb).equals(geometry))
+      })
+    })
+
+    it('reads from ArrayBuffer and TypedArray views', function () {
+      const geometry = GEOS.readWKT('LINESTRING (10 10, 20 20, 30 40)')
+      const wkb = GEOS.writeWKB(geometry)
+      const copy = new Uint8Array(wkb.length + 8)
+      copy.set(wkb, 8)
+      assert(GEOS.readWKB(copy.subarray(8)).equals(geometry))
+      assert(GEOS.readWKB(copy.buffer.slice(8)).equals(geometry))
+    })
+
+    it('preserves SRID in EWKB', function () {
+      const geometry = GEOS.createPoint(26.417, 59.332)
+      geometry.setSRID(4326)
+      assert.strictEqual(GEOS.readWKB(GEOS.writeWKB(geometry, true)).getSRID(), 4326)
+      assert.strictEqual(GEOS.readWKB(GEOS.writeWKB(geometry)).getSRID(), 0)
+    })
+
+    it('reads hex-encoded WKB', function () {
+      const geometry = GEOS.readWKT('POINT (10 10)')
+      const hex = GEOS.writeWKB(geometry).toString('hex')
+      assert(GEOS.readHexWKB(hex).equals(geometry))
+      assert(GEOS.readHexWKB(Buffer.from(hex)).equals(geometry))
+    })
+
+    it('throws on missing argument', function () {
+      assert.throws(() => GEOS.readWKB(), {
+        name: "Error",
+        message: "Missing argument: WKB"
+      })
+
+      assert.throws(() => GEOS.writeWKB(), {
+        name: "Error",
+        message: "Missing argument: Geometry"
+      })
+    })
+
+    it('throws on invalid argument', function () {
+      assert.throws(() => GEOS.readWKB('POINT (0 0)'), {
+        name: "TypeError",
+        message: "Invalid argument: WKB"
+      })
+
+      assert.throws(() => GEOS.writeWKB({}), {
+        name: "Error",
+        message: "Invalid argument"
+      })
+    })
+
+    it('throws on WKB parse error', function () {
+      assert.throws(() => GEOS.readWKB(Buffer.from([1, 2, 3])), { name: "Error" })
+    })
+  })
+
+
+  describe('GEOS::writeGeoJSON()/readGeoJSON()', function () {
+    it('round-trips any geometry through GeoJSON string, Buffer and object', function () {
+      wkt.map(GEOS.readWKT).forEach((geometry, i) => {
+        const json = GEOS.writeGeoJSON(geometry)
+        assert.strictEqual(JSON.parse(json).type, types[i])
+        assert(GEOS.readGeoJSON(json).equals(geometry))
+        assert(GEOS.readGeoJSON(Buffer.from(json)).equals(geometry))
+        assert(GEOS.readGeoJSON(JSON.parse(json)).equals(geometry))
+      })
+    })
+
+    it('writes coordinates with given precision', function () {
+      const geometry = GEOS.readWKT('LINESTRING Z (0.123456 -0.0001 1, 10.5 20.25 2)')
+      assert.strictEqual(
+        GEOS.writeGeoJSON(geometry, 2),
+        '{"type":"LineString","coordinates":[[0.12,0,1],[10.5,20.25,2]]}'
+      )
+
+      assert.strictEqual(
+        GEOS.writeGeoJSON(GEOS.createPoint(0.1, 1 / 3)),
+        '{"type":"Point","coordinates":[0.1,0.3333333333333333]}'
+      )
+    })
+
+    it('writes large coordinates with given precision', function () {
+      const json = GEOS.writeGeoJSON(GEOS.createPoint(1e40, 12345678901234.5), 17)
+      assert.deepStrictEqual(JSON.parse(json).coordinates, [1e40, 12345678901234.5])
+    })
+
+    it('reads features and Z coordinates from objects', function () {
+      const feature = {
+        type: 'Feature',
+        properties: {},
+        geometry: { type: 'Point', coordinates: [1, 2, 3] }
+      }
+
+      const point = GEOS.readGeoJSON(feature)
+      assert.strictEqual(point.hasZ(), true)
+      assert.strictEqual(GEOS.writeGeoJSON(point), '{"type":"Point","coordinates":[1,2,3]}')
+
+      const collection = GEOS.readGeoJSON({ type: 'FeatureCollection', features: [feature, feature] })
+      assert.strictEqual(collection.getNumGeometries(), 2)
+    })
+
+    it('throws on missing argument', function () {
+      assertError('Missing argument: GeoJSON')(() => GEOS.readGeoJSON())
+      assertError('Missing argument: Geometry')(() => GEOS.writeGeoJSON())
+    })
+
+    it('throws on invalid argument', function () {
+      assertTypeError('Invalid argument: GeoJSON')(() => GEOS.readGeoJSON(42))
+      assertTypeError('Invalid argument: GeoJSON')(() => GEOS.readGeoJSON({ type: 'Circle' }))
+      assertTypeError('Invalid argument: GeoJSON')(() => GEOS.readGeoJSON({ type: 'Point', coordinates: ['x', 0] }))
+      assertTypeError('Invalid argument: GeoJSON')(() => GEOS.readGeoJSON({ type: 'MultiPoint', coordinates: [[0, 0], 1] }))
+      assertTypeError('Invalid argument: precision')(() => GEOS.writeGeoJSON(GEOS.createPoint(0, 0), 'x'))
+      assertError('Invalid range: precision')(() => GEOS.writeGeoJSON(GEOS.createPoint(0, 0), 18))
+      assert.throws(() => GEOS.readGeoJSON('{"type":'), { name: 'Error' })
+    })
+  })
+
+  describe('GEOS::toColumnar() / GEOS::fromColumnar()', function () {
+    const roundtrip = wkts => {
+      const geometries = wkts.map(GEOS.readWKT)
+      const columns = GEOS.toColumnar(geometries)
+      const result = GEOS.fromColumnar(columns)
+      assert.strictEqual(result.length, wkts.length)
+      result.forEach((geometry, i) => assert(geometry.equals(geometries[i]) || geometry.isEmpty()))
+      return columns
+    }
+
+    it('converts points', function () {
+      const columns = roundtrip(['POINT (1 2)', 'POINT (3 4)'])
+      assert.strictEqual(columns.type, 'Point')
+      assert.strictEqual(columns.dims, 2)
+      assert.deepStrictEqual(Array.from(columns.coords), [1, 2, 3, 4])
+      assert.strictEqual(columns.geomOffsets, undefined)
+
+      const [empty] = GEOS.toColumnar([GEOS.readWKT('POINT EMPTY')]).coords
+      assert(Number.isNaN(empty))
+    })
+
+    it('converts linestrings and polygons', function () {
+      const lines = roundtrip(['LINESTRING (0 0, 1 1)', 'LINESTRING (1 1, 2 2, 3 3)'])
+      assert.strictEqual(lines.type, 'LineString')
+      assert.deepStrictEqual(Array.from(lines.geomOffsets), [0, 2, 5])
+
+      const polygons = roundtrip([
+        'POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0), (2 2, 2 4, 4 4, 4 2, 2 2))',
+        'POLYGON ((20 20, 20 30, 30 30, 20 20))'
+      ])
+      assert.strictEqual(polygons.type, 'Polygon')
+      assert.deepStrictEqual(Array.from(polygons.geomOffsets), [0, 2, 3])
+      assert.deepStrictEqual(Array.from(polygons.ringOffsets), [0, 5, 10, 14])
+    })
+
+    it('promotes mixed single and multi geometries', function () {
+      const columns = roundtrip([
+        'MULTIPOLYGON (((0 0, 0 1, 1 1, 0 0)), ((5 5, 5 6, 6 6, 5 5)))',
+        'POLYGON ((20 20, 20 30, 30 30, 20 20))'
+      ])
+      assert.strictEqual(columns.type, 'MultiPolygon')
+      assert.deepStrictEqual(Array.from(columns.geomOffsets), [0, 2, 3])
+      assert.deepStrictEqual(Array.from(columns.partOffsets), [0, 1, 2, 3])
+      assert.deepStrictEqual(Array.from(columns.ringOffsets), [0, 4, 8, 12])
+
+      const lines = roundtrip(['MULTILINESTRING ((0 0, 1 1), (2 2, 3 3, 4 4))', 'LINESTRING (5 5, 6 6)'])
+      assert.strictEqual(lines.type, 'MultiLineString')
+      assert.deepStrictEqual(Array.from(lines.partOffsets), [0, 2, 5, 7])
+
+      const points = roundtrip(['MULTIPOINT (0 0, 1 1)', 'POINT (2 2)'])
+      assert.strictEqual(points.type, 'MultiPoint')
+      assert.deepStrictEqual(Array.from(points.geomOffsets), [0, 2, 3])
+    })
+
+    it('converts 3D coordinates', function () {
+      const columns = roundtrip(['LINESTRING Z (0 0 1, 1 1 2)'])
+      assert.strictEqual(columns.dims, 3)
+      assert.deepStrictEqual(Array.from(columns.coords), [0, 0, 1, 1, 1, 2])
+      assert(GEOS.fromColumnar(columns)[0].hasZ())
+    })
+
+    it('throws on missing/invalid argument', function () {
+      const coords = new Float64Array([0, 0, 1, 1])
+      assertError('Missing argument: [Geometry]')(() => GEOS.toColumnar())
+      assertTypeError('Invalid argument: [Geometry]')(() => GEOS.toColumnar(42))
+      assertTypeError('Invalid argument: mixed geometry types')(() => GEOS.toColumnar([
+        GEOS.readWKT('POINT (0 0)'),
+        GEOS.readWKT('LINESTRING (0 0, 1 1)')
+      ]))
+
+      assertError('Missing argument: columns')(() => GEOS.fromColumnar())
+      assertTypeError('Invalid argument: type')(() => GEOS.fromColumnar({ type: 'Curve', coords }))
+      assertTypeError('Invalid argument: coords')(() => GEOS.fromColumnar({ type: 'Point', coords: [0, 0] }))
+      assertTypeError('Invalid argument: dims')(() => GEOS.fromColumnar({ type: 'Point', coords, dims: 4 }))
+      assertTypeError('Invalid argument: geomOffsets')(() => GEOS.fromColumnar({ type: 'LineString', coords }))
+      assertError('Invalid range: geomOffsets')(() => GEOS.fromColumnar({
+        type: 'LineString',
+        coords,
+        geomOffsets: new Uint32Array([0, 3])
+      }))
+      assert.throws(() => GEOS.fromColumnar({
+        type: 'LineString',
+        coords,
+        geomOffsets: new Uint32Array([0, 1])
+      }), /^Error: Invalid geometry at index 0/)
+    })
+  })
+
+  describe('Geometry::toShared() / GEOS::fromShared()', function () {
+    it('roundtrip', function () {
+      const wkts = [
+        'POINT (1 2)',
+        'POINT EMPTY',
+        'POINT Z (1 2 3)',
+        'LINESTRING (0 0, 1 1, 2 0)',
+        'LINEARRING (0 0, 0 1, 1 1, 0 0)',
+        'POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0), (2 2, 2 8, 8 8, 8 2, 2 2))',
+        'POLYGON EMPTY',
+        'MULTIPOINT ((1 1), (2 2))',
+        'MULTILINESTRING ((0 0, 1 1), (2 2, 3 3))',
+        'MULTIPOLYGON (((0 0, 0 1, 1 1, 0 0)), ((5 5, 5 6, 6 6, 5 5)))',
+        'GEOMETRYCOLLECTION (POINT (1 1), GEOMETRYCOLLECTION (LINESTRING (0 0, 1 1)), POLYGON EMPTY)',
+        'GEOMETRYCOLLECTION EMPTY'
+      ]
+
+      wkts.forEach(wkt => {
+        const geometry = GEOS.readWKT(wkt)
+        geometry.setSRID(3857)
+        const buffer = geometry.toShared()
+        assert(buffer instanceof SharedArrayBuffer)
+
+        const copy = GEOS.fromShared(buffer)
+        assert.strictEqual(GEOS.writeWKT(copy), GEOS.writeWKT(geometry))
+        assert.strictEqual(copy.getType(), geometry.getType())
+        assert.strictEqual(copy.hasZ(), geometry.hasZ())
+        assert.strictEqual(copy.getSRID(), 3857)
+      })
+    })
+
+    it('throws on missing/invalid argument', function () {
+      const buffer = GEOS.readWKT('POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0))').toShared()
+      const truncated = new SharedArrayBuffer(buffer.byteLength - 8)
+      new Uint8Array(truncated).set(new Uint8Array(buffer, 0, truncated.byteLength))
+
+      assertError('Missing argument: SharedArrayBuffer')(() => GEOS.fromShared())
+      assertTypeError('Invalid argument: SharedArrayBuffer')(() => GEOS.fromShared(new ArrayBuffer(64)))
+      assertError('Invalid shared geometry')(() => GEOS.fromShared(new SharedArrayBuffer(64)))
+      assertError('Invalid shared geometry')(() => GEOS.fromShared(truncated))
+    })
+  })
+
+  describe('GEOS::unionAll()', function () {
+    // 20 x 20 grid of adjacent unit squares:
+    const squares = []
+    for (let x = 0; x < 20; x++) {
+      for (let y = 0; y < 20; y++) {
+        squares.push(GEOS.readWKT(`POLYGON ((${x} ${y}, ${x} ${y + 1}, ${x + 1} ${y + 1}, ${x + 1} ${y}, ${x} ${y}))`))
+      }
+    }
+
+    const expected = GEOS.readWKT('POLYGON ((0 0, 0 20, 20 20, 20 0, 0 0))')
+
+    it('dissolves geometries on multiple threads', async function () {
+      const geometry = await GEOS.unionAll(squares, { threads: 4 })
+      assert.strictEqual(geometry.getType(), 'Polygon')
+      assert(geometry.equals(expected))
+    })
+
+    it('dissolves geometries on single thread', async function () {
+      assert((await GEOS.unionAll(squares, { threads: 1 })).equals(expected))
+      assert((await GEOS.unionAll(squares.slice(0, 1))).equals(squares[0]))
+      assert((await GEOS.unionAll([])).isEmpty())
+    })
+
+    it('throws on missing/invalid argument', function () {
+      assertError('Missing argument: [Geometry]')(() => GEOS.unionAll())
+      assertTypeError('Invalid argument: [Geometry]')(() => GEOS.unionAll(42))
+      assertError('Invalid argument')(() => GEOS.unionAll(['x']))
+      assertTypeError('Invalid argument: threads')(() => GEOS.unionAll(squares, { threads: 'x' }))
+      assertError('Invalid range: threads')(() => GEOS.unionAll(squares, { threads: 0 }))
+    })
+  })
+
+  describe('GEOS::scope()', function () {
+    const disposed = geometry => assert.throws(() => geometry.getType(), { message: 'Geometry disposed' })
+
+    it('disposes geometries created in scope', function () {
+      let a, b
+      const result = GEOS.scope(() => {
+        a = GEOS.createPoint(0, 0)
+        b = a.buffer(1)
+        return 42
+      })
+
+      assert.strictEqual(result, 42)
+      disposed(a)
+      disposed(b)
+    })
+
+    it('keeps escaped and returned geometries', function () {
+      let a, b, c
+      const [d] = GEOS.scope(escape => {
+        a = escape(GEOS.createPoint(0, 0))
+        b = GEOS.createPoint(1, 1)
+        c = b.getGeometryN(0)
+        return [a.buffer(1)]
+      })
+
+      assert.strictEqual(a.getType(), 'Point')
+      assert.strictEqual(d.getType(), 'Polygon')
+      disposed(b)
+      disposed(c)
+    })
+
+    it('keeps geometries created outside of scope', function () {
+      const a = GEOS.createPoint(0, 0)
+      const b = GEOS.scope(() => a.buffer(1).getEnvelope())
+      assert.strictEqual(a.getType(), 'Point')
+      assert.strictEqual(b.length, 4)
+    })
+
+    it('escapes geometries to enclosing scope', function () {
+      let a, b
+      GEOS.scope(() => {
+        b = GEOS.scope(escape => {
+          a = escape(GEOS.createPoint(0, 0))
+          return GEOS.createPoint(1, 1)
+        })
+
+        assert.strictEqual(a.getType(), 'Point')
+        assert.strictEqual(b.getType(), 'Point')
+      })
+
+      disposed(a)
+      disposed(b)
+    })
+
+    it('disposes geometries when fn throws', function () {
+      let a
+      assert.throws(() => GEOS.scope(() => {
+        a = GEOS.createPoint(0, 0)
+        throw new Error('fail')
+      }), { message: 'fail' })
+      disposed(a)
+    })
+
+    it('throws on missing/invalid argument', function () {
+      let escape
+      GEOS.scope(e => { escape = e })
+
+      assertError('Missing argument: fn')(() => GEOS.scope())
+      assertTypeError('Invalid argument: fn')(() => GEOS.scope(42))
+      assertError('Scope closed')(() => escape(GEOS.createPoint(0, 0)))
+    })
+  })
+
+  describe('GEOS::join()', function () {
+    // 10 x 10 grid of 10 x 10 squares and points in and between them:
+    const squares = []
+    for (let x = 0; x < 100; x += 10) {
+      for (let y = 0; y < 100; y += 10) {
+        squares.push(GEOS.readWKT(`POLYGON ((${x} ${y}, ${x} ${y + 10}, ${x + 10} ${y + 10}, ${x + 10} ${y}, ${x} ${y}))`))
+      }
+    }
+
+    const points = []
+    for (let x = 0; x < 100; x += 2.5) {
+      for (let y = 0; y < 100; y += 2.5) points.push(GEOS.createPoint(x, y))
+    }
+
+    const bruteForce = (left, right, predicate) => {
+      const pairs = { left: [], right: [] }
+      left.forEach((a, i) => right.forEach((b, j) => {
+        if (a[predicate](b)) {
+          pairs.left.push(i)
+          pairs.right.push(j)
+        }
+      }))
+      return pairs
+    }
+
+    const check = async (left, right, predicate, threads) => {
+      const { left: l, right: r } = await GEOS.join(left, right, { predicate, threads })
+      const expected = bruteForce(left, right, predicate)
+      assert.deepStrictEqual(Array.from(l), expected.left)
+      assert.deepStrictEqual(Array.from(r), expected.right)
+    }
+
+    it('agrees with brute force', async function () {
+      await check(squares, points, 'contains', 4)
+      await check(points, squares, 'within', 4)
+      await check(points, squares, 'intersects', 1)
+      await check(squares, squares, 'touches', 2)
+      await check(squares, points, 'covers')
+      await check(points, squares, 'coveredBy')
+    })
+
+    it('uses intersects by default', async function () {
+      const { left, right } = await GEOS.join(squares.slice(0, 1), [GEOS.createPoint(5, 5), GEOS.createPoint(50, 50)])
+      assert.deepStrictEqual(Array.from(left), [0])
+      assert.deepStrictEqual(Array.from(right), [0])
+
+      const empty = await GEOS.join([], squares)
+      assert.strictEqual(empty.left.length, 0)
+    })
+
+    it('throws on missing/invalid argument', function () {
+      assertError('Missing argument(s): [Geometry], [Geometry]')(() => GEOS.join(squares))
+      assertTypeError('Invalid argument: [Geometry]')(() => GEOS.join(squares, 42))
+      assertError('Invalid argument')(() => GEOS.join(squares, ['x']))
+      assertTypeError('Invalid argument: predicate')(() => GEOS.join(squares, points, { predicate: 'disjoint' }))
+      assertError('Invalid range: threads')(() => GEOS.join(squares, points, { threads: 0 }))
+    })
+  })
+
+  describe('GEOS::buildLOD()', function () {
+    // 100 circles of 65 vertices (enough for multiple threads):
+    const circles = []
+    for (let i = 0; i < 100; i++) circles.push(GEOS.createPoint(i * 20, 0).buffer(8))
+    const tolerances = [0.1, 0.5, 2]
+
+    // Each level is simplified from the previous one:
+    const cascade = (geometry, preserveTopology = true) => tolerances.map(tolerance => {
+      geometry = preserveTopology
+        ? geometry.topologyPreservingSimplify(tolerance)
+        : geometry.simplify(tolerance)
+      return geometry
+    })
+
+    const expected = circles.map(circle => cascade(circle))
+
+    it('resolves to WKB per level', async function () {
+      const levels = await GEOS.buildLOD(circles, tolerances, { threads: 4 })
+      assert.strictEqual(levels.length, tolerances.length)
+
+      levels.forEach((level, l) => {
+        assert.strictEqual(level.tolerance, tolerances[l])
+        assert(Buffer.isBuffer(level.wkb))
+        assert(level.offsets instanceof Uint32Array)
+        assert.strictEqual(level.offsets.length, circles.length + 1)
+        assert.strictEqual(level.offsets[circles.length], level.wkb.length)
+
+        circles.forEach((_, i) => {
+          const geometry = GEOS.readWKB(level.wkb.subarray(level.offsets[i], level.offsets[i + 1]))
+          assert(geometry.equals(expected[i][l]))
+          if (l > 0) assert(geometry.getCoordinates().coords.length <= expected[i][l - 1].getCoordinates().coords.length)
+        })
+      })
+    })
+
+    it('resolves to flat coordinates per level', async function () {
+      const levels = await GEOS.buildLOD(circles, tolerances, { format: 'flat', preserveTopology: false, threads: 2 })
+      const simplified = circles.map(circle => cascade(circle, false))
+
+      levels.forEach((level, l) => {
+        assert.strictEqual(level.dims, 2)
+        assert.strictEqual(level.geomOffsets.length, circles.length + 1)
+
+        circles.forEach((_, i) => {
+          // Single polygon parts, one ring each:
+          const { coords } = simplified[i][l].getCoordinates()
+          const part = level.geomOffsets[i]
+          assert.strictEqual(level.geomOffsets[i + 1], part + 1)
+          const ring = level.partOffsets[part]
+          const begin = level.ringOffsets[ring] * 2
+          const end = level.ringOffsets[ring + 1] * 2
+          assert.deepStrictEqual(Array.from(level.coords.subarray(begin, end)), Array.from(coords))
+        })
+      })
+    })
+
+    it('handles empty input', async function () {
+      const levels = await GEOS.buildLOD([], [1, 2])
+      assert.strictEqual(levels.length, 2)
+      assert.deepStrictEqual(Array.from(levels[0].offsets), [0])
+      assert.deepStrictEqual(await GEOS.buildLOD(circles, []), [])
+    })
+
+    it('throws on missing/invalid argument', function () {
+      assertError('Missing argument(s): [Geometry], tolerances')(() => GEOS.buildLOD(circles))
+      assertTypeError('Invalid argument: [Geometry]')(() => GEOS.buildLOD(42, tolerances))
+      assertError('Invalid argument')(() => GEOS.buildLOD(['x'], tolerances))
+      assertTypeError('Invalid argument: tolerances')(() => GEOS.buildLOD(circles, 1))
+      assertTypeError('Invalid argument: tolerances')(() => GEOS.buildLOD(circles, ['x']))
+      assertError('Invalid range: tolerances')(() => GEOS.buildLOD(circles, [2, 1]))
+      assertError('Invalid range: tolerances')(() => GEOS.buildLOD(circles, new Float64Array([-1])))
+      assertTypeError('Invalid argument: format')(() => GEOS.buildLOD(circles, tolerances, { format: 'wkt' }))
+      assertError('Invalid range: threads')(() => GEOS.buildLOD(circles, tolerances, { threads: 0 }))
+    })
+  })
+
   describe('GEOS::createLineString()', function () {
     it('constructs LineString from [Point]', function() {
       const a = GEOS.createPoint(0, 0)
@@ -186,6 +705,102 @@ describe('GEOS', function () {
         message: "An array was expected"
       })
     })
+
+    it('constructs LineString from Float64Array', function () {
+      const lineString = GEOS.createLineString(new Float64Array([0, 0, 10, 10, 15, 10]))
+      assert(lineString.equals(GEOS.readWKT('LINESTRING (0 0, 10 10, 15 10)')))
+
+      const lineStringZ = GEOS.createLineString(new Float64Array([0, 0, 1, 10, 10, 2]), 3)
+      assert.strictEqual(lineStringZ.hasZ(), true)
+      assert.strictEqual(lineStringZ.getNumPoints(), 2)
+    })
+
+    it('throws on invalid Float64Array', function () {
+      assert.throws(() => GEOS.createLineString(new Float64Array([0, 0])), {
+        name: "Error",
+        message: "Invalid range: coords"
+      })
+
+      assert.throws(() => GEOS.createLineString(new Float32Array([0, 0, 1, 1])), {
+        name: "TypeError",
+        message: "Invalid argument: coords"
+      })
+
+      assert.throws(() => GEOS.createLineString(new Float64Array([0, 0, 1, 1]), 4), {
+        name: "TypeError",
+        message: "Invalid argument: dims"
+      })
+    })
+  })
+
+
+  describe('GEOS::createPolygon()', function () {
+    it('constructs Polygon from shell', function () {
+      const coords = new Float64Array([0, 0, 0, 10, 10, 10, 10, 0, 0, 0])
+      const polygon = GEOS.createPolygon(coords)
+      assert(polygon.equals(GEOS.readWKT('POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0))')))
+    })
+
+    it('constructs Polygon with holes', function () {
+      const coords = new Float64Array([
+        0, 0, 0, 10, 10, 10, 10, 0, 0, 0,
+        2, 2, 2, 8, 8, 8, 8, 2, 2, 2
+      ])
+
+      const polygon = GEOS.createPolygon(coords, new Uint32Array([0, 5, 10]))
+      const expected = GEOS.readWKT('POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0), (2 2, 2 8, 8 8, 8 2, 2 2))')
+      assert(polygon.equals(expected))
+    })
+
+    it('throws on invalid arguments', function () {
+      const coords = new Float64Array([0, 0, 0, 10, 10, 10, 10, 0, 0, 0])
+
+      assert.throws(() => GEOS.createPolygon(), {
+        name: "Error",
+        message: "Missing argument: coords"
+      })
+
+      assert.throws(() => GEOS.createPolygon(coords, [0, 5]), {
+        name: "TypeError",
+        message: "Invalid argument: ringOffsets"
+      })
+
+      assert.throws(() => GEOS.createPolygon(coords, new Uint32Array([0, 6])), {
+        name: "Error",
+        message: "Invalid range: ringOffsets"
+      })
+
+      // Ring is not closed:
+      assert.throws(() => GEOS.createPolygon(coords, new Uint32Array([0, 4])), { name: "Error" })
+    })
+  })
+
+
+  describe('GEOS::createMultiLineString()', function () {
+    it('constructs MultiLineString from Float64Array', function () {
+      const coords = new Float64Array([10, 10, 20, 20, 30, 40, 15, 15, 25, 25, 35, 45])
+      const multi = GEOS.createMultiLineString(coords, new Uint32Array([0, 3, 6]))
+      assert(multi.equals(GEOS.readWKT(wkt[5])))
+    })
+  })
+
+
+  describe('GEOS::createMultiPolygon()', function () {
+    it('constructs MultiPolygon from Float64Array', function () {
+      const expected = GEOS.readWKT(wkt[6])
+      const { coords, ringOffsets, partOffsets } = expected.getCoordinates()
+      const multi = GEOS.createMultiPolygon(coords, ringOffsets, partOffsets)
+      assert.strictEqual(multi.getType(), 'MultiPolygon')
+      assert(multi.equals(expected))
+    })
+
+    it('throws on invalid offsets', function () {
+      const coords = new Float64Array([0, 0, 0, 10, 10, 10, 10, 0, 0, 0])
+      assert.throws(() => GEOS.createMultiPolygon(coords, new Uint32Array([0, 5]), new Uint32Array([0, 2])), {
+        name: "Error",
+        message: "Invalid range: partOffsets"
+      })
+    })
   })
 
 
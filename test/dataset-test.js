@@ -0,0 +1,107 @@
+const GEOS = require('bindings')('geos')
+const assert = require('assert')
+const fs = require('fs')
+const os = require('os')
+const path = require('path')
+
+const assertError = message => fn => assert.throws(fn, { message, name: "Error" })
+const assertTypeError = message => fn => assert.throws(fn, { message, name: "TypeError" })
+
+describe('Dataset', function () {
+  const tmpfile = name => path.join(os.tmpdir(), `geosjs-dataset-${process.pid}-${name}`)
+  const file = tmpfile('grid.dataset')
+  const emptyFile = tmpfile('empty.dataset')
+  const invalidFile = tmpfile('invalid.dataset')
+
+  // 30 x 30 grid of unit squares; small node size for a deeper tree:
+  const squares = []
+  for (let x = 0; x < 30; x++) {
+    for (let y = 0; y < 30; y++) {
+      squares.push(GEOS.readWKT(`POLYGON ((${x} ${y}, ${x} ${y + 1}, ${x + 1} ${y + 1}, ${x + 1} ${y}, ${x} ${y}))`))
+    }
+  }
+
+  const extra = [GEOS.readWKT('POINT EMPTY'), GEOS.readWKT('POINT Z (100 100 5)')]
+  extra[1].setSRID(4326)
+  const geometries = squares.concat(extra)
+
+  before(function () {
+    GEOS.writeDataset(file, geometries, { nodeSize: 4 })
+    GEOS.writeDataset(emptyFile, [])
+    fs.writeFileSync(invalidFile, 'POINT (0 0)\n')
+  })
+
+  after(function () {
+    ;[file, emptyFile, invalidFile].forEach(file => fs.unlinkSync(file))
+  })
+
+  it('::get() - decodes geometries', function () {
+    const dataset = GEOS.openDataset(file)
+    assert.strictEqual(dataset.getNumItems(), geometries.length)
+    geometries.forEach((geometry, i) => {
+      const decoded = dataset.get(i)
+      assert(decoded.isEmpty() ? geometry.isEmpty() : decoded.equals(geometry))
+    })
+
+    const point = dataset.get(geometries.length - 1)
+    assert(point.hasZ())
+    assert.strictEqual(point.getSRID(), 4326)
+    dataset.close()
+  })
+
+  it('::getEnvelope()', function () {
+    const dataset = GEOS.openDataset(file)
+    assert.deepStrictEqual(Array.from(dataset.getEnvelope(31)), [1, 1, 2, 2])
+    assert.deepStrictEqual(Array.from(dataset.getEnvelope(squares.length)), [Infinity, Infinity, -Infinity, -Infinity])
+  })
+
+  it('::query() - agrees with brute force', function () {
+    const dataset = GEOS.openDataset(file)
+    const queries = [[0.5, 0.5, 2.5, 1.5], [10, 10, 10, 10], [-5, -5, -1, -1], [99, 99, 101, 101], [-1, -1, 31, 31]]
+
+    queries.forEach(query => {
+      const envelope = new Float64Array(query)
+      const expected = geometries
+        .map((geometry, i) => [geometry.getEnvelope(), i])
+        .filter(([e]) => !(e[0] > query[2] || e[1] > query[3] || e[2] < query[0] || e[3] < query[1]))
+        .map(([, i]) => i)
+
+      assert.deepStrictEqual(Array.from(dataset.query(envelope)), expected)
+    })
+
+    assert.deepStrictEqual(Array.from(dataset.query(GEOS.createPoint(0.5, 0.5))), [0])
+    assert.deepStrictEqual(Array.from(dataset.query(GEOS.readWKT('POINT EMPTY'))), [])
+  })
+
+  it('empty dataset', function () {
+    const dataset = GEOS.openDataset(emptyFile)
+    assert.strictEqual(dataset.getNumItems(), 0)
+    assert.strictEqual(dataset.query(new Float64Array([0, 0, 1, 1])).length, 0)
+  })
+
+  it('::close()', function () {
+    const dataset = GEOS.openDataset(file)
+    const geometry = dataset.get(0)
+    dataset.close()
+    dataset.close()
+    assert.strictEqual(geometry.getType(), 'Polygon')
+    assertError('Dataset closed')(() => dataset.get(0))
+  })
+
+  it('throws on missing/invalid argument', function () {
+    assertError('Missing argument(s): path, [Geometry]')(() => GEOS.writeDataset(file))
+    assertTypeError('Invalid argument: path')(() => GEOS.writeDataset(42, []))
+    assertTypeError('Invalid argument: [Geometry]')(() => GEOS.writeDataset(file, 42))
+    assertError('Invalid range: nodeSize')(() => GEOS.writeDataset(file, [], { nodeSize: 1 }))
+
+    assertError('Missing argument: path')(() => GEOS.openDataset())
+    assertError(`Cannot open file: ${tmpfile('missing')}`)(() => GEOS.openDataset(tmpfile('missing')))
+    assertError(`Invalid dataset: ${invalidFile}`)(() => GEOS.openDataset(invalidFile))
+
+    const dataset = GEOS.openDataset(file)
+    assertError('Missing argument: i')(() => dataset.get())
+    assertTypeError('Invalid argument: i')(() => dataset.get('x'))
+    assertError('Invalid range: i')(() => dataset.get(geometries.length))
+    assertTypeError('Invalid argument: envelope')(() => dataset.query(new Float64Array(3)))
+  })
+})
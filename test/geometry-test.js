@@ -89,6 +89,131 @@ describe('Geometry', function () {
     assertError('Invalid range: n')(() => geometry.getGeometryN(10))
   })
 
+  it('::getGeometryN() - borrowed view', function () {
+    const multi = GEOS.readWKT('MULTIPOINT (0 0, 10 10)')
+    const part = multi.getGeometryN(1)
+    assert(part.equals(GEOS.createPoint(10, 10)))
+
+    // Parent is pinned while view exists:
+    assertError('Geometry in use')(() => multi.dispose())
+    part.dispose()
+    multi.dispose()
+
+    // Views are copied before modification:
+    const other = GEOS.readWKT('MULTIPOINT (0 0, 10 10)')
+    const view = other.getGeometryN(0)
+    view.setSRID(4326)
+    assert.strictEqual(view.getSRID(), 4326)
+    const original = other.getGeometryN(0)
+    assert.strictEqual(original.getSRID(), 0)
+    original.dispose()
+    other.dispose()
+    assert(view.equals(GEOS.createPoint(0, 0)))
+  })
+
+  it('::forEachGeometry()', function () {
+    const multi = GEOS.readWKT('MULTIPOLYGON (((0 0, 0 1, 1 1, 1 0, 0 0)), ((5 5, 5 6, 6 6, 6 5, 5 5)), ((9 9, 9 10, 10 10, 9 9)))')
+    const visited = []
+    let view
+    multi.forEachGeometry((part, i) => {
+      visited.push([i, part.getType(), Array.from(part.getEnvelope())])
+      view = part
+    })
+
+    assert.deepStrictEqual(visited, [
+      [0, 'Polygon', [0, 0, 1, 1]],
+      [1, 'Polygon', [5, 5, 6, 6]],
+      [2, 'Polygon', [9, 9, 10, 10]]
+    ])
+
+    // View is detached after iteration:
+    assertError('Geometry disposed')(() => view.getType())
+
+    let count = 0
+    multi.forEachGeometry(() => ++count < 2)
+    assert.strictEqual(count, 2)
+
+    assertError('Missing argument: fn')(() => multi.forEachGeometry())
+    assertTypeError('Invalid argument: fn')(() => multi.forEachGeometry(42))
+    multi.dispose() // no longer pinned
+  })
+
+  it('::forEachGeometry() - pinned views outlive iteration', function () {
+    const multi = GEOS.readWKT('MULTIPOLYGON (((0 0, 0 1, 1 1, 1 0, 0 0)), ((5 5, 5 6, 6 6, 6 5, 5 5)))')
+    const prepared = []
+    multi.forEachGeometry(part => { prepared.push(part.prepare()) })
+
+    // Each prepared part still refers to its own polygon:
+    assert.strictEqual(prepared[0].contains(GEOS.createPoint(0.5, 0.5)), true)
+    assert.strictEqual(prepared[0].contains(GEOS.createPoint(5.5, 5.5)), false)
+    assert.strictEqual(prepared[1].contains(GEOS.createPoint(5.5, 5.5)), true)
+
+    // Parent stays pinned while parts are in use:
+    assertError('Geometry in use')(() => multi.dispose())
+    prepared.forEach(p => p.dispose())
+  })
+
+  it('::getCoordinates()', function () {
+    const point = GEOS.createPoint(5, 10).getCoordinates()
+    assert.deepStrictEqual(Array.from(point.coords), [5, 10])
+    assert.strictEqual(point.dims, 2)
+    assert.deepStrictEqual(Array.from(point.ringOffsets), [0, 1])
+    assert.deepStrictEqual(Array.from(point.partOffsets), [0, 1])
+
+    const multi = GEOS.readWKT('MULTIPOLYGON (((0 0, 0 20, 20 20, 20 0, 0 0), (5 5, 5 15, 15 15, 15 5, 5 5)), ((30 30, 30 40, 40 40, 30 30)))')
+    const { coords, ringOffsets, partOffsets } = multi.getCoordinates()
+    assert(coords instanceof Float64Array)
+    assert.strictEqual(coords.length, 28)
+    assert.deepStrictEqual(Array.from(coords.subarray(20, 28)), [30, 30, 30, 40, 40, 40, 30, 30])
+    assert.deepStrictEqual(Array.from(ringOffsets), [0, 5, 10, 14])
+    assert.deepStrictEqual(Array.from(partOffsets), [0, 2, 3])
+
+    const collection = GEOS.readWKT('GEOMETRYCOLLECTION (POINT Z (1 2 3), LINESTRING Z (0 0 0, 1 1 1))').getCoordinates()
+    assert.strictEqual(collection.dims, 3)
+    assert.deepStrictEqual(Array.from(collection.coords), [1, 2, 3, 0, 0, 0, 1, 1, 1])
+    assert.deepStrictEqual(Array.from(collection.ringOffsets), [0, 1, 3])
+    assert.deepStrictEqual(Array.from(collection.partOffsets), [0, 1, 2])
+  })
+
+  it('::getEnvelope()', function () {
+    const polygon = GEOS.readWKT('POLYGON ((0 -5, 0 10, 20 10, 20 -5, 0 -5))')
+    assert(polygon.getEnvelope() instanceof Float64Array)
+    assert.deepStrictEqual(Array.from(polygon.getEnvelope()), [0, -5, 20, 10])
+    assert.deepStrictEqual(Array.from(GEOS.createPoint(3, 4).getEnvelope()), [3, 4, 3, 4])
+    assert.deepStrictEqual(Array.from(GEOS.readWKT('POINT EMPTY').getEnvelope()), [Infinity, Infinity, -Infinity, -Infinity])
+  })
+
+  it('predicates - envelope fast path agrees with GEOS', function () {
+    const polygon = GEOS.readWKT('POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0))')
+    const candidates = [
+      'POINT (5 5)', // inside
+      'POINT (20 20)', // far away
+      'POLYGON ((2 2, 2 4, 4 4, 4 2, 2 2))', // contained
+      'POLYGON ((5 5, 5 15, 15 15, 15 5, 5 5))', // overlapping
+      'POLYGON ((-5 -5, -5 15, 15 15, 15 -5, -5 -5))', // containing
+      'POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0))', // equal
+      'LINESTRING (10 0, 20 0)', // touching
+      'POINT EMPTY'
+    ].map(GEOS.readWKT)
+
+    const expected = {
+      intersects: [true, false, true, true, true, true, true, false],
+      disjoint: [false, true, false, false, false, false, false, true],
+      contains: [true, false, true, false, false, true, false, false],
+      within: [false, false, false, false, true, true, false, false],
+      covers: [true, false, true, false, false, true, false, false],
+      coveredBy: [false, false, false, false, true, true, false, false],
+      equals: [false, false, false, false, false, true, false, false],
+      touches: [false, false, false, false, false, false, true, false]
+    }
+
+    Object.entries(expected).forEach(([predicate, values]) => {
+      candidates.forEach((candidate, i) => {
+        assert.strictEqual(polygon[predicate](candidate), values[i], `${predicate} ${i}`)
+      })
+    })
+  })
+
   it('::difference()', function () {
     const a = GEOS.createPoint(0, 0).buffer(10)
     const b = GEOS.createPoint(0, 5).buffer(10)
@@ -120,6 +245,14 @@ describe('Geometry', function () {
     assertError('Invalid argument')(() => polygon.intersection('x'))
   })
 
+  it('::intersection() - GEOS error', function () {
+    // Overlay rejects mixed-dimension collections (message depends on GEOS version):
+    const collection = GEOS.readWKT('GEOMETRYCOLLECTION (POINT (0 0), POLYGON ((0 0, 0 1, 1 1, 1 0, 0 0)))')
+    const polygon = GEOS.readWKT('POLYGON ((0 0, 0 2, 2 2, 2 0, 0 0))')
+    assert.throws(() => collection.intersection(polygon), Error)
+    assert.throws(() => collection.difference(polygon), Error)
+  })
+
   it('::convexHull()', function () {
     const a = GEOS.createPoint(0, 0)
     const b = GEOS.createPoint(2, 2)
@@ -161,10 +294,220 @@ describe('Geometry', function () {
     assert.strictEqual(valid.getNumGeometries(), 2)
   })
 
+  it('::simplify()', function () {
+    const line = GEOS.readWKT('LINESTRING (0 0, 1 0.1, 2 0, 3 0.1, 4 0)')
+    assert(line.simplify(0.5).equals(GEOS.readWKT('LINESTRING (0 0, 4 0)')))
+    assert(line.simplify(0).equals(line))
+
+    // Rings may collapse:
+    const square = GEOS.readWKT('POLYGON ((0 0, 0 1, 1 1, 1 0, 0 0))')
+    assert(square.simplify(10).isEmpty())
+
+    assertError('Missing argument: tolerance')(() => line.simplify())
+    assertTypeError('Invalid argument: tolerance')(() => line.simplify('x'))
+    assertError('Invalid range: tolerance')(() => line.simplify(-1))
+  })
+
+  it('::topologyPreservingSimplify()', function () {
+    const polygon = GEOS.readWKT('POLYGON ((0 0, 0 10, 5 10.1, 10 10, 10 0, 0 0))')
+    const expected = GEOS.readWKT('POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0))')
+    assert(polygon.topologyPreservingSimplify(1).equals(expected))
+
+    // Rings do not collapse:
+    const square = GEOS.readWKT('POLYGON ((0 0, 0 1, 1 1, 1 0, 0 0))')
+    const simplified = square.topologyPreservingSimplify(10)
+    assert.strictEqual(simplified.isEmpty(), false)
+    assert.strictEqual(simplified.isValid(), true)
+
+    assertError('Missing argument: tolerance')(() => polygon.topologyPreservingSimplify())
+    assertError('Invalid range: tolerance')(() => polygon.topologyPreservingSimplify(-1))
+  })
+
   // TODO: interpolate()
   // TODO: interpolateNormalized()
   // TODO: transform()
 
+  it('::transformBatch()', function () {
+    const polygon = GEOS.readWKT('MULTIPOLYGON (((0 0, 0 10, 10 10, 10 0, 0 0), (2 2, 2 8, 8 8, 8 2, 2 2)), ((20 20, 20 30, 30 30, 20 20)))')
+    const calls = []
+    const transformed = polygon.transformBatch((coords, dims) => {
+      assert(coords instanceof Float64Array)
+      calls.push(coords.length / dims)
+      for (let i = 0; i < coords.length; i += dims) {
+        coords[i] += 1
+        coords[i + 1] *= 2
+      }
+    })
+
+    // One call per ring:
+    assert.deepStrictEqual(calls, [5, 5, 4])
+    const expected = GEOS.readWKT('MULTIPOLYGON (((1 0, 1 20, 11 20, 11 0, 1 0), (3 4, 3 16, 9 16, 9 4, 3 4)), ((21 40, 21 60, 31 60, 21 40)))')
+    assert(transformed.equals(expected))
+
+    assertError('Missing argument: fn')(() => polygon.transformBatch())
+    assertTypeError('Invalid argument: fn')(() => polygon.transformBatch(42))
+  })
+
+  it('::affine()', function () {
+    const line = GEOS.readWKT('LINESTRING (0 0, 1 1, 2 0)')
+    const expected = GEOS.readWKT('LINESTRING (10 20, 12 23, 14 20)')
+    assert(line.affine([2, 0, 0, 3, 10, 20]).equals(expected))
+    assert(line.affine(new Float64Array([2, 0, 0, 0, 3, 0, 0, 0, 1, 10, 20, 0])).equals(expected))
+
+    assertError('Missing argument: matrix')(() => line.affine())
+    assertTypeError('Invalid argument: matrix')(() => line.affine(42))
+    assertTypeError('Invalid argument: matrix')(() => line.affine([1, 2, 3]))
+    assertTypeError('Invalid argument: matrix')(() => line.affine([1, 0, 0, 1, 'x', 0]))
+  })
+
+  it('::affine() - preserves Z and SRID', function () {
+    const point = GEOS.readWKT('POINT Z (1 2 3)')
+    point.setSRID(3857)
+    const translated = point.translate(1, 1, 1)
+    assert.strictEqual(translated.hasZ(), true)
+    assert.strictEqual(translated.getSRID(), 3857)
+    assert.strictEqual(GEOS.writeWKT(translated), GEOS.writeWKT(GEOS.readWKT('POINT Z (2 3 4)')))
+  })
+
+  it('::translate()', function () {
+    const polygon = GEOS.readWKT('POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0), (2 2, 2 8, 8 8, 8 2, 2 2))')
+    const expected = GEOS.readWKT('POLYGON ((5 5, 5 15, 15 15, 15 5, 5 5), (7 7, 7 13, 13 13, 13 7, 7 7))')
+    assert(polygon.translate(5, 5).equals(expected))
+
+    assertError('Missing argument(s): xoff, yoff')(() => polygon.translate(5))
+    assertTypeError('Invalid argument: offset')(() => polygon.translate(5, 'x'))
+  })
+
+  it('::scale()', function () {
+    const multi = GEOS.readWKT('MULTIPOINT (1 1, 2 3)')
+    const expected = GEOS.readWKT('MULTIPOINT (2 -1, 4 -3)')
+    assert(multi.scale(2, -1).equals(expected))
+
+    assertError('Missing argument(s): xfact, yfact')(() => multi.scale())
+  })
+
+  it('::rotate()', function () {
+    const point = GEOS.createPoint(2, 1)
+    const rotated = point.rotate(Math.PI / 2, 1, 1)
+    assert(Math.abs(rotated.getX() - 1) < 1E-9)
+    assert(Math.abs(rotated.getY() - 2) < 1E-9)
+
+    assertError('Missing argument: angle')(() => point.rotate())
+  })
+
+  it('::distance()', function () {
+    const a = GEOS.readWKT('POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0))')
+    assert.strictEqual(a.distance(GEOS.createPoint(13, 14)), 5)
+    assert.strictEqual(a.distance(GEOS.createPoint(5, 5)), 0)
+    assert(Number.isNaN(a.distance(GEOS.readWKT('POINT EMPTY'))))
+
+    assertError('Missing argument: Geometry')(() => a.distance())
+    assertError('Invalid argument')(() => a.distance({}))
+  })
+
+  it('::hausdorffDistance()', function () {
+    const a = GEOS.readWKT('LINESTRING (0 0, 100 0, 10 100, 10 100)')
+    const b = GEOS.readWKT('LINESTRING (0 100, 0 10, 80 10)')
+    assert(Math.abs(a.hausdorffDistance(b) - 22.360679774997898) < 1E-9)
+    assert(Math.abs(a.hausdorffDistance(b, 0.001) - 47.8) < 1E-1)
+
+    assertTypeError('Invalid argument: densifyFrac')(() => a.hausdorffDistance(b, 'x'))
+    assertError('Invalid range: densifyFrac')(() => a.hausdorffDistance(b, 2))
+  })
+
+  it('::nearestPoints()', function () {
+    const a = GEOS.readWKT('LINESTRING (0 0, 10 0)')
+    const points = a.nearestPoints(GEOS.createPoint(5, 3))
+    assert(points instanceof Float64Array)
+    assert.deepStrictEqual(Array.from(points), [5, 0, 5, 3])
+    assert.strictEqual(a.nearestPoints(GEOS.readWKT('POINT EMPTY')), null)
+  })
+
+  it('::isWithinDistance()', function () {
+    const a = GEOS.readWKT('POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0))')
+    const b = GEOS.createPoint(13, 14)
+    assert.strictEqual(a.isWithinDistance(b, 5), true)
+    assert.strictEqual(a.isWithinDistance(b, 4.9), false)
+    assert.strictEqual(a.isWithinDistance(GEOS.createPoint(100, 100), 1), false)
+    assert.strictEqual(a.isWithinDistance(GEOS.readWKT('POINT EMPTY'), 1), false)
+
+    assertError('Missing argument(s): Geometry, d')(() => a.isWithinDistance(b))
+    assertTypeError('Invalid argument: d')(() => a.isWithinDistance(b, 'x'))
+  })
+
+  it('::distanceMany()', function () {
+    const a = GEOS.readWKT('POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0))')
+    const others = [GEOS.createPoint(13, 14), GEOS.createPoint(5, 5), GEOS.readWKT('POINT EMPTY'), GEOS.readWKT('LINESTRING (20 0, 20 10)')]
+    const distances = a.distanceMany(others)
+    assert(distances instanceof Float64Array)
+    assert.deepStrictEqual(Array.from(distances), [5, 0, NaN, 10])
+    assert.deepStrictEqual(Array.from(others.map(other => a.distance(other))), Array.from(distances))
+
+    assertError('Missing argument: [Geometry]')(() => a.distanceMany())
+    assertTypeError('Invalid argument: [Geometry]')(() => a.distanceMany(42))
+  })
+
+  it('::unionAsync()', async function () {
+    const a = GEOS.createPoint(0, 0).buffer(10, 16)
+    const b = GEOS.createPoint(0, 5).buffer(10, 16)
+    const geometry = await a.unionAsync(b)
+    assert(geometry.equals(a.union(b)))
+
+    assertError('Missing argument: geometry')(() => a.unionAsync())
+    assertError('Invalid argument')(() => a.unionAsync('x'))
+  })
+
+  it('::intersectionAsync()', async function () {
+    const polygon = GEOS.readWKT('POLYGON ((0 0, 0 1, 1 1, 1 0, 0 0))')
+    const line = GEOS.readWKT('LINESTRING (0.5 -1, 0.5 2)')
+    const geometry = await polygon.intersectionAsync(line)
+    const expected = GEOS.readWKT('LINESTRING (0.5 0, 0.5 1)')
+    assert(geometry.equals(expected))
+  })
+
+  it('::differenceAsync()', async function () {
+    const a = GEOS.createPoint(0, 0).buffer(10)
+    const b = GEOS.createPoint(0, 5).buffer(10)
+    const geometry = await a.differenceAsync(b)
+    assert(geometry.equals(a.difference(b)))
+  })
+
+  it('::convexHullAsync()', async function () {
+    const collection = GEOS.readWKT('MULTIPOINT (0 0, 2 2, 2 -2)')
+    const hull = await collection.convexHullAsync()
+    const expected = GEOS.readWKT('POLYGON ((2 -2, 0 0, 2 2, 2 -2))')
+    assert(hull.equals(expected))
+  })
+
+  it('::bufferAsync()', async function () {
+    const a = GEOS.createPoint(0, 0)
+    const geometry = await a.bufferAsync(10, 8, GEOS.CAP_FLAT, GEOS.JOIN_MITRE)
+    assert.strictEqual(geometry.getType(), 'Polygon')
+
+    assertError('Missing argument: width')(() => a.bufferAsync())
+  })
+
+  it('::bufferAsync() - mitre limit', async function () {
+    const line = GEOS.readWKT('LINESTRING (0 0, 10 0, 0 1)')
+    const sharp = await line.bufferAsync(1, 8, GEOS.CAP_FLAT, GEOS.JOIN_MITRE, 50)
+    const clipped = await line.bufferAsync(1, 8, GEOS.CAP_FLAT, GEOS.JOIN_MITRE, 1)
+    assert(sharp.getEnvelope()[2] > clipped.getEnvelope()[2])
+
+    // Same defaults as buffer() and pipeline buffer:
+    const args = [1, 8, GEOS.CAP_FLAT, GEOS.JOIN_MITRE]
+    const async = await line.bufferAsync(...args)
+    assert(async.equals(line.buffer(...args)))
+    assert(async.equals(GEOS.pipeline().buffer(...args).build().apply(line)))
+    assert(line.buffer(...args, 1).equals(clipped))
+  })
+
+  it('::asValidAsync()', async function () {
+    const invalid = GEOS.readWKT('POLYGON ((0 0, 0 1, 1 0, 1 1, 0 0))')
+    const valid = await invalid.asValidAsync()
+    assert.strictEqual(valid.isValid(), true)
+    assert.strictEqual(valid.getNumGeometries(), 2)
+  })
+
   it('::isValid()', function () {
     ;[
       ['POLYGON ((0 0, 0 1, 1 1, 1 0, 0 0))', true], // valid
@@ -174,6 +517,37 @@ describe('Geometry', function () {
 
   // TODO: remaining predicates
 
+  it('::dispose()', function () {
+    const a = GEOS.createPoint(0, 0).buffer(10)
+    const b = GEOS.createPoint(0, 5)
+    a.dispose()
+    a.dispose() // no-op
+
+    assertError('Geometry disposed')(() => a.getType())
+    assertError('Geometry disposed')(() => a.buffer(1))
+    assertError('Geometry disposed')(() => b.intersects(a))
+    assertError('Geometry disposed')(() => GEOS.writeWKT(a))
+
+    if (typeof Symbol.dispose === 'symbol') {
+      assert.strictEqual(b[Symbol.dispose], b.dispose)
+    }
+  })
+
+  it('::dispose() - pinned geometry', async function () {
+    const a = GEOS.createPoint(0, 0).buffer(10)
+    const prepared = a.prepare()
+    assertError('Geometry in use')(() => a.dispose())
+    prepared.dispose()
+    assertError('Geometry disposed')(() => prepared.intersects(a))
+    a.dispose()
+
+    const b = GEOS.createPoint(0, 0)
+    const pending = b.bufferAsync(10)
+    assertError('Geometry in use')(() => b.dispose())
+    await pending
+    b.dispose()
+  })
+
   describe('Geometry::getSRID()', function () {
     it('returns 0 when not set', function () {
       const geometry = GEOS.createPoint(26.417, 59.332)
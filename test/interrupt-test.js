@@ -0,0 +1,105 @@
+const GEOS = require('bindings')('geos')
+const assert = require('assert')
+
+const assertError = message => fn => assert.throws(fn, { message, name: "Error" })
+const assertTypeError = message => fn => assert.throws(fn, { message, name: "TypeError" })
+
+const timeout = { code: 'GEOS_TIMEOUT', message: 'Operation timed out' }
+const abort = { name: 'AbortError', code: 'ABORT_ERR', message: 'Operation aborted' }
+
+// Per-context interrupt callbacks require GEOS 3.12:
+const [major, minor] = GEOS.GEOS_VERSION.split('.').map(Number)
+const supported = major > 3 || (major === 3 && minor >= 12)
+
+describe('Interrupts', function () {
+  before(function () {
+    if (!supported) this.skip()
+  })
+
+  // Heavily self-intersecting line; buffering takes (many) seconds:
+  const coords = new Float64Array(40000)
+  for (let i = 0; i < coords.length; i += 2) {
+    coords[i] = (i * 7919) % 1000
+    coords[i + 1] = (i * 104729) % 997
+  }
+
+  const slow = GEOS.createLineString(coords)
+  const polygon = GEOS.readWKT('POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0))')
+  const aborted = () => {
+    const controller = new AbortController()
+    controller.abort()
+    return controller.signal
+  }
+
+  it('::buffer() - timeout', function () {
+    assert.throws(() => slow.buffer(1, { timeout: 0 }), timeout)
+    assert.throws(() => polygon.buffer(1, 8, { timeout: 0 }), timeout)
+    assert(polygon.buffer(1, { timeout: 1000 }).contains(polygon))
+  })
+
+  it('::asValid() - signal', function () {
+    assert.throws(() => polygon.asValid({ signal: aborted() }), abort)
+    assert(polygon.asValid({ signal: new AbortController().signal }).equals(polygon))
+  })
+
+  it('::bufferAsync() - timeout', async function () {
+    await assert.rejects(slow.bufferAsync(1, { timeout: 0 }), timeout)
+    assert(slow.isValid())
+  })
+
+  it('::bufferAsync() - abort while running', async function () {
+    const controller = new AbortController()
+    const promise = slow.bufferAsync(1, { signal: controller.signal })
+    setTimeout(() => controller.abort(), 20)
+
+    // Only meaningful if buffering outlasts the delay:
+    const completed = await promise.then(() => true, error => {
+      assert.deepStrictEqual({ name: error.name, code: error.code, message: error.message }, abort)
+      return false
+    })
+
+    if (completed) this.skip()
+  })
+
+  it('async operations - aborted before start', async function () {
+    const signal = aborted()
+    await assert.rejects(polygon.convexHullAsync({ signal }), abort)
+    await assert.rejects(polygon.unionAsync(polygon, { signal }), abort)
+    await assert.rejects(GEOS.unionAll([polygon, polygon], { signal }), abort)
+    await assert.rejects(GEOS.join([polygon], [polygon], { signal }), abort)
+    await assert.rejects(GEOS.pipeline().convexHull().build().applyAsync(polygon, { signal }), abort)
+  })
+
+  it('async operations - complete within timeout', async function () {
+    const controller = new AbortController()
+    const result = await polygon.intersectionAsync(polygon, { timeout: 1000, signal: controller.signal })
+    assert(result.equals(polygon))
+
+    // Late abort has no effect:
+    controller.abort()
+    const { left } = await GEOS.join([polygon], [polygon], { timeout: 1000 })
+    assert.deepStrictEqual(Array.from(left), [0])
+  })
+
+  it('throws on invalid options', function () {
+    assertTypeError('Invalid argument: options')(() => polygon.asValid(42))
+    assertTypeError('Invalid argument: timeout')(() => polygon.buffer(1, { timeout: 'x' }))
+    assertError('Invalid range: timeout')(() => polygon.bufferAsync(1, { timeout: -1 }))
+    assertTypeError('Invalid argument: signal')(() => polygon.convexHullAsync({ signal: {} }))
+    assertTypeError('Invalid argument: signal')(() => GEOS.unionAll([polygon], { signal: 42 }))
+  })
+})
+
+describe('Interrupts - before GEOS 3.12', function () {
+  before(function () {
+    if (supported) this.skip()
+  })
+
+  it('rejects timeout and signal options', function () {
+    const polygon = GEOS.readWKT('POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0))')
+    const message = 'Not supported: timeout, signal (requires GEOS 3.12)'
+    assertError(message)(() => polygon.buffer(1, { timeout: 1000 }))
+    assertError(message)(() => polygon.convexHullAsync({ signal: new AbortController().signal }))
+    assert(polygon.buffer(1, {}).contains(polygon))
+  })
+})
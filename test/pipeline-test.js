@@ -0,0 +1,76 @@
+const GEOS = require('bindings')('geos')
+const assert = require('assert')
+
+const assertError = message => fn => assert.throws(fn, { message, name: "Error" })
+const assertTypeError = message => fn => assert.throws(fn, { message, name: "TypeError" })
+
+describe('Pipeline', function () {
+  const square = GEOS.readWKT('POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0))')
+  const other = GEOS.readWKT('POLYGON ((5 5, 5 15, 15 15, 15 5, 5 5))')
+  const aoi = GEOS.readWKT('POLYGON ((100 100, 100 110, 110 110, 110 100, 100 100))')
+
+  it('::apply() - equals chained Geometry methods', function () {
+    const pipeline = GEOS.pipeline().buffer(1).union(other).convexHull().translate(1, 2).build()
+    const expected = square.buffer(1).union(other).convexHull().translate(1, 2)
+    const geometry = pipeline.apply(square)
+    assert.strictEqual(geometry.getType(), 'Polygon')
+    assert(geometry.equals(expected))
+  })
+
+  it('::apply() - terminal predicate', function () {
+    const pipeline = GEOS.pipeline().buffer(1).intersects(other).build()
+    assert.strictEqual(pipeline.apply(square), true)
+    assert.strictEqual(GEOS.pipeline().buffer(1).intersects(aoi).build().apply(square), false)
+  })
+
+  it('::apply() - array of geometries', function () {
+    const pipeline = GEOS.pipeline().intersection(other).build()
+    const [a, b] = pipeline.apply([square, aoi])
+    assert(a.equals(square.intersection(other)))
+    assert(b.isEmpty())
+  })
+
+  it('::apply() - empty pipeline copies input', function () {
+    const geometry = GEOS.pipeline().build().apply(square)
+    assert(geometry !== square)
+    assert(geometry.equals(square))
+  })
+
+  it('::applyAsync()', async function () {
+    const pipeline = GEOS.pipeline().buffer(1).simplify(0.5).convexHull().build()
+    const expected = pipeline.apply(square)
+    assert((await pipeline.applyAsync(square)).equals(expected))
+
+    const results = await pipeline.applyAsync([square, other])
+    assert.strictEqual(results.length, 2)
+    assert(results[0].equals(expected))
+
+    assert.strictEqual(await GEOS.pipeline().contains(square).build().applyAsync(other), false)
+  })
+
+  it('pins operands and inputs', async function () {
+    const operand = GEOS.readWKT('POINT (0 0)')
+    const input = GEOS.readWKT('POINT (1 1)')
+    const pipeline = GEOS.pipeline().union(operand).build()
+    assertError('Geometry in use')(() => operand.dispose())
+
+    const promise = pipeline.applyAsync(input)
+    assertError('Geometry in use')(() => input.dispose())
+    assert.strictEqual((await promise).getType(), 'MultiPoint')
+  })
+
+  it('throws on misuse and missing/invalid argument', function () {
+    const pipeline = GEOS.pipeline().buffer(1)
+    assertError('Pipeline not built')(() => pipeline.apply(square))
+    assertError('Missing argument: width')(() => GEOS.pipeline().buffer())
+    assertTypeError('Invalid argument: tolerance')(() => GEOS.pipeline().simplify('x'))
+    assertError('Missing argument: geometry')(() => GEOS.pipeline().union())
+    assertError('Invalid argument')(() => GEOS.pipeline().union({}))
+    assertError('Pipeline terminated by predicate')(() => GEOS.pipeline().intersects(aoi).buffer(1))
+
+    pipeline.build()
+    assertError('Pipeline built')(() => pipeline.convexHull())
+    assertError('Missing argument: geometry')(() => pipeline.apply())
+    assertError('Invalid argument')(() => pipeline.apply([square, 'x']))
+  })
+})
@@ -0,0 +1,49 @@
+const GEOS = require('bindings')('geos')
+const assert = require('assert')
+
+const assertError = message => fn => assert.throws(fn, { message, name: "Error" })
+
+describe('PreparedGeometry', function () {
+  const polygon = GEOS.readWKT('POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0))')
+  const inside = GEOS.createPoint(5, 5)
+  const boundary = GEOS.createPoint(0, 5)
+  const outside = GEOS.createPoint(20, 20)
+  const crossing = GEOS.readWKT('LINESTRING (-5 5, 15 5)')
+  const overlapping = GEOS.readWKT('POLYGON ((5 5, 5 15, 15 15, 15 5, 5 5))')
+
+  it('Geometry::prepare()', function () {
+    const prepared = polygon.prepare()
+    assert(prepared)
+    assert.strictEqual(typeof prepared.intersects, 'function')
+  })
+
+  it('agrees with unprepared predicates', function () {
+    const prepared = polygon.prepare()
+    const candidates = [inside, boundary, outside, crossing, overlapping]
+    const predicates = [
+      'intersects', 'contains', 'covers', 'coveredBy', 'within',
+      'touches', 'crosses', 'overlaps', 'disjoint'
+    ]
+
+    predicates.forEach(predicate => candidates.forEach(candidate => {
+      assert.strictEqual(
+        prepared[predicate](candidate),
+        polygon[predicate](candidate),
+        predicate
+      )
+    }))
+  })
+
+  it('::containsProperly()', function () {
+    const prepared = polygon.prepare()
+    assert.strictEqual(prepared.containsProperly(inside), true)
+    assert.strictEqual(prepared.containsProperly(boundary), false)
+    assert.strictEqual(prepared.containsProperly(outside), false)
+  })
+
+  it('throws on missing/invalid argument', function () {
+    const prepared = polygon.prepare()
+    assertError('Missing argument: Geometry')(() => prepared.intersects())
+    assertError('Invalid argument')(() => prepared.intersects('x'))
+  })
+})
@@ -0,0 +1,140 @@
+const GEOS = require('bindings')('geos')
+const assert = require('assert')
+const fs = require('fs')
+const os = require('os')
+const path = require('path')
+const { Readable } = require('stream')
+
+const assertError = message => fn => assert.throws(fn, { message, name: "Error" })
+const assertTypeError = message => fn => assert.throws(fn, { message, name: "TypeError" })
+
+describe('Reader', function () {
+  const wkts = [
+    'POINT (0 0)',
+    'LINESTRING (10 10, 20 20)',
+    'POLYGON ((30 30, 30 40, 40 40, 40 30, 30 30))',
+    'POINT (100 100)',
+    'MULTIPOINT (1 1, 2 2)'
+  ]
+
+  const tmpfile = name => path.join(os.tmpdir(), `geosjs-reader-${process.pid}-${name}`)
+  const wktFile = tmpfile('input.wkt')
+  const wkbFile = tmpfile('input.wkb')
+  const invalidFile = tmpfile('invalid.wkt')
+
+  before(function () {
+    // Includes blank line and CRLF line ending, no final newline:
+    fs.writeFileSync(wktFile, wkts.slice(0, 2).join('\n') + '\n\n' + wkts.slice(2).join('\r\n'))
+    fs.writeFileSync(wkbFile, wkts.map(wkt => GEOS.writeWKB(GEOS.readWKT(wkt)).toString('hex')).join('\n') + '\n')
+    fs.writeFileSync(invalidFile, 'POINT (0 0)\nPOINT (x y)\n')
+  })
+
+  after(function () {
+    ;[wktFile, wkbFile, invalidFile].forEach(file => fs.unlinkSync(file))
+  })
+
+  const readAll = async reader => {
+    const batches = []
+    for await (const batch of reader) batches.push(batch)
+    return batches
+  }
+
+  ;[false, true].forEach(mmap => {
+    it(`GEOS::createReader() - WKT${mmap ? ' (mmap)' : ''}`, async function () {
+      const batches = await readAll(GEOS.createReader(wktFile, { batchSize: 2, mmap }))
+      assert.deepStrictEqual(batches.map(batch => batch.length), [2, 2, 1])
+      const geometries = [].concat(...batches)
+      geometries.forEach((geometry, i) => assert(geometry.equals(GEOS.readWKT(wkts[i]))))
+    })
+  })
+
+  it('GEOS::createReader() - hex WKB', async function () {
+    const batches = await readAll(GEOS.createReader(wkbFile, { format: 'wkb', mmap: true }))
+    assert.strictEqual(batches.length, 1)
+    batches[0].forEach((geometry, i) => assert(geometry.equals(GEOS.readWKT(wkts[i]))))
+  })
+
+  it('GEOS::createReader() - Readable stream', async function () {
+    // Tiny chunks split lines between chunks:
+    const stream = fs.createReadStream(wktFile, { highWaterMark: 7 })
+    const batches = await readAll(GEOS.createReader(stream, { batchSize: 2 }))
+    assert.deepStrictEqual(batches.map(batch => batch.length), [2, 2, 1])
+    const geometries = [].concat(...batches)
+    geometries.forEach((geometry, i) => assert(geometry.equals(GEOS.readWKT(wkts[i]))))
+  })
+
+  it('GEOS::createReader() - string chunks and blank lines', async function () {
+    const stream = Readable.from(['\n\n', '\r\n', 'POINT (1', ' 2)\n', 'POINT (3 4)'])
+    const batches = await readAll(GEOS.createReader(stream, { batchSize: 1 }))
+    assert.deepStrictEqual(batches.map(batch => batch.length), [1, 1])
+    assert(batches[1][0].equals(GEOS.readWKT('POINT (3 4)')))
+  })
+
+  it('GEOS::createReader() - pulls stream on demand', async function () {
+    let pulled = 0
+    const chunks = function * () { for (let i = 0; i < 100; i++) { pulled++; yield `POINT (${i} ${i})\n` } }
+    const reader = GEOS.createReader(Readable.from(chunks(), { highWaterMark: 1 }), { batchSize: 10 })
+    assert.strictEqual((await reader.next()).value.length, 10)
+    assert(pulled < 100)
+    await reader.return()
+  })
+
+  it('::next() - rejects on stream error', async function () {
+    const stream = new Readable({ read () { this.destroy(new Error('boom')) } })
+    const reader = GEOS.createReader(stream)
+    await assert.rejects(reader.next(), /^Error: boom/)
+    assert.deepStrictEqual(await reader.next(), { value: undefined, done: true })
+  })
+
+  it('::return() - destroys stream', async function () {
+    const stream = fs.createReadStream(wktFile)
+    const reader = GEOS.createReader(stream, { batchSize: 1 })
+    const closed = new Promise(resolve => stream.once('close', resolve))
+    for await (const batch of reader) { assert(batch); break }
+    await closed
+    assert(stream.destroyed)
+  })
+
+  it('::next() - done', async function () {
+    const reader = GEOS.createReader(wktFile, { batchSize: 100 })
+    assert.strictEqual((await reader.next()).value.length, 5)
+    assert.deepStrictEqual(await reader.next(), { value: undefined, done: true })
+    assert.deepStrictEqual(await reader.next(), { value: undefined, done: true })
+  })
+
+  it('::next() - busy', async function () {
+    const reader = GEOS.createReader(wktFile)
+    const pending = reader.next()
+    assertError('Reader busy')(() => reader.next())
+    await pending
+    reader.close()
+  })
+
+  it('::next() - rejects on parse error', async function () {
+    const reader = GEOS.createReader(invalidFile)
+    await assert.rejects(reader.next(), /^Error: Parse error at line 2/)
+  })
+
+  it('::return() - on break', async function () {
+    const reader = GEOS.createReader(wktFile, { batchSize: 1 })
+    for await (const batch of reader) { assert(batch); break }
+    assert.deepStrictEqual(await reader.next(), { value: undefined, done: true })
+  })
+
+  it('::return() - while batch is pending', async function () {
+    const reader = GEOS.createReader(wktFile, { batchSize: 1 })
+    const pending = reader.next()
+    await reader.return()
+    assert.deepStrictEqual(await pending, { value: undefined, done: true })
+    assert.deepStrictEqual(await reader.next(), { value: undefined, done: true })
+  })
+
+  it('GEOS::createReader() - throws on missing/invalid argument', function () {
+    assertError('Missing argument: path')(() => GEOS.createReader())
+    assertTypeError('Invalid argument: path')(() => GEOS.createReader(42))
+    assertTypeError('Invalid argument: options')(() => GEOS.createReader(wktFile, 42))
+    assertTypeError('Invalid argument: format')(() => GEOS.createReader(wktFile, { format: 'csv' }))
+    assertError('Invalid range: batchSize')(() => GEOS.createReader(wktFile, { batchSize: 0 }))
+    assertError(`Cannot open file: ${tmpfile('missing')}`)(() => GEOS.createReader(tmpfile('missing')))
+  })
+})
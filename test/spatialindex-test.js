@@ -0,0 +1,109 @@
+const GEOS = require('bindings')('geos')
+const assert = require('assert')
+
+const assertError = message => fn => assert.throws(fn, { message, name: "Error" })
+const assertTypeError = message => fn => assert.throws(fn, { message, name: "TypeError" })
+
+describe('SpatialIndex', function () {
+  const geometries = [
+    'POINT (0 0)',
+    'LINESTRING (10 10, 20 20)',
+    'POLYGON ((30 30, 30 40, 40 40, 40 30, 30 30))',
+    'POINT (100 100)'
+  ].map(GEOS.readWKT)
+
+  const envelopes = new Float64Array([
+    0, 0, 0, 0,
+    10, 10, 20, 20,
+    30, 30, 40, 40,
+    100, 100, 100, 100
+  ])
+
+  it('GEOS::createSpatialIndex() - [Geometry]', function () {
+    const index = GEOS.createSpatialIndex(geometries)
+    assert.strictEqual(index.getNumItems(), 4)
+  })
+
+  it('GEOS::createSpatialIndex() - Float64Array', function () {
+    const index = GEOS.createSpatialIndex(envelopes, 4)
+    assert.strictEqual(index.getNumItems(), 4)
+  })
+
+  it('GEOS::createSpatialIndex() - throws on missing/invalid argument', function () {
+    assertError('Missing argument: [Geometry] | Float64Array')(() => GEOS.createSpatialIndex())
+    assertTypeError('Invalid argument: [Geometry] | Float64Array')(() => GEOS.createSpatialIndex(42))
+    assertTypeError('Invalid argument: Float64Array')(() => GEOS.createSpatialIndex(new Float64Array(3)))
+    assertError('Invalid argument')(() => GEOS.createSpatialIndex(['x']))
+    assertError('Invalid range: nodeCapacity')(() => GEOS.createSpatialIndex(geometries, 1))
+  })
+
+  it('::query() - envelope', function () {
+    ;[GEOS.createSpatialIndex(geometries), GEOS.createSpatialIndex(envelopes)].forEach(index => {
+      const hits = index.query(new Float64Array([5, 5, 35, 35]))
+      assert(hits instanceof Uint32Array)
+      assert.deepStrictEqual(Array.from(hits), [1, 2])
+      assert.strictEqual(index.query(new Float64Array([50, 50, 60, 60])).length, 0)
+    })
+  })
+
+  it('::query() - Geometry', function () {
+    const index = GEOS.createSpatialIndex(geometries)
+    const hits = index.query(GEOS.createPoint(0, 0).buffer(200))
+    assert.deepStrictEqual(Array.from(hits), [0, 1, 2, 3])
+  })
+
+  it('::query() - throws on missing/invalid argument', function () {
+    const index = GEOS.createSpatialIndex(geometries)
+    assertError('Missing argument: Geometry | envelope')(() => index.query())
+    assertTypeError('Invalid argument: envelope')(() => index.query(new Float64Array(2)))
+    assertError('Invalid argument')(() => index.query({}))
+  })
+
+  it('::nearest()', function () {
+    ;[GEOS.createSpatialIndex(geometries), GEOS.createSpatialIndex(envelopes)].forEach(index => {
+      const nearest = index.nearest(GEOS.createPoint(9, 9))
+      assert(nearest instanceof Uint32Array)
+      assert.deepStrictEqual(Array.from(nearest), [1])
+      assert.deepStrictEqual(Array.from(index.nearest(GEOS.createPoint(9, 9), 3)), [1, 0, 2])
+      assert.deepStrictEqual(Array.from(index.nearest(GEOS.createPoint(90, 90), 10)), [3, 2, 1, 0])
+      assert.strictEqual(index.nearest(GEOS.readWKT('POINT EMPTY')).length, 0)
+    })
+  })
+
+  it('::nearest() - agrees with brute force', function () {
+    const points = Array.from({ length: 500 }, (_, i) => GEOS.createPoint((i * 37) % 101, (i * 53) % 97))
+    const index = GEOS.createSpatialIndex(points)
+    const queries = [GEOS.createPoint(50, 50), GEOS.createPoint(-10, 20), GEOS.readWKT('LINESTRING (0 0, 100 100)')]
+
+    queries.forEach(query => {
+      const distances = query.distanceMany(points)
+      const nearest = index.nearest(query, 5)
+      const expected = Array.from(distances).sort((a, b) => a - b).slice(0, 5)
+      assert.deepStrictEqual(Array.from(nearest).map(i => distances[i]), expected)
+    })
+  })
+
+  it('::nearest() - all items, empty items skipped', function () {
+    const points = Array.from({ length: 50 }, (_, i) => GEOS.createPoint((i * 7) % 11, (i * 5) % 13))
+    const index = GEOS.createSpatialIndex([...points, GEOS.readWKT('POINT EMPTY')], 2)
+    const query = GEOS.createPoint(3, 4)
+    const distances = query.distanceMany(points)
+    const nearest = index.nearest(query, 100)
+    const expected = Array.from(distances).sort((a, b) => a - b)
+    assert.deepStrictEqual(Array.from(nearest).map(i => distances[i]), expected)
+  })
+
+  it('::nearest() - batch', function () {
+    const index = GEOS.createSpatialIndex(geometries)
+    const nearest = index.nearest([GEOS.createPoint(9, 9), GEOS.readWKT('POINT EMPTY'), GEOS.createPoint(99, 99)], 2)
+    assert.deepStrictEqual(Array.from(nearest), [1, 0, 0xFFFFFFFF, 0xFFFFFFFF, 3, 2])
+  })
+
+  it('::nearest() - throws on missing/invalid argument', function () {
+    const index = GEOS.createSpatialIndex(geometries)
+    assertError('Missing argument: Geometry | [Geometry]')(() => index.nearest())
+    assertTypeError('Invalid argument: k')(() => index.nearest(geometries[0], 'x'))
+    assertError('Invalid range: k')(() => index.nearest(geometries[0], 0))
+    assertError('Invalid argument')(() => index.nearest({}))
+  })
+})
@@ -0,0 +1,61 @@
+const GEOS = require('bindings')('geos')
+const assert = require('assert')
+
+describe('Statistics', function () {
+  afterEach(function () {
+    GEOS.enableStats(false)
+    GEOS.resetStats()
+  })
+
+  it('GEOS::stats() - disabled by default', function () {
+    GEOS.resetStats()
+    GEOS.createPoint(0, 0).buffer(10)
+    const stats = GEOS.stats()
+    assert.strictEqual(stats.enabled, false)
+    assert.deepStrictEqual(stats.operations, {})
+  })
+
+  it('GEOS::stats() - geometries are always counted', function () {
+    const before = GEOS.stats().geometries
+    const point = GEOS.createPoint(0, 0)
+    GEOS.enableStats()
+    const buffer = point.buffer(10)
+    point.dispose()
+    GEOS.enableStats(false)
+    buffer.dispose()
+
+    const after = GEOS.stats().geometries
+    assert.strictEqual(after.created - before.created, 2)
+    assert(after.destroyed - before.destroyed >= 2) // may include garbage collected geometries
+    GEOS.resetStats()
+    assert.strictEqual(GEOS.stats().geometries.created, after.created)
+  })
+
+  it('GEOS::enableStats() - records calls, time and vertices', function () {
+    GEOS.enableStats()
+    const polygon = GEOS.readWKT('POLYGON ((0 0, 0 10, 10 10, 10 0, 0 0))')
+    polygon.isValid()
+    polygon.isValid()
+    polygon.buffer(1).dispose()
+
+    const { enabled, operations } = GEOS.stats()
+    assert.strictEqual(enabled, true)
+    assert.strictEqual(operations['GEOS::readWKT'].count, 1)
+    assert.strictEqual(operations['Geometry::isValid'].count, 2)
+    assert.strictEqual(operations['Geometry::isValid'].vertices, 10)
+    assert(operations['Geometry::buffer'].totalTime >= operations['Geometry::buffer'].maxTime)
+  })
+
+  it('GEOS::enableStats() - records async operations', async function () {
+    GEOS.enableStats()
+    await GEOS.createPoint(0, 0).bufferAsync(10)
+    assert.strictEqual(GEOS.stats().operations['Geometry::bufferAsync'].count, 1)
+  })
+
+  it('GEOS::resetStats()', function () {
+    GEOS.enableStats()
+    GEOS.createPoint(0, 0)
+    GEOS.resetStats()
+    assert.deepStrictEqual(GEOS.stats().operations, {})
+  })
+})
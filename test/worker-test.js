@@ -0,0 +1,43 @@
+const GEOS = require('bindings')('geos')
+const assert = require('assert')
+const path = require('path')
+const { Worker } = require('worker_threads')
+
+// Buffers shared geometry and shares result:
+const source = `
+  const { parentPort, workerData } = require('worker_threads')
+  const GEOS = require('bindings')({ bindings: 'geos', module_root: workerData.root })
+  parentPort.on('message', buffer => {
+    const geometry = GEOS.fromShared(buffer)
+    parentPort.postMessage(GEOS.scope(() => geometry.buffer(1).toShared()))
+  })
+`
+
+const spawn = () => new Worker(source, { eval: true, workerData: { root: path.join(__dirname, '..') } })
+const request = (worker, buffer) => new Promise((resolve, reject) => {
+  worker.once('message', resolve)
+  worker.once('error', reject)
+  worker.postMessage(buffer)
+})
+
+describe('worker_threads', function () {
+  this.timeout(10000)
+
+  it('loads in multiple workers; exchanges geometries through SharedArrayBuffer', async function () {
+    const workers = [spawn(), spawn(), spawn()]
+    const polygons = workers.map((_, i) => GEOS.readWKT(`POLYGON ((${i} 0, ${i} 1, ${i + 1} 1, ${i + 1} 0, ${i} 0))`))
+
+    try {
+      const results = await Promise.all(workers.map((worker, i) => request(worker, polygons[i].toShared())))
+      results.forEach((buffer, i) => {
+        const result = GEOS.fromShared(buffer)
+        assert(result.equals(polygons[i].buffer(1)))
+      })
+    } finally {
+      await Promise.all(workers.map(worker => worker.terminate()))
+    }
+
+    // Module still usable after workers are gone:
+    assert.strictEqual(GEOS.createPoint(1, 2).getType(), 'Point')
+  })
+})